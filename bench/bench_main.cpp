@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "framework/bench_harness.h"
+#include "utilities/egl_compatibility.h"
+
+static void print_usage(const char * program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --output-dir=DIR       Directory for results.json and results.csv (default: build/bench)\n"
+              << "  --filter=TEXT          Only run benchmarks whose suite/name contains TEXT (e.g. stage/AudioEcho)\n"
+              << "  --buffer-sizes=A,B,... Buffer sizes in frames (default: 64 to 4096)\n"
+              << "  --quick                Fewer iterations, for smoke runs\n";
+}
+
+static bool parse_buffer_sizes(const std::string& list, std::vector<unsigned int>& buffer_sizes) {
+    buffer_sizes.clear();
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const unsigned long size = std::strtoul(item.c_str(), nullptr, 10);
+        if (size == 0) {
+            return false;
+        }
+        buffer_sizes.push_back(static_cast<unsigned int>(size));
+    }
+    return !buffer_sizes.empty();
+}
+
+int main(int argc, char ** argv) {
+    BenchConfig config;
+    std::string output_dir = "build/bench";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--output-dir=", 0) == 0) {
+            output_dir = arg.substr(13);
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            config.filter = arg.substr(9);
+        } else if (arg.rfind("--buffer-sizes=", 0) == 0) {
+            if (!parse_buffer_sizes(arg.substr(15), config.buffer_sizes)) {
+                std::cerr << "Error: Invalid buffer sizes " << arg.substr(15) << std::endl;
+                return 1;
+            }
+        } else if (arg == "--quick") {
+            config.warmup_iterations = 4;
+            config.measured_iterations = 32;
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    BenchReport report;
+    run_render_stage_benchmarks(report, config);
+    run_render_graph_benchmarks(report, config);
+    run_cpu_structure_benchmarks(report, config);
+    EGLCompatibility::global_cleanup();
+
+    std::filesystem::create_directories(output_dir);
+    const bool written = report.write_json(output_dir + "/results.json") && report.write_csv(output_dir + "/results.csv");
+    std::cout << report.results().size() << " results on " << report.renderer() << " written to " << output_dir << std::endl;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "framework/bench_harness.h"
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "audio_core/audio_tape.h"
+#include "utilities/audio_ring_buffer.h"
+
+static BenchResult cpu_result(const BenchConfig& config, const std::string& name, const unsigned int buffer_size,
+                              std::vector<double>& samples_us) {
+    BenchResult result;
+    result.suite = "cpu";
+    result.name = name;
+    result.buffer_size = buffer_size;
+    result.num_channels = config.num_channels;
+    result.iterations = samples_us.size();
+    const double total_us = std::accumulate(samples_us.begin(), samples_us.end(), 0.0);
+    result.iterations_per_second = total_us > 0.0 ? result.iterations * 1e6 / total_us : 0.0;
+    result.latency = summarize_latency(samples_us);
+    return result;
+}
+
+// One block through the ring between the render and output threads
+static void bench_ring_buffer(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    const unsigned int block_size = buffer_size * config.num_channels;
+    AudioRingBuffer ring(8, block_size);
+    std::vector<float> block(block_size, 0.25f);
+    std::vector<float> output(block_size);
+
+    auto samples_us = time_iterations(config.warmup_iterations, config.measured_iterations, [&]() {
+        ring.push(block.data());
+        ring.pop(output.data());
+    });
+    report.add(cpu_result(config, "AudioRingBuffer::push_pop", buffer_size, samples_us));
+}
+
+static void bench_tape(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    const unsigned int total_iterations = config.warmup_iterations + config.measured_iterations;
+    std::vector<float> block(buffer_size * config.num_channels, 0.25f);
+
+    // Recording appends a block per iteration, like a record stage
+    AudioTape tape(buffer_size, config.sample_rate, config.num_channels);
+    unsigned int position = 0;
+    auto record_us = time_iterations(config.warmup_iterations, config.measured_iterations, [&]() {
+        tape.record(block.data(), position);
+        position += buffer_size;
+    });
+    report.add(cpu_result(config, "AudioTape::record", buffer_size, record_us));
+
+    // Playback reads the recorded blocks back in order, like a playback stage
+    position = 0;
+    auto playback_us = time_iterations(config.warmup_iterations, config.measured_iterations, [&]() {
+        auto samples = tape.playback(buffer_size, position % (total_iterations * buffer_size));
+        position += buffer_size;
+    });
+    report.add(cpu_result(config, "AudioTape::playback", buffer_size, playback_us));
+}
+
+void run_cpu_structure_benchmarks(BenchReport& report, const BenchConfig& config) {
+    for (const unsigned int buffer_size : config.buffer_sizes) {
+        if (bench_selected(config, "cpu", "AudioRingBuffer")) {
+            bench_ring_buffer(report, config, buffer_size);
+        }
+        if (bench_selected(config, "cpu", "AudioTape")) {
+            bench_tape(report, config, buffer_size);
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#include "bench_harness.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <GLES3/gl3.h>
+
+#include "audio_core/audio_offline_renderer.h"
+#include "audio_core/audio_render_graph.h"
+#include "utilities/audio_stage_timer.h"
+
+void BenchReport::add(const BenchResult& result) {
+    m_results.push_back(result);
+
+    std::cout << std::left << std::setw(10) << result.suite << " "
+              << std::setw(36) << (result.name + (result.params.empty() ? "" : " [" + result.params + "]")) << " "
+              << std::right << std::setw(5) << result.buffer_size << " frames  "
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.iterations_per_second << " it/s  "
+              << "mean " << std::setw(8) << result.latency.mean << " us  "
+              << "p99 " << std::setw(8) << result.latency.p99 << " us";
+    if (result.realtime_factor > 0.0) {
+        std::cout << "  x" << std::setprecision(2) << result.realtime_factor << " realtime";
+    }
+    if (result.snr_db != 0.0) {
+        std::cout << "  snr " << std::setprecision(1) << result.snr_db << " dB";
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+static std::string json_escape(const std::string& value) {
+    std::string escaped;
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool BenchReport::write_json(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Failed to write " << path << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(6) << "{\n  \"renderer\": \"" << json_escape(m_renderer) << "\",\n  \"results\": [";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const auto & result = m_results[i];
+        file << (i == 0 ? "\n" : ",\n")
+             << "    {\"suite\": \"" << json_escape(result.suite) << "\""
+             << ", \"name\": \"" << json_escape(result.name) << "\""
+             << ", \"params\": \"" << json_escape(result.params) << "\""
+             << ", \"buffer_size\": " << result.buffer_size
+             << ", \"num_channels\": " << result.num_channels
+             << ", \"iterations\": " << result.iterations
+             << ", \"iterations_per_second\": " << result.iterations_per_second
+             << ", \"realtime_factor\": " << result.realtime_factor
+             << ", \"latency_us\": {\"mean\": " << result.latency.mean
+             << ", \"p50\": " << result.latency.p50
+             << ", \"p99\": " << result.latency.p99
+             << ", \"max\": " << result.latency.max << "}"
+             << ", \"stage_cpu_mean_us\": " << result.stage_cpu_mean_us
+             << ", \"stage_cpu_p99_us\": " << result.stage_cpu_p99_us
+             << ", \"stage_gpu_mean_us\": " << result.stage_gpu_mean_us
+             << ", \"snr_db\": " << result.snr_db << "}";
+    }
+    file << "\n  ]\n}\n";
+    return true;
+}
+
+bool BenchReport::write_csv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Failed to write " << path << std::endl;
+        return false;
+    }
+
+    file << "suite,name,params,buffer_size,num_channels,iterations,iterations_per_second,realtime_factor,"
+            "latency_mean_us,latency_p50_us,latency_p99_us,latency_max_us,"
+            "stage_cpu_mean_us,stage_cpu_p99_us,stage_gpu_mean_us,snr_db\n";
+    file << std::setprecision(6);
+    for (const auto & result : m_results) {
+        file << result.suite << "," << result.name << "," << result.params << ","
+             << result.buffer_size << "," << result.num_channels << "," << result.iterations << ","
+             << result.iterations_per_second << "," << result.realtime_factor << ","
+             << result.latency.mean << "," << result.latency.p50 << "," << result.latency.p99 << "," << result.latency.max << ","
+             << result.stage_cpu_mean_us << "," << result.stage_cpu_p99_us << "," << result.stage_gpu_mean_us << "," << result.snr_db << "\n";
+    }
+    return true;
+}
+
+LatencyStats summarize_latency(std::vector<double>& samples_us) {
+    LatencyStats stats;
+    if (samples_us.empty()) {
+        return stats;
+    }
+
+    std::sort(samples_us.begin(), samples_us.end());
+    stats.mean = std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / samples_us.size();
+    stats.p50 = samples_us[samples_us.size() / 2];
+    stats.p99 = samples_us[std::min(samples_us.size() - 1, (samples_us.size() * 99) / 100)];
+    stats.max = samples_us.back();
+    return stats;
+}
+
+std::vector<double> time_iterations(unsigned int warmup, unsigned int iterations, const std::function<void()>& body) {
+    for (unsigned int i = 0; i < warmup; ++i) {
+        body();
+    }
+
+    std::vector<double> samples_us;
+    samples_us.reserve(iterations);
+    for (unsigned int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+        samples_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return samples_us;
+}
+
+bool bench_selected(const BenchConfig& config, const std::string& suite, const std::string& name) {
+    return config.filter.empty() || (suite + "/" + name).find(config.filter) != std::string::npos;
+}
+
+bool bench_render_graph(BenchReport& report, const BenchConfig& config, BenchResult result,
+                        AudioRenderGraph * graph, unsigned int stage_gid,
+                        const std::function<void()>& on_initialized) {
+    AudioOfflineRenderer renderer(graph, result.buffer_size, config.sample_rate, result.num_channels);
+    if (!renderer.initialize()) {
+        std::cerr << "Error: Failed to initialize " << result.name << std::endl;
+        return false;
+    }
+    if (report.renderer().empty()) {
+        report.set_renderer(current_gl_renderer());
+    }
+    if (on_initialized) {
+        on_initialized();
+    }
+
+    bool rendered = true;
+    auto samples_us = time_iterations(config.warmup_iterations, config.measured_iterations, [&]() {
+        rendered = renderer.render_blocks(1) && rendered;
+    });
+    if (!rendered) {
+        std::cerr << "Error: Failed to render " << result.name << std::endl;
+        return false;
+    }
+
+    result.iterations = config.measured_iterations;
+    result.latency = summarize_latency(samples_us);
+    const double total_us = std::accumulate(samples_us.begin(), samples_us.end(), 0.0);
+    result.iterations_per_second = total_us > 0.0 ? result.iterations * 1e6 / total_us : 0.0;
+    result.realtime_factor = result.iterations_per_second * result.buffer_size / config.sample_rate;
+
+#if AUDIO_STAGE_TIMING
+    if (stage_gid != 0) {
+        const auto timings = renderer.get_render_graph()->get_stage_timings();
+        if (auto it = timings.find(stage_gid); it != timings.end()) {
+            result.stage_cpu_mean_us = it->second.cpu_total.mean;
+            result.stage_cpu_p99_us = it->second.cpu_total.p99;
+            result.stage_gpu_mean_us = it->second[AudioStageTimer::Phase::GPU].mean;
+        }
+    }
+#endif
+
+    report.add(result);
+    return true;
+}
+
+std::string current_gl_renderer() {
+    const char * renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+    return renderer ? renderer : "unknown";
+}
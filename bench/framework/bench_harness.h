@@ -0,0 +1,113 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+class AudioRenderGraph;
+
+/**
+ * @brief Settings shared by every benchmark of a run
+ */
+struct BenchConfig {
+    std::vector<unsigned int> buffer_sizes = {64, 128, 256, 512, 1024, 2048, 4096};
+    unsigned int num_channels = 2;
+    unsigned int sample_rate = 44100;
+    unsigned int warmup_iterations = 32;
+    unsigned int measured_iterations = 256;
+    std::string filter; // Only benchmarks whose suite/name contains this run
+};
+
+/**
+ * @brief Distribution of per-iteration times, in microseconds
+ */
+struct LatencyStats {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief One measured configuration
+ */
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::string params;
+    unsigned int buffer_size = 0;
+    unsigned int num_channels = 0;
+    unsigned int iterations = 0;
+    double iterations_per_second = 0.0;
+    double realtime_factor = 0.0;   // Audio seconds per wall-clock second, 0 for non audio benchmarks
+    LatencyStats latency;
+    double stage_cpu_mean_us = 0.0; // Own CPU time of the stage under test, from its stage timer
+    double stage_cpu_p99_us = 0.0;
+    double stage_gpu_mean_us = 0.0; // 0 without GL_EXT_disjoint_timer_query
+    double snr_db = 0.0;            // Against a full precision render of the same graph, 0 when not measured
+};
+
+/**
+ * @brief Collects the results of a run and writes them as JSON and CSV
+ */
+class BenchReport {
+public:
+    void add(const BenchResult& result);
+
+    const std::vector<BenchResult>& results() const { return m_results; }
+
+    const std::string& renderer() const { return m_renderer; }
+    void set_renderer(const std::string& renderer) { m_renderer = renderer; }
+
+    bool write_json(const std::string& path) const;
+    bool write_csv(const std::string& path) const;
+
+private:
+    std::vector<BenchResult> m_results;
+    std::string m_renderer;
+};
+
+/**
+ * @brief Summarizes per-iteration times
+ * @param samples_us Times in microseconds, sorted in place
+ */
+LatencyStats summarize_latency(std::vector<double>& samples_us);
+
+/**
+ * @brief Times a function after a warmup
+ * @return The time of every measured call, in microseconds
+ */
+std::vector<double> time_iterations(unsigned int warmup, unsigned int iterations, const std::function<void()>& body);
+
+/**
+ * @brief Whether a benchmark passes the --filter of the run
+ */
+bool bench_selected(const BenchConfig& config, const std::string& suite, const std::string& name);
+
+/**
+ * @brief Renders a graph headless, one block per iteration, and records a result
+ *
+ * The graph is owned by an offline renderer for the duration of the benchmark. The readback is
+ * synchronous, so each iteration includes the GPU work of the block.
+ *
+ * @param stage_gid Stage whose own timings are reported, 0 for none
+ * @param on_initialized Called once the graph is initialized, e.g. to start notes
+ * @return False if the graph failed to initialize or render
+ */
+bool bench_render_graph(BenchReport& report, const BenchConfig& config, BenchResult result,
+                        AudioRenderGraph * graph, unsigned int stage_gid,
+                        const std::function<void()>& on_initialized = nullptr);
+
+/**
+ * @brief The GL_RENDERER of the current context, to tell llvmpipe runs from hardware runs
+ */
+std::string current_gl_renderer();
+
+// Benchmark suites, one per bench/*_bench.cpp
+void run_render_stage_benchmarks(BenchReport& report, const BenchConfig& config);
+void run_render_graph_benchmarks(BenchReport& report, const BenchConfig& config);
+void run_cpu_structure_benchmarks(BenchReport& report, const BenchConfig& config);
+
+#endif // BENCH_HARNESS_H
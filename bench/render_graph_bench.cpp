@@ -0,0 +1,147 @@
+#include "framework/bench_harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "audio_core/audio_offline_renderer.h"
+#include "audio_core/audio_render_graph.h"
+#include "audio_render_stage/audio_generator_render_stage.h"
+#include "audio_render_stage/audio_effect_render_stage.h"
+#include "audio_render_stage/audio_multitrack_join_render_stage.h"
+#include "audio_render_stage/audio_final_render_stage.h"
+
+static constexpr unsigned int MAX_TRACKS = 9;
+static constexpr unsigned int NOTES_PER_TRACK = 4;
+
+// The precision benchmark compares this many blocks of a graph with this many tracks
+static constexpr unsigned int PRECISION_TRACKS = 4;
+static constexpr unsigned int PRECISION_BLOCKS = 256;
+static constexpr double MAX_SNR_DB = 200.0;
+
+// A synthesizer-like graph: one generator and echo per track, joined into the final stage
+static AudioFinalRenderStage * build_tracks(const BenchConfig& config, const unsigned int buffer_size, const unsigned int num_tracks,
+                                            std::vector<AudioGeneratorRenderStage *>& generators) {
+    auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+    auto * join = new AudioMultitrackJoinRenderStage(buffer_size, config.sample_rate, config.num_channels, num_tracks);
+    join->connect_render_stage(final_stage);
+
+    for (unsigned int track = 0; track < num_tracks; ++track) {
+        auto * generator = new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels,
+                                                         "build/shaders/multinote_sine_generator_render_stage.glsl");
+        auto * echo = new AudioEchoEffectRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        echo->set_gpu_history_enabled(true);
+        generator->connect_render_stage(echo);
+        echo->connect_render_stage(join);
+        generators.push_back(generator);
+    }
+    return final_stage;
+}
+
+static void play_tracks(const std::vector<AudioGeneratorRenderStage *>& generators) {
+    for (unsigned int track = 0; track < generators.size(); ++track) {
+        for (unsigned int note = 0; note < NOTES_PER_TRACK; ++note) {
+            generators[track]->play_note({110.0f * (track + 1) + 20.0f * note, 0.1f});
+        }
+    }
+}
+
+static void bench_tracks(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size, const unsigned int num_tracks) {
+    std::vector<AudioGeneratorRenderStage *> generators;
+    auto * final_stage = build_tracks(config, buffer_size, num_tracks, generators);
+
+    BenchResult result;
+    result.suite = "graph";
+    result.name = "tracks";
+    result.params = "tracks=" + std::to_string(num_tracks);
+    result.buffer_size = buffer_size;
+    result.num_channels = config.num_channels;
+
+    bench_render_graph(report, config, result, new AudioRenderGraph(final_stage), 0, [generators]() {
+        play_tracks(generators);
+    });
+}
+
+// Renders the tracks graph for PRECISION_BLOCKS blocks and returns the interleaved output
+static std::vector<float> render_tracks(const BenchConfig& config, const unsigned int buffer_size, const bool half_float_streams) {
+    std::vector<AudioGeneratorRenderStage *> generators;
+    auto * final_stage = build_tracks(config, buffer_size, PRECISION_TRACKS, generators);
+    auto * graph = new AudioRenderGraph(final_stage);
+    graph->set_half_float_streams(half_float_streams);
+
+    std::vector<float> output;
+    AudioOfflineRenderer renderer(graph, buffer_size, config.sample_rate, config.num_channels);
+    if (!renderer.initialize()) {
+        std::cerr << "Error: Failed to initialize the precision render" << std::endl;
+        return output;
+    }
+    play_tracks(generators);
+    for (unsigned int block = 0; block < PRECISION_BLOCKS; ++block) {
+        if (!renderer.render_blocks(1)) {
+            std::cerr << "Error: Failed to render the precision render" << std::endl;
+            return {};
+        }
+        const auto & block_data = final_stage->get_output_buffer_data();
+        output.insert(output.end(), block_data.begin(), block_data.end());
+    }
+    return output;
+}
+
+// Signal to noise ratio of a render against the reference render, MAX_SNR_DB if they are identical
+static double snr_db(const std::vector<float>& reference, const std::vector<float>& signal) {
+    double signal_power = 0.0;
+    double noise_power = 0.0;
+    for (size_t i = 0; i < std::min(reference.size(), signal.size()); ++i) {
+        const double noise = double(signal[i]) - double(reference[i]);
+        signal_power += double(reference[i]) * double(reference[i]);
+        noise_power += noise * noise;
+    }
+    if (noise_power == 0.0) {
+        return MAX_SNR_DB;
+    }
+    return 10.0 * std::log10(signal_power / noise_power);
+}
+
+// The tracks graph with full and half precision streams between its stages, and what the
+// half precision streams cost in quality
+static void bench_precision(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    const auto reference = render_tracks(config, buffer_size, false);
+    const auto half_float = render_tracks(config, buffer_size, true);
+    if (reference.empty() || half_float.empty()) {
+        return;
+    }
+
+    for (const bool half_float_streams : {false, true}) {
+        std::vector<AudioGeneratorRenderStage *> generators;
+        auto * final_stage = build_tracks(config, buffer_size, PRECISION_TRACKS, generators);
+        auto * graph = new AudioRenderGraph(final_stage);
+        graph->set_half_float_streams(half_float_streams);
+
+        BenchResult result;
+        result.suite = "graph";
+        result.name = "precision";
+        result.params = std::string("streams=") + (half_float_streams ? "16f" : "32f") + ",tracks=" + std::to_string(PRECISION_TRACKS);
+        result.buffer_size = buffer_size;
+        result.num_channels = config.num_channels;
+        result.snr_db = half_float_streams ? snr_db(reference, half_float) : 0.0; // The reference itself
+
+        bench_render_graph(report, config, result, graph, 0, [generators]() {
+            play_tracks(generators);
+        });
+    }
+}
+
+void run_render_graph_benchmarks(BenchReport& report, const BenchConfig& config) {
+    for (const unsigned int buffer_size : config.buffer_sizes) {
+        if (bench_selected(config, "graph", "tracks")) {
+            for (unsigned int num_tracks = 1; num_tracks <= MAX_TRACKS; ++num_tracks) {
+                bench_tracks(report, config, buffer_size, num_tracks);
+            }
+        }
+        if (bench_selected(config, "graph", "precision")) {
+            bench_precision(report, config, buffer_size);
+        }
+    }
+}
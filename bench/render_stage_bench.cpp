@@ -0,0 +1,145 @@
+#include "framework/bench_harness.h"
+
+#include <iostream>
+#include <string>
+
+#include "audio_core/audio_render_graph.h"
+#include "audio_render_stage/audio_generator_render_stage.h"
+#include "audio_render_stage/audio_effect_render_stage.h"
+#include "audio_render_stage/audio_multitrack_join_render_stage.h"
+#include "audio_render_stage/audio_final_render_stage.h"
+
+static const std::string SINE_SHADER = "build/shaders/multinote_sine_generator_render_stage.glsl";
+
+// Notes spread over two octaves, so every voice of the generator does real work
+static void play_notes(AudioGeneratorRenderStage * generator, const unsigned int num_notes) {
+    for (unsigned int note = 0; note < num_notes; ++note) {
+        generator->play_note({220.0f * (1.0f + note / 12.0f), 0.5f / num_notes});
+    }
+}
+
+static BenchResult stage_result(const BenchConfig& config, const std::string& name, const std::string& params,
+                                const unsigned int buffer_size) {
+    BenchResult result;
+    result.suite = "stage";
+    result.name = name;
+    result.params = params;
+    result.buffer_size = buffer_size;
+    result.num_channels = config.num_channels;
+    return result;
+}
+
+static void bench_generator(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    for (const unsigned int num_notes : {1u, 8u, 24u}) {
+        auto * generator = new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels, SINE_SHADER);
+        auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        generator->connect_render_stage(final_stage);
+
+        bench_render_graph(report, config,
+                           stage_result(config, "AudioGeneratorRenderStage", "notes=" + std::to_string(num_notes), buffer_size),
+                           new AudioRenderGraph(final_stage), generator->gid,
+                           [generator, num_notes]() { play_notes(generator, num_notes); });
+    }
+}
+
+static void bench_echo(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    for (const bool gpu_history : {false, true}) {
+        auto * generator = new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels, SINE_SHADER);
+        auto * echo = new AudioEchoEffectRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        echo->set_gpu_history_enabled(gpu_history);
+        generator->connect_render_stage(echo);
+        echo->connect_render_stage(final_stage);
+
+        bench_render_graph(report, config,
+                           stage_result(config, "AudioEchoEffectRenderStage", gpu_history ? "gpu_history" : "cpu_history", buffer_size),
+                           new AudioRenderGraph(final_stage), echo->gid,
+                           [generator]() { play_notes(generator, 1); });
+    }
+}
+
+static void bench_frequency_filter(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    for (const bool fft_convolution : {false, true}) {
+        for (const float follower : {0.0f, 1000.0f}) {
+            for (const int num_taps : {31, 127, 511, 2047}) {
+                auto * generator = new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels, SINE_SHADER);
+                auto * filter = new AudioFrequencyFilterEffectRenderStage(buffer_size, config.sample_rate, config.num_channels);
+                auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+                filter->find_parameter("num_taps")->set_value(num_taps);
+                filter->set_fft_convolution_enabled(fft_convolution);
+                filter->set_filter_follower(follower);
+                filter->force_coefficient_update();
+                generator->connect_render_stage(filter);
+                filter->connect_render_stage(final_stage);
+
+                const std::string params = "num_taps=" + std::to_string(num_taps) + (fft_convolution ? ",cpu_fft" : "") +
+                                           (follower != 0.0f ? ",follower" : "");
+                bench_render_graph(report, config,
+                                   stage_result(config, "AudioFrequencyFilterEffectRenderStage", params, buffer_size),
+                                   new AudioRenderGraph(final_stage), filter->gid,
+                                   [generator]() { play_notes(generator, 1); });
+            }
+        }
+    }
+}
+
+static void bench_multitrack_join(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    for (const unsigned int num_tracks : {2u, 4u, 8u}) {
+        auto * join = new AudioMultitrackJoinRenderStage(buffer_size, config.sample_rate, config.num_channels, num_tracks);
+        auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        std::vector<AudioGeneratorRenderStage *> generators;
+        for (unsigned int track = 0; track < num_tracks; ++track) {
+            generators.push_back(new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels, SINE_SHADER));
+            generators.back()->connect_render_stage(join);
+        }
+        join->connect_render_stage(final_stage);
+
+        bench_render_graph(report, config,
+                           stage_result(config, "AudioMultitrackJoinRenderStage", "tracks=" + std::to_string(num_tracks), buffer_size),
+                           new AudioRenderGraph(final_stage), join->gid,
+                           [generators]() {
+                               for (auto * generator : generators) {
+                                   play_notes(generator, 1);
+                               }
+                           });
+    }
+}
+
+static void bench_final_readback(BenchReport& report, const BenchConfig& config, const unsigned int buffer_size) {
+    for (const unsigned int latency : {0u, 2u}) {
+        auto * generator = new AudioGeneratorRenderStage(buffer_size, config.sample_rate, config.num_channels, SINE_SHADER);
+        auto * final_stage = new AudioFinalRenderStage(buffer_size, config.sample_rate, config.num_channels);
+        generator->connect_render_stage(final_stage);
+        if (!final_stage->set_readback_latency(latency)) {
+            std::cerr << "Error: Failed to set readback latency " << latency << std::endl;
+        }
+
+        bench_render_graph(report, config,
+                           stage_result(config, "AudioFinalRenderStage", "readback_latency=" + std::to_string(latency), buffer_size),
+                           new AudioRenderGraph(final_stage), final_stage->gid,
+                           [generator]() { play_notes(generator, 1); });
+    }
+}
+
+void run_render_stage_benchmarks(BenchReport& report, const BenchConfig& config) {
+    struct StageBench {
+        const char * name;
+        void (*run)(BenchReport&, const BenchConfig&, const unsigned int);
+    };
+    const StageBench benches[] = {
+        {"AudioGeneratorRenderStage", bench_generator},
+        {"AudioEchoEffectRenderStage", bench_echo},
+        {"AudioFrequencyFilterEffectRenderStage", bench_frequency_filter},
+        {"AudioMultitrackJoinRenderStage", bench_multitrack_join},
+        {"AudioFinalRenderStage", bench_final_readback},
+    };
+
+    for (const auto & bench : benches) {
+        if (!bench_selected(config, "stage", bench.name)) {
+            continue;
+        }
+        for (const unsigned int buffer_size : config.buffer_sizes) {
+            bench.run(report, config, buffer_size);
+        }
+    }
+}
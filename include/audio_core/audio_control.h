@@ -24,7 +24,7 @@ class AudioControlRegistry;
 class AudioControlBase {
 private:
     virtual void get_impl(const std::type_info& type, void * value) const = 0;
-    virtual void set_impl(const std::type_info& type, const void * value) = 0;
+    virtual bool set_impl(const std::type_info& type, const void * value) = 0;
     virtual void items_impl(const std::type_info& type, void * items) const = 0;
 
 public:
@@ -32,9 +32,16 @@ public:
     virtual const std::string& name() const = 0;
     virtual const std::type_index type() const = 0;
 
+    // Decides where the setters of controls set through set<T>() run. It is handed the setter call
+    // and returns true if it ran or queued it (e.g. for the audio render thread), false if it rejected
+    // it. An empty dispatcher runs every setter on the calling thread.
+    using SetterDispatcher = std::function<bool(std::function<void()>&)>;
+    static void set_setter_dispatcher(SetterDispatcher dispatcher);
+
+    // Returns false if the setter was rejected, the control then keeps its previous value
     template <typename T>
-    void set(const T& value) {
-        set_impl(typeid(T), &value);
+    bool set(const T& value) {
+        return set_impl(typeid(T), &value);
     }
 
     template <typename T>
@@ -50,6 +57,11 @@ public:
         items_impl(typeid(T), &items);
         return items;
     }
+
+protected:
+    // Runs or hands off a setter call; the control name labels the change in traces.
+    // Returns false if the dispatcher rejected the call
+    static bool dispatch_setter(const std::string& control_name, std::function<void()> setter_call);
 };
 
 template <typename T>
@@ -72,10 +84,15 @@ public:
 
 private:
 
-    void set_impl(const std::type_info& type, const void * value) override {
+    bool set_impl(const std::type_info& type, const void * value) override {
         if (type == typeid(ValueType)) {
             const ValueType& typed_value = *static_cast<const ValueType*>(value);
-            set(typed_value);
+            // The value only changes once the setter is accepted, so it never reports a dropped change
+            if (m_setter && !dispatch_setter(m_name, [setter = m_setter, typed_value]() { setter(typed_value); })) {
+                return false;
+            }
+            m_value = typed_value;
+            return true;
         } else {
             throw std::bad_cast();
         }
@@ -127,14 +144,18 @@ public:
 
 private:
 
-    void set_impl(const std::type_info& type, const void * value) override {
+    bool set_impl(const std::type_info& type, const void * value) override {
         if (type == typeid(ValueType)) {
             const ValueType& typed_value = *static_cast<const ValueType*>(value);
             // Ensure the new value exists in the allowed items
             if (std::find(m_items.begin(), m_items.end(), typed_value) == m_items.end()) {
                 throw std::invalid_argument("Value is not one of the items");
             }
-            set(typed_value);
+            if (m_setter && !dispatch_setter(m_name, [setter = m_setter, typed_value]() { setter(typed_value); })) {
+                return false;
+            }
+            m_value = typed_value;
+            return true;
         } else {
             throw std::bad_cast();
         }
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef AUDIO_FUSED_RENDER_PASS_H
+#define AUDIO_FUSED_RENDER_PASS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utilities/shader_program.h"
+
+class AudioRenderStage;
+class AudioParameter;
+
+/**
+ * @class AudioFusedRenderPass
+ * @brief Renders a linear run of point-wise render stages in a single draw.
+ *
+ * Every stage of a graph renders into its own framebuffer, which the next stage samples through
+ * stream_audio_texture. For stages that only read stream_audio_texture at TexCoord, the chain can
+ * instead be evaluated fragment by fragment in one shader: each stage body is namespaced with a
+ * _stage<i> suffix, its main() becomes main_stage<i>(), and the fused main() hands the output of
+ * one stage to the next through a local value instead of a texture.
+ *
+ * The pass samples the stream texture of the first stage and draws into the framebuffer of the
+ * last one, so the stages around the run are untouched. While the pass exists, the parameters of
+ * the stages resolve their uniforms in the fused program; release() points them back at the
+ * programs of their stages.
+ */
+class AudioFusedRenderPass {
+public:
+    /**
+     * @brief Constructs a fused pass over a run of connected stages.
+     *
+     * @param render_stages The stages in render order. Each one streams into the next.
+     */
+    AudioFusedRenderPass(std::vector<std::shared_ptr<AudioRenderStage>> render_stages);
+
+    AudioFusedRenderPass(const AudioFusedRenderPass&) = delete;
+    AudioFusedRenderPass& operator=(const AudioFusedRenderPass&) = delete;
+
+    /**
+     * @brief Generates and links the fused program and resolves the parameters of every stage in it.
+     *
+     * On failure every parameter is left pointing at the program of its own stage.
+     *
+     * @return True if the run can be rendered fused, false if it must be rendered stage by stage.
+     */
+    bool initialize();
+
+    /**
+     * @brief Points the parameters of every stage back at the program of their own stage.
+     *
+     * Must be called with the context current before the stages render on their own again.
+     */
+    void release();
+
+    /**
+     * @brief Renders every stage of the run in one draw into the framebuffer of the last stage.
+     *
+     * @param time The global time in blocks.
+     */
+    void render(const unsigned int time);
+
+    const std::vector<std::shared_ptr<AudioRenderStage>> & get_render_stages() const {
+        return m_render_stages;
+    }
+
+    const std::string & get_name() const {
+        return m_name;
+    }
+
+    const std::string & get_fragment_shader_source() const {
+        return m_fragment_shader_source;
+    }
+
+    /**
+     * @brief Whether a stage body only samples stream_audio_texture at TexCoord and can be namespaced.
+     *
+     * @param body The fragment shader of the stage, without its imports.
+     * @return True if the body can be part of a fused pass.
+     */
+    static bool is_point_wise_source(const std::string & body);
+
+    /**
+     * @brief Renames every global declared by a stage body (uniforms, constants, functions and main).
+     *
+     * @param body The fragment shader of the stage, without its imports.
+     * @param suffix The suffix added to every global name.
+     * @param sample_stream Whether the body keeps sampling stream_audio_texture. If false, the samples
+     *                      at TexCoord are replaced by the output of the previous stage.
+     * @param namespaced_body Set to the renamed body.
+     * @param global_names Set to the names declared by the body, before renaming.
+     * @return False if the body declares something that cannot be namespaced.
+     */
+    static bool namespace_source(const std::string & body,
+                                 const std::string & suffix,
+                                 const bool sample_stream,
+                                 std::string & namespaced_body,
+                                 std::vector<std::string> & global_names);
+
+private:
+    bool generate_fragment_shader_source();
+    bool link_parameters();
+
+    // The parameters resolved in the fused program, with the stage they belong to
+    struct LinkedParameter {
+        AudioRenderStage * render_stage;
+        AudioParameter * parameter;
+    };
+
+    std::vector<std::shared_ptr<AudioRenderStage>> m_render_stages;
+    std::vector<std::vector<std::string>> m_global_names; // Per stage, as declared in its body
+    std::vector<LinkedParameter> m_linked_parameters;
+
+    std::string m_name;
+    std::string m_fragment_shader_source;
+    std::unique_ptr<AudioShaderProgram> m_shader_program;
+};
+
+#endif // AUDIO_FUSED_RENDER_PASS_H
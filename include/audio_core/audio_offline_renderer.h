@@ -0,0 +1,172 @@
+#pragma once
+#ifndef AUDIO_OFFLINE_RENDERER_H
+#define AUDIO_OFFLINE_RENDERER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <GLES3/gl3.h>
+#include <EGL/egl.h>
+
+#include "audio_core/audio_parameter.h"
+#include "audio_core/audio_render_graph.h"
+#include "audio_core/audio_tape.h"
+#include "audio_output/audio_output.h"
+
+/**
+ * @class AudioOfflineRenderer
+ * @brief Renders an AudioRenderGraph back to back, as fast as the GPU allows.
+ *
+ * Unlike AudioRenderer, the offline renderer is not a singleton, is not registered with the
+ * EventLoop and is never paced by AudioOutput::is_ready(). Each call to render_blocks renders
+ * the requested number of blocks immediately and pushes them to the registered sinks
+ * (any AudioOutput, e.g. AudioFileOutput for WAV, and/or an AudioTape).
+ *
+ * If no EGL context is current when initialize() is called, the renderer creates its own
+ * headless pbuffer context, so it can run without any window or event loop.
+ */
+class AudioOfflineRenderer {
+public:
+    /**
+     * @brief Constructs an AudioOfflineRenderer object.
+     *
+     * @param render_graph The render graph to render. Ownership is taken by the renderer.
+     * @param buffer_size The size of the audio data buffer.
+     * @param sample_rate The sample rate of the audio data.
+     * @param num_channels The number of audio channels.
+     */
+    AudioOfflineRenderer(AudioRenderGraph * render_graph,
+                         const unsigned int buffer_size,
+                         const unsigned int sample_rate,
+                         const unsigned int num_channels);
+
+    /**
+     * @brief Destroys the AudioOfflineRenderer object and any headless context it created.
+     */
+    ~AudioOfflineRenderer();
+
+    AudioOfflineRenderer(AudioOfflineRenderer const&) = delete;
+    void operator=(AudioOfflineRenderer const&) = delete;
+
+    /**
+     * @brief Initializes the render graph, the global parameters and the quad.
+     *
+     * Uses the EGL context current on this thread, or creates a headless one if there is none.
+     *
+     * @return True if initialization is successful, false otherwise.
+     */
+    bool initialize();
+
+// -------------Add Functions----------------
+    /**
+     * @brief Adds an output sink. Ownership is taken by the renderer.
+     *
+     * The output must be opened and started by the caller. Its is_ready() is never consulted.
+     *
+     * @param output_link The output to push rendered blocks to.
+     * @return True if the output is successfully added, false otherwise.
+     */
+    bool add_render_output(AudioOutput * output_link);
+
+    /**
+     * @brief Records every rendered block into the given tape.
+     *
+     * @param tape The tape to record to, or nullptr to stop recording.
+     * @return True if the tape matches the renderer's format, false otherwise.
+     */
+    bool set_output_tape(std::shared_ptr<AudioTape> tape);
+
+    /**
+     * @brief Set the readback latency of the output stage, in blocks.
+     *
+     * Pipelining the readback lets the GPU work on the next render while the previous one is
+     * copied back. The latency is counted in renders, which hold get_blocks_per_render() blocks each. The renderer renders the extra blocks needed to flush the pipeline, so the
+     * sinks still receive exactly the requested blocks.
+     *
+     * @param blocks The number of renders of latency.
+     * @return True if the latency is successfully set, false otherwise.
+     */
+    bool set_readback_latency(const unsigned int blocks);
+
+// -------------Render Functions----------------
+    /**
+     * @brief Renders the given number of blocks back to back and pushes them to the sinks.
+     *
+     * Subsequent calls continue from where the previous call stopped. When the graph renders
+     * several blocks per draw, the count is rounded up to a whole number of draws.
+     *
+     * @param num_blocks The number of blocks to render.
+     * @return True if rendering is successful, false otherwise.
+     */
+    bool render_blocks(const unsigned int num_blocks);
+
+    /**
+     * @brief Renders at least the given duration of audio (rounded up to whole blocks).
+     *
+     * @param seconds The duration to render.
+     * @return True if rendering is successful, false otherwise.
+     */
+    bool render_seconds(const float seconds);
+
+// -------------Getters----------------
+    bool is_initialized() const {
+        return m_initialized;
+    }
+
+    AudioRenderGraph * get_render_graph() {
+        return m_render_graph.get();
+    }
+
+    AudioParameter * find_global_parameter(const std::string name) const;
+
+    // Number of blocks delivered to the sinks so far
+    unsigned int get_rendered_blocks() const {
+        return m_rendered_blocks;
+    }
+
+    // Audio seconds rendered per wall-clock second during the last render call
+    float get_realtime_factor() const {
+        return m_realtime_factor;
+    }
+
+private:
+    /**
+     * @brief Renders one draw (get_blocks_per_render() blocks) and advances the frame counter.
+     */
+    void render_block();
+
+    /**
+     * @brief Pushes the blocks of the last read back render to the outputs and the tape.
+     */
+    void push_to_sinks();
+
+    bool initialize_quad();
+
+    std::unique_ptr<AudioRenderGraph> m_render_graph;
+    std::vector<std::unique_ptr<AudioOutput>> m_render_outputs;
+    std::vector<std::unique_ptr<AudioParameter>> m_global_parameters;
+    std::shared_ptr<AudioTape> m_output_tape;
+
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+
+    // Context created by initialize() when none was current
+    EGLContext m_headless_context = EGL_NO_CONTEXT;
+
+    const unsigned int m_buffer_size;
+    const unsigned int m_sample_rate;
+    const unsigned int m_num_channels;
+
+    unsigned int m_readback_latency = 0;
+    unsigned int m_frame_count = 0;  // Global time in blocks
+    unsigned int m_render_count = 0; // Number of graph renders
+    unsigned int m_rendered_blocks = 0;
+    float m_realtime_factor = 0.0f;
+
+    // Channel major copy of the last block, for recording to the tape
+    std::vector<float> m_tape_block;
+
+    bool m_initialized = false;
+};
+
+#endif // AUDIO_OFFLINE_RENDERER_H
@@ -19,6 +19,8 @@ class AudioParameter {
 public:
     friend class AudioRenderStage;
     friend class AudioRenderer;
+    friend class AudioOfflineRenderer;
+    friend class AudioFusedRenderPass;
     enum ConnectionType {
         INPUT,
         PASSTHROUGH,
@@ -99,6 +101,15 @@ protected:
 
     virtual void render() = 0;
 
+    // Called when another render stage sharing the linked shader program may have changed its state
+    virtual void reset_program_state() {}
+
+    // Resolve the parameter in another program that declares it under the given name (fused render passes).
+    // Returns false if the parameter cannot be moved to another program.
+    virtual bool relink_program(AudioShaderProgram * shader_program, const std::string & uniform_name) {
+        return false;
+    }
+
     virtual std::unique_ptr<ParamData> create_param_data() = 0;
 
     std::unique_ptr<ParamData> m_data = nullptr; // Using unique pointer to cast to derived class
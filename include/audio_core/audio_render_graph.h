@@ -7,8 +7,10 @@
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 #include "audio_core/audio_render_stage.h"
+#include "audio_core/audio_fused_render_pass.h"
 #include "audio_render_stage/audio_final_render_stage.h"
 
 //       This graph should be able to:
@@ -38,6 +40,7 @@
 class AudioRenderGraph {
 public:
     friend class AudioRenderer;
+    friend class AudioOfflineRenderer;
     using GID = unsigned int;
 
     AudioRenderGraph(AudioRenderStage * output);
@@ -45,6 +48,29 @@ public:
 
     ~AudioRenderGraph();
 
+    /**
+     * @brief Groups several edits of the graph into a single render plan
+     * 
+     * Every edit publishes a new render plan, which bind() adopts at the next block boundary.
+     * Edits made while a scope is open are published together when the outermost scope closes,
+     * so the render path never adopts a half-made change (e.g. a module removed but not replaced).
+     * 
+     * The edits initialize the stages they add, so they must run on a thread where the render
+     * context is current. The stages they remove are freed by bind().
+     */
+    class EditScope {
+    public:
+        explicit EditScope(AudioRenderGraph & graph);
+        ~EditScope();
+
+        EditScope(const EditScope&) = delete;
+        EditScope& operator=(const EditScope&) = delete;
+
+    private:
+        AudioRenderGraph & m_graph;
+        std::lock_guard<std::recursive_mutex> m_guard;
+    };
+
     // Render Stage Manipulation
     AudioRenderStage * find_render_stage(GID gid) { return m_render_stages_map[gid].get(); }
 
@@ -60,9 +86,10 @@ public:
 
     // Getters
     AudioFinalRenderStage * get_output_render_stage() {
-        return dynamic_cast<AudioFinalRenderStage *>(find_render_stage(m_outputs[0]));
+        return m_output_render_stage;
     }
 
+    // The order of the edited graph, which is rendered from the next bind()
     const std::vector<GID>& get_render_order() const {
         return m_render_order;
     }
@@ -71,11 +98,118 @@ public:
         return m_initialized;
     }
 
+    // Number of consecutive blocks every stage renders per draw
+    unsigned int get_blocks_per_render() const {
+        return m_blocks_per_render;
+    }
+
+    /**
+     * @brief Render several consecutive blocks per draw in every stage
+     * 
+     * A render at time t then produces blocks t .. t + blocks_per_render - 1, and the output
+     * stage hands them all out in one readback. Fails if any stage does not support batching.
+     * Must be called before initialization.
+     * 
+     * @param blocks_per_render The number of blocks per draw (1 disables batching)
+     * @return True if every stage accepted the batch size, false otherwise.
+     */
+    bool set_blocks_per_render(const unsigned int blocks_per_render);
+
+    bool has_half_float_streams() const {
+        return m_half_float_streams;
+    }
+
+    /**
+     * @brief Store the links between stages as 16-bit floats
+     * 
+     * Every stage that supports it reads its streams from half float textures, which halves the
+     * bandwidth of each link for about 11 bits of precision. The final mix, histories and
+     * coefficient textures stay 32-bit. Stages added later follow the policy unless they are
+     * already initialized. Must be called before initialization. Without EXT_color_buffer_half_float
+     * or EXT_color_buffer_float the links stay 32-bit with a warning.
+     * 
+     * @param half_float True for 16-bit links, false for 32-bit
+     * @return True if the policy is set or kept at 32-bit, false otherwise.
+     */
+    bool set_half_float_streams(const bool half_float);
+
+    /**
+     * @brief Get the timings of every stage over its most recent blocks
+     * 
+     * Each stage keeps a ring of per-block samples filled by render(), so this can be called
+     * from any thread while the graph renders. Empty if the build disables AUDIO_STAGE_TIMING.
+     * 
+     * @return The min/mean/p99 time of each phase, in microseconds, per stage GID.
+     */
+    std::unordered_map<GID, AudioStageTimer::Stats> get_stage_timings();
+
+    /**
+     * @brief Render linear runs of point-wise stages in a single fused pass
+     * 
+     * A run is a chain of fusible stages (see AudioRenderStage::is_fusible()) where each stage only
+     * feeds the next one. The run is drawn once, from the stream of its first stage into the output
+     * of its last, and its timings are recorded on its first stage. The runs are rebuilt by the next
+     * bind() after the graph changes, and a run whose fused shader fails to build is rendered stage
+     * by stage. Enabled by default.
+     * 
+     * @param enabled Whether to fuse the point-wise stages
+     */
+    void set_stage_fusion_enabled(const bool enabled);
+
+    bool is_stage_fusion_enabled() const {
+        return m_stage_fusion_enabled;
+    }
+
+    /**
+     * @brief Skip the stages that only output silence
+     * 
+     * A stage is skipped once every stage it streams from was skipped, it reports that it adds nothing
+     * to silent inputs (see AudioRenderStage::is_silent_without_input()) and its tail has been rendered.
+     * The first skipped block clears its output, so the stages it feeds read silence. Enabled by default.
+     * 
+     * @param enabled Whether to skip silent stages
+     */
+    void set_silence_culling_enabled(const bool enabled);
+
+    bool is_silence_culling_enabled() const {
+        return m_silence_culling_enabled;
+    }
+
+    /**
+     * @brief Get the stages skipped by the last render because they only output silence
+     * 
+     * @return The GIDs of the skipped stages, in render order.
+     */
+    std::vector<GID> get_silent_stages() const;
+
+    /**
+     * @brief Get the runs of stages currently rendered in one pass
+     * 
+     * @return The GIDs of the stages of each fused pass, in render order.
+     */
+    std::vector<std::vector<GID>> get_fused_runs() const;
+
 private:
+    // An immutable snapshot of the graph, read by the render path without locking
+    struct RenderPlan {
+        std::vector<std::shared_ptr<AudioRenderStage>> render_stages; // In render order
+        std::unordered_map<GID, std::vector<GID>> output_links; // The stages each stage renders into
+        std::unordered_map<GID, std::vector<GID>> input_links; // The stages each stage streams from
+        std::unordered_map<GID, std::vector<AudioRenderStage *>> input_stages;
+        bool stage_fusion_enabled = true;
+        bool silence_culling_enabled = true;
+    };
+
     bool initialize();
 
     void render(unsigned int time);
 
+    /**
+     * @brief Adopts the newest render plan published by the edits, if any
+     * 
+     * Only the stages whose links changed are bound again. Never waits: if an edit is in
+     * progress the current plan is kept for one more block.
+     */
     void bind();
 
     bool m_initialized = false;
@@ -84,15 +218,47 @@ private:
 
     static AudioRenderStage * from_input_to_output(AudioRenderStage * node, std::unordered_set<GID> & visited);
     bool construct_render_order(AudioRenderStage * node);
-    bool bind_render_stages();
+    bool match_blocks_per_render(AudioRenderStage * render_stage);
+    bool match_stream_precision(AudioRenderStage * render_stage, const bool half_float);
+
+    // Edit side, called with m_edit_mutex held
+    std::unique_ptr<RenderPlan> make_render_plan();
+    void publish_render_plan();
+
+    // Render side, called with m_edit_mutex held
+    bool adopt_render_plan(std::unique_ptr<RenderPlan> plan);
+    void build_fused_passes(const RenderPlan & plan);
+    void release_fused_passes();
+    bool is_silent(const RenderPlan & plan, AudioRenderStage * render_stage);
+    bool is_silent(AudioRenderStage * render_stage, const bool inputs_silent);
 
     std::vector<GID> m_outputs;
     std::vector<GID> m_inputs;
     std::vector<GID> m_render_order;
+    AudioFinalRenderStage * m_output_render_stage = nullptr;
+
+    // Serializes the edits. The render path only ever tries to take it.
+    std::recursive_mutex m_edit_mutex;
+    unsigned int m_edit_depth = 0; // Open edit scopes
+    bool m_plan_changed = false; // An edit since the last published plan
+
+    // Published by the edits, adopted by bind() at the next block boundary
+    std::atomic<RenderPlan *> m_pending_plan{nullptr};
+    // The plan being rendered, only touched by the render path
+    std::unique_ptr<RenderPlan> m_active_plan;
+    // Plans replaced by bind() or superseded by an edit, freed by bind() so removed stages are only ever
+    // destroyed by the render path, between two blocks
+    std::vector<std::unique_ptr<RenderPlan>> m_retired_plans;
+
+    unsigned int m_blocks_per_render = 1;
+    bool m_half_float_streams = false;
 
-    std::mutex m_graph_mutex;
+    // Fused passes keyed by the GID of their first stage, and every stage they render
+    bool m_stage_fusion_enabled = true;
+    std::unordered_map<GID, std::unique_ptr<AudioFusedRenderPass>> m_fused_passes;
+    std::unordered_set<GID> m_fused_stages;
 
-    bool m_needs_update = false;
+    bool m_silence_culling_enabled = true;
 
     std::unordered_map<GID, std::shared_ptr<AudioRenderStage>> m_render_stages_map;
 };
@@ -11,6 +11,7 @@
 
 #include "audio_core/audio_parameter.h"
 #include "utilities/shader_program.h"
+#include "utilities/audio_stage_timer.h"
 #include "audio_core/audio_control.h"
 #include "audio_render_stage_plugins/audio_render_stage_plugin.h"
 
@@ -19,11 +20,13 @@
 
 class AudioRenderGraph;
 class AudioParameter;
+class AudioTexture2DParameter;
 
 class AudioRenderStage {
 public:
     friend class AudioRenderGraph;
     friend class AudioRenderStageHistory;
+    friend class AudioFusedRenderPass;
 
     // Constructor
     static const std::vector<std::string> default_frag_shader_imports;
@@ -85,7 +88,8 @@ public:
     /** 
      * @brief Add a parameter to the audio parameter list
      * 
-     * This function adds a parameter to the audio parameter list
+     * This function adds a parameter to the audio parameter list, replacing any parameter
+     * with the same name
      * 
      * @param parameter The parameter to add
      * @return True if the parameter is successfully added, false otherwise.
@@ -105,7 +109,9 @@ public:
     /**
      * @brief Find a parameter by name
      * 
-     * This function finds a parameter by name
+     * This function finds a parameter by name. The lookup is a linear search, so code that
+     * runs every block should keep the parameter as a handle resolved in resolve_parameters(),
+     * which follows the parameter when it is replaced or removed.
      * 
      * @param name The name of the parameter to find
      * @return The parameter if found, nullptr otherwise.
@@ -166,6 +172,118 @@ public:
      */
     bool register_plugin(AudioRenderStagePlugin* plugin);
 
+    /**
+     * @brief Set the number of consecutive blocks rendered by a single draw
+     * 
+     * The audio textures are stacked along y as blocks_per_render groups of num_channels rows,
+     * and the shaders address them through the audio_block()/block_time() helpers.
+     * Must be called before initialization.
+     * 
+     * @param blocks_per_render The number of blocks per draw (1 disables batching)
+     * @return True if the stage can render that many blocks at once, false otherwise.
+     */
+    bool set_blocks_per_render(const unsigned int blocks_per_render);
+
+    unsigned int get_blocks_per_render() const {
+        return m_blocks_per_render;
+    }
+
+    /**
+     * @brief Store the streams the stage reads as 16-bit floats
+     * 
+     * The stage before this one renders straight into these textures, so this halves the bandwidth
+     * of the link for about 11 bits of precision. History, coefficient and output textures keep
+     * 32 bits. Must be called before initialization.
+     * 
+     * @param half_float True for 16-bit streams, false for 32-bit
+     * @return True if every stream accepted the storage, false otherwise.
+     */
+    bool set_half_float_streams(const bool half_float);
+
+    bool has_half_float_streams() const {
+        return m_half_float_streams;
+    }
+
+    /**
+     * @brief Whether the stage can render several blocks in one draw
+     * 
+     * Stages whose output depends on previous blocks (history, tapes) must render one block at a time.
+     * 
+     * @return True if the stage supports batching, false otherwise.
+     */
+    virtual bool supports_batching() const {
+        return true;
+    }
+
+    /**
+     * @brief Whether the stage may read its streams from 16-bit float textures
+     * 
+     * @return True if the stage supports half float streams, false if it needs full precision input.
+     */
+    virtual bool supports_half_float_streams() const {
+        return true;
+    }
+
+    /**
+     * @brief Whether the graph may render the stage as part of a fused pass
+     * 
+     * Stages that do work outside their shader in render() (history, notes, readback) must be rendered on their own.
+     * 
+     * @return True if the stage can be fused, false otherwise.
+     */
+    virtual bool supports_fusion() const {
+        return true;
+    }
+
+    /**
+     * @brief Whether the next render outputs silence when the inputs of the stage are silent
+     * 
+     * The graph skips the stage once its inputs have been silent for longer than its tail. A stage
+     * with an arbitrary shader may make sound on its own, so stages must opt in.
+     * 
+     * @return True if the stage adds nothing to silent inputs, false otherwise.
+     */
+    virtual bool is_silent_without_input() const {
+        return false;
+    }
+
+    /**
+     * @brief The number of blocks the output can keep sounding after the inputs go silent
+     * 
+     * @return The tail length in blocks, 0 for stages without history.
+     */
+    virtual unsigned int get_tail_blocks() const {
+        return 0;
+    }
+
+    /**
+     * @brief Whether the stage is point-wise and can be rendered in a fused pass
+     * 
+     * A point-wise stage supports fusion, has no plugins, samples no texture but stream_audio_texture,
+     * and only reads it at TexCoord.
+     * 
+     * @return True if the stage can be fused with the stages around it, false otherwise.
+     */
+    bool is_fusible() const;
+
+    /**
+     * @brief Get the fragment shader of the stage without its imports
+     * 
+     * @return The shader source given to the constructor, or read from its path.
+     */
+    std::string get_fragment_shader_body() const;
+
+    /**
+     * @brief Get the timings of the blocks rendered by the stage
+     * 
+     * The render graph opens and closes a timing block around every render of the stage.
+     * 
+     * @return The timer of the stage.
+     */
+    const AudioStageTimer & get_stage_timer() const {
+        return m_stage_timer;
+    }
+
     static const std::string get_shader_source(const std::string & file_path);
     static const std::string combine_shader_source(const std::vector<std::string> & import_paths, const std::string & shader_path);
     static const std::string combine_shader_source_with_string(const std::vector<std::string> & import_paths, const std::string & shader_source);
@@ -213,6 +331,31 @@ protected:
      */
     virtual void render(const unsigned int time);
 
+    /**
+     * @brief Select the color attachments of the output textures for the next draw
+     */
+    void apply_draw_buffers();
+
+    /**
+     * @brief Look the parameter handles of the stage up again
+     * 
+     * Called after every parameter is added or removed, so a handle points to the parameter
+     * that replaced its old one, or is null once the parameter is removed. Stages that keep
+     * handles of their own override it and call the base version first.
+     */
+    virtual void resolve_parameters();
+
+    /**
+     * @brief Skip the render of a block in which the stage only outputs silence
+     * 
+     * The first skipped block clears the output, so the stages fed by this one read silence. The
+     * block time follows the graph, but the local time only counts the rendered blocks so the
+     * history of the stage carries on where it stopped.
+     * 
+     * @param time The global time in blocks.
+     */
+    void skip_render(const unsigned int time);
+
     // Time
     unsigned int m_time = std::numeric_limits<unsigned int>::max(); // Start it at max int value to ensure it is updated on first render
 
@@ -221,6 +364,15 @@ protected:
 
     GLuint m_active_texture_count = 0;
     GLuint m_color_attachment_count = 0;
+
+    // Number of consecutive blocks rendered per draw
+    unsigned int m_blocks_per_render = 1;
+
+    // Samples of a row held by each texel of the output textures, the draw runs one fragment per texel
+    unsigned int m_samples_per_texel = 1;
+
+    // Whether the stream textures store 16-bit floats
+    bool m_half_float_streams = false;
     
 
     virtual const std::vector<AudioParameter *> get_output_interface();
@@ -234,8 +386,11 @@ protected:
     // Framebuffer for the stage if it involves outputs
     GLuint m_framebuffer;
 
-    // Parameters
-    std::unordered_map<std::string, std::unique_ptr<AudioParameter>> m_parameters;
+    // Parameters, kept in render order (textures, then uniform buffers, then uniforms)
+    std::vector<std::unique_ptr<AudioParameter>> m_parameters;
+    // Default audio textures, resolved for the per-block code of derived stages
+    AudioTexture2DParameter * m_stream_audio_texture = nullptr;
+    AudioTexture2DParameter * m_output_audio_texture = nullptr;
     std::vector<AudioParameter *> m_input_parameters;
     std::vector<AudioParameter *> m_output_parameters;
     std::vector<GLenum> m_draw_buffers;
@@ -248,6 +403,13 @@ protected:
     // Registered plugins
     std::vector<AudioRenderStagePlugin*> m_plugins;
 
+    // Time spent in each phase of the blocks rendered by the graph
+    AudioStageTimer m_stage_timer;
+
+    // Blocks rendered in a row from silent inputs without sound of its own, and whether the output is cleared
+    unsigned int m_silent_blocks = 0;
+    bool m_output_silenced = false;
+
 private:
 
     /**
@@ -8,6 +8,12 @@
 #include <SDL2/SDL.h>
 #include <atomic>
 #include <thread>
+#include <future>
+#include <semaphore>
+#include <functional>
+#include <deque>
+#include <string>
+#include <unordered_map>
 
 #include "audio_core/audio_render_stage.h"
 #include "audio_output/audio_output.h"
@@ -15,6 +21,7 @@
 #include "audio_core/audio_render_graph.h"
 #include "engine/event_loop.h"
 #include "engine/renderable_entity.h"
+#include "utilities/audio_command_queue.h"
 
 /**
  * @class AudioRenderer
@@ -53,6 +60,92 @@ public:
      */
     bool initialize(const unsigned int buffer_size, const unsigned int sample_rate, const unsigned int num_channels);
 
+    /**
+     * @brief Selects a headless EGL context (pbuffer or surfaceless) instead of an SDL window.
+     * 
+     * A headless renderer needs no windowing system at all. Must be called before initialize().
+     * 
+     * @param headless True to render without a window, false to create a hidden SDL window.
+     * @return True if the mode is set, false if the renderer is already initialized.
+     */
+    bool set_headless(const bool headless);
+
+    bool is_headless() const {
+        return m_headless;
+    }
+
+    /**
+     * @brief Pipelines the readback of the output stage over the given number of renders.
+     * 
+     * The GPU then works on the next render while the previous ones are copied back. In exchange
+     * the outputs receive silence for the first renders, then every block that many renders after
+     * it was rendered. Must be called before initialize().
+     * 
+     * @param blocks The number of renders of latency (0 reads the output back synchronously).
+     * @return True if the latency is set, false if the renderer is already initialized.
+     */
+    bool set_readback_latency(const unsigned int blocks);
+
+    unsigned int get_readback_latency() const {
+        return m_readback_latency;
+    }
+
+    /**
+     * @brief Makes the renderer's context current, headless or windowed.
+     */
+    void activate_render_context() override;
+
+    /**
+     * @brief Initializes the audio renderer on a dedicated render thread instead of the EventLoop.
+     * 
+     * The thread creates its own headless EGL context, initializes the render graph in it and renders
+     * whenever the lead output has room for another block. It sleeps until an output signals demand,
+     * so UI rendering on the EventLoop never delays audio. While the thread runs, the EventLoop
+     * callbacks of the renderer do nothing and control setters are queued for the render thread
+     * (a control set while the queue is full keeps its value and its set() returns false).
+     * Any other change to the render graph must be made through post_command().
+     * 
+     * @param buffer_size The size of the audio data buffer.
+     * @param sample_rate The sample rate of the audio data.
+     * @param num_channels The number of audio channels.
+     * @return True if the thread started and initialized the render graph, false otherwise.
+     */
+    bool initialize_render_thread(const unsigned int buffer_size, const unsigned int sample_rate, const unsigned int num_channels);
+
+    /**
+     * @brief Stops the render thread and releases the render graph and GL resources it owns.
+     */
+    void stop_render_thread();
+
+    bool is_render_thread_running() const {
+        return m_render_thread_running.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Runs a command on the render thread between two blocks.
+     * 
+     * Without a render thread, or when called from the render thread, the command runs immediately.
+     * Commands must all be posted from the same thread.
+     * 
+     * @param command The command to run.
+     * @return True if the command ran or was queued, false if the command queue is full.
+     */
+    bool post_command(std::function<void()> command);
+
+    /**
+     * @brief Queues non real-time work (e.g. building render stages ahead of use) for idle time.
+     * 
+     * One task runs after a render, and only while the lead output does not need another block yet
+     * and has enough audio queued to keep playing through it. A task is expected to take as long as
+     * the last tasks of its kind, or as the slowest kind when none ran yet, so with a short output
+     * queue long tasks wait until the queue is deeper. A task that waits that long is logged once.
+     * 
+     * @param task The task to run in the render context.
+     * @param kind Groups the tasks of similar duration (e.g. building one type of module).
+     * @return True if the task is queued, false otherwise.
+     */
+    bool add_idle_task(std::function<void()> task, const std::string & kind = "");
+
     // IEventLoopItem interface
     bool is_ready() override;
     void render() override;
@@ -165,12 +258,41 @@ private:
 // -------------Helper Functions----------------
 
     /**
-     * @brief Pushes data to all output buffers.
+     * @brief Hands a rendered block to all outputs, which queue it for their own consumer.
      * 
-     * @param data The data to push.
+     * @param data The block to push.
      */
     void push_to_output_buffers(const float * data);
 
+    /**
+     * @brief Checks if the lead output wants another block.
+     * 
+     * @return True if a block should be rendered, false otherwise.
+     */
+    bool outputs_ready();
+
+    /**
+     * @brief Runs the oldest idle task if the lead output has enough audio queued to play through it.
+     */
+    void run_idle_task();
+
+    /**
+     * @brief Checks if the caller is not the render thread while a render thread is running.
+     */
+    bool is_foreign_thread() const;
+
+    /**
+     * @brief Body of the render thread.
+     * 
+     * @param started Set once the render graph is initialized, with the initialization result.
+     */
+    void render_thread_main(std::promise<bool> started);
+
+    /**
+     * @brief Releases the GL resources of the renderer in the current context.
+     */
+    void release_render_resources();
+
 
 // -------------Initialization Functions----------------
     /**
@@ -180,6 +302,13 @@ private:
      */
     bool initialize_global_parameters();
 
+    /**
+     * @brief Initializes the render graph, global parameters and quad in the current context.
+     * 
+     * @return True if initialization is successful, false otherwise.
+     */
+    bool initialize_render_resources();
+
     /**
      * @brief Initializes the quad for rendering.
      * 
@@ -191,8 +320,12 @@ private:
      */
     bool initialize_quad();
 
-    GLuint m_VAO; // Vertex Array Object for holding vertex attribute configurations
-    GLuint m_VBO; // Vertex Buffer Object for holding vertex data
+    GLuint m_VAO = 0; // Vertex Array Object for holding vertex attribute configurations
+    GLuint m_VBO = 0; // Vertex Buffer Object for holding vertex data
+
+    bool m_headless = false; // Render in a headless context instead of an SDL window
+    unsigned int m_readback_latency = 0; // Renders between the render of a block and its delivery
+    EGLContext m_headless_context = EGL_NO_CONTEXT; // Context created by initialize() when headless
 
     unsigned int m_buffer_size; // Size of audio data
     unsigned int m_num_channels; // Number of audio channels
@@ -201,13 +334,36 @@ private:
     unsigned int m_frame_count = 0; // Frame count for calculating frame rate
     AudioOutput * m_lead_output = nullptr; // Lead output for frame rate calculation
 
-    bool m_initialized = false; // Flag to mark initialization
-    bool m_paused = false; // Flag to mark pause state
-    bool m_increment = false; // Flag to mark increment state
+    std::atomic<bool> m_initialized{false}; // Flag to mark initialization
+    std::atomic<bool> m_paused{false}; // Flag to mark pause state
+    std::atomic<bool> m_increment{false}; // Flag to mark increment state
 
     std::vector<std::unique_ptr<AudioOutput>> m_render_outputs; // Render outputs
     std::vector<std::unique_ptr<AudioParameter>> m_global_parameters; // Parameters for render stages
     std::unique_ptr<AudioRenderGraph> m_render_graph; // Render graph
+
+    // Dedicated render thread
+    static constexpr unsigned int COMMAND_QUEUE_SIZE = 256;
+    std::thread m_render_thread;
+    std::atomic<std::thread::id> m_render_thread_id{};
+    std::atomic<bool> m_render_thread_running{false};
+    std::counting_semaphore<> m_output_demand{0}; // Released by outputs with room and by posted commands
+    AudioCommandQueue m_commands{COMMAND_QUEUE_SIZE}; // Commands run on the render thread between blocks
+
+    struct IdleTask {
+        std::function<void()> task;
+        std::string kind;
+        unsigned int deferrals = 0; // Times it did not fit in the queued audio
+    };
+    std::deque<IdleTask> m_idle_tasks; // Only touched by the rendering thread
+
+    // Expected duration of each kind of idle task. It follows a slower run at once and decays
+    // towards faster ones, so a single slow run does not hold the kind back for good.
+    static constexpr float IDLE_TASK_INITIAL_SECONDS = 0.002f; // Before any task ran
+    static constexpr float IDLE_TASK_DECAY = 0.75f; // Weight the estimate keeps after a faster run
+    static constexpr unsigned int IDLE_TASK_DEFERRAL_WARNING = 2000; // Deferrals before a task is logged
+    std::unordered_map<std::string, float> m_idle_task_seconds;
+    float expected_idle_task_seconds(const std::string & kind) const;
 };
 
 #endif // AUDIO_RENDERER_H
\ No newline at end of file
@@ -72,6 +72,34 @@ private:
         unsigned int texture_width,
         unsigned int texture_rows_per_channel) const;
 
+    // Copy count samples of one channel starting at a global sample index, using the same
+    // out-of-range rules as playback_for_render_stage_history (zeros outside the recorded data)
+    void playback_range_for_render_stage_history(unsigned int channel,
+                                                 unsigned int start_global,
+                                                 unsigned int count,
+                                                 float * dest) const;
+
+    // Log of the ranges of global sample indices whose values changed, so the render stage
+    // history can upload only what changed since its last upload
+    struct ModifiedRange {
+        unsigned long revision;
+        unsigned int start;
+        unsigned int end; // exclusive
+    };
+    static constexpr unsigned int MODIFIED_RANGE_LOG_SIZE = 32;
+
+    unsigned long get_revision() const { return m_revision; }
+
+    // Collect the ranges modified after the given revision
+    // Returns false if the changes can not be described by ranges (log too short or tape cleared)
+    bool get_modified_ranges_since(unsigned long revision, std::vector<std::pair<unsigned int, unsigned int>> & ranges) const;
+
+    void log_modified_range(unsigned int start, unsigned int end);
+
+    std::vector<ModifiedRange> m_modified_ranges = std::vector<ModifiedRange>(MODIFIED_RANGE_LOG_SIZE);
+    unsigned long m_revision = 0;
+    unsigned long m_cleared_revision = 0;
+
     using ChannelData = std::vector<float>; // contiguous per-channel time-series
     std::vector<ChannelData> m_data; // size = m_num_channels, each vector length = samples over time
 
@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <string>
+#include <chrono>
 
 #include "audio_output/audio_wav.h"
 #include "audio_output/audio_output.h"
@@ -69,11 +70,21 @@ public:
      */
     bool close() override;
 
+    /**
+     * Sets whether is_ready() paces writes to real time (once per buffer duration).
+     * Pacing is on by default. Disable it to write as fast as blocks are produced.
+     * 
+     * @param paced True to pace writes to real time, false otherwise.
+     */
+    void set_realtime_paced(const bool paced) { m_realtime_paced = paced; }
+
 private:
     std::string m_filename;
     std::ofstream m_file;
     bool m_is_running = false;
     WAVHeader m_header;
+    bool m_realtime_paced = true;
+    std::chrono::high_resolution_clock::time_point m_last_ready_check = std::chrono::high_resolution_clock::now();
 };
 
 #endif // AUDIO_FILE_OUTPUT_H
\ No newline at end of file
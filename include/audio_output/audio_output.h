@@ -4,6 +4,9 @@
 
 #include <memory>
 #include <chrono>
+#include <atomic>
+#include <semaphore>
+#include <limits>
 
 class AudioOutput {
 public:
@@ -34,6 +37,16 @@ public:
      * @return True if the audio output device is ready, false otherwise.
      */
     virtual bool is_ready() = 0;
+    /**
+     * Audio pushed to the output that has not been played yet, which is how long the output can
+     * play without another block. Outputs without a playback deadline (e.g. files) have no limit.
+     * 
+     * @return The queued audio in seconds.
+     */
+    virtual float get_queued_seconds() const {
+        return std::numeric_limits<float>::infinity();
+    }
+
     /**
      * Push audio data to the audio output device.
      * 
@@ -66,12 +79,33 @@ public:
      */
     virtual bool close() = 0;
 
+    /**
+     * Set the semaphore to release whenever the output frees room for another block, so a render
+     * thread can sleep until there is demand instead of polling is_ready().
+     * 
+     * @param signal The semaphore to release, or nullptr to stop signalling.
+     */
+    void set_demand_signal(std::counting_semaphore<> * signal) {
+        m_demand_signal.store(signal, std::memory_order_release);
+    }
+
 protected:
+    /**
+     * Wake whoever waits for this output to need data. Safe to call from an audio callback.
+     */
+    void notify_demand() {
+        if (auto * signal = m_demand_signal.load(std::memory_order_acquire)) {
+            signal->release();
+        }
+    }
+
     const unsigned m_frames_per_buffer; // The number of frames per buffer of the audio output device
     const unsigned m_sample_rate; // The sample rate of the audio output device
     const unsigned m_channels; // The number of channels of the audio output device
 
 private:
+    std::atomic<std::counting_semaphore<> *> m_demand_signal{nullptr};
+
     /**
      * Generate a unique identifier for the audio output device
      * 
@@ -6,11 +6,25 @@
 #include <mutex>
 #include <SDL2/SDL.h>
 #include <memory>
+#include <atomic>
 
 #include "audio_output/audio_output.h"
+#include "utilities/audio_ring_buffer.h"
 
 class AudioPlayerOutput : public AudioOutput {
 public:
+    /**
+     * How the rendered blocks reach the device.
+     * 
+     * QUEUE pushes blocks with SDL_QueueAudio and paces the renderer on the SDL queue size.
+     * CALLBACK lets the SDL audio thread pull blocks from a lock-free ring filled by push(),
+     * keeping at most the configured queue depth of blocks ahead of the device.
+     */
+    enum class Mode {
+        QUEUE,
+        CALLBACK
+    };
+
     /**
      * Constructor for the AudioSDLOutputNew class.
      * 
@@ -36,6 +50,10 @@ public:
      * This can be used in tests to confirm that the device is consuming data.
      */
     size_t queued_bytes() const;
+    /**
+     * Return the audio queued ahead of the device, in the SDL queue or the ring.
+     */
+    float get_queued_seconds() const override;
     /**
      * Clear the audio queue, removing all pending audio data.
      * This is useful for test cleanup to ensure tests start with a clean state.
@@ -44,9 +62,39 @@ public:
     /**
      * Push audio data to the audio output device.
      * 
+     * In CALLBACK mode a block pushed while the ring is full is dropped and counted as an overrun.
+     * 
      * @param data The audio data to push.
     */
     void push(const float * data) override;
+    /**
+     * Select how blocks reach the device. Must be called before open().
+     * 
+     * @param mode The output mode.
+     * @return True if the mode was set, false if the device is already open.
+    */
+    bool set_mode(const Mode mode);
+    Mode get_mode() const { return m_mode; }
+    /**
+     * Set the number of blocks kept ahead of the device in CALLBACK mode. Must be called before open().
+     * 
+     * @param blocks The target queue depth, at least 1.
+     * @return True if the depth was set, false otherwise.
+    */
+    bool set_queue_depth(const unsigned int blocks);
+    unsigned int get_queue_depth() const { return m_queue_depth; }
+    /**
+     * Output latency measured by the audio callback: the audio queued ahead of the device when the
+     * callback started plus the device buffer itself. Only measured in CALLBACK mode.
+     * 
+     * @return The last measured latency in seconds.
+    */
+    float get_output_latency() const;
+    // Callbacks that found no block to play (CALLBACK mode)
+    unsigned int get_underrun_count() const;
+    // Blocks dropped because the ring was full (CALLBACK mode)
+    unsigned int get_overrun_count() const;
+    unsigned int get_xrun_count() const { return get_underrun_count() + get_overrun_count(); }
     // TODO: Add device selection and error handling
     /**
      * Open the audio output device.
@@ -79,8 +127,23 @@ private:
      */
     static void error(const char* message);
 
+    /**
+     * SDL audio thread callback for CALLBACK mode. Fills the device buffer from the ring.
+     */
+    static void audio_callback(void * userdata, Uint8 * stream, int len);
+
     SDL_AudioDeviceID m_device_id;
     bool m_is_running = false;
+
+    Mode m_mode = Mode::QUEUE;
+    unsigned int m_queue_depth = 2;
+
+    // CALLBACK mode transport, produced by push() and consumed by the SDL audio thread
+    std::unique_ptr<AudioRingBuffer> m_ring;
+    const float * m_callback_block = nullptr; // Block being played, owned by the audio thread
+    unsigned int m_callback_offset = 0; // Samples of m_callback_block already played
+    unsigned int m_device_samples = 0; // Frames per device buffer obtained from SDL
+    std::atomic<unsigned int> m_latency_frames{0};
 };
 
 #endif
@@ -4,6 +4,7 @@
 
 #include <GLES3/gl3.h>
 #include <EGL/egl.h>
+#include <vector>
 
 #include "audio_core/audio_parameter.h"
 
@@ -23,38 +24,190 @@ public:
 
     ~AudioTexture2DParameter() ;
 
+    using AudioParameter::set_value;
+
+    /**
+     * @brief Set a sub-rectangle of the texture data
+     * 
+     * Only the dirty regions are uploaded on the next render instead of the whole texture.
+     * Only valid for INPUT parameters.
+     * 
+     * @param value_ptr Tightly packed data for the region (width * height texels)
+     * @param x_offset The first column of the region
+     * @param y_offset The first row of the region
+     * @param width The width of the region in texels
+     * @param height The height of the region in texels
+     * @return True if the value is successfully set, false otherwise.
+     */
+    bool set_value(const void * value_ptr, GLuint x_offset, GLuint y_offset, GLuint width, GLuint height);
+
+    /**
+     * @brief Set a range of full rows of the texture data
+     * 
+     * @param value_ptr Tightly packed data for the rows (parameter width * num_rows texels)
+     * @param first_row The first row to set
+     * @param num_rows The number of rows to set
+     * @return True if the value is successfully set, false otherwise.
+     */
+    bool set_value_rows(const void * value_ptr, GLuint first_row, GLuint num_rows) {
+        return set_value(value_ptr, 0, first_row, m_parameter_width, num_rows);
+    }
+
     // Getters
     GLuint get_texture() const { return m_texture; }
 
+    GLuint get_width() const { return m_parameter_width; }
+
+    GLuint get_height() const { return m_parameter_height; }
+
+    /**
+     * @brief Change the texture dimensions before the parameter is initialized
+     * 
+     * Any data already set is discarded.
+     * 
+     * @param width The new width in texels
+     * @param height The new height in texels
+     * @return True if the texture is resized, false if it is already initialized.
+     */
+    bool resize(GLuint width, GLuint height);
+
+    // Samples held by each RGBA texel of a packed audio texture
+    static constexpr GLuint PACKED_SAMPLES = 4;
+
+    /**
+     * @brief Switch between one sample per texel (GL_R32F) and the packed layout before initialization
+     * 
+     * In the packed layout each GL_RGBA32F texel holds PACKED_SAMPLES consecutive samples of a row,
+     * so the texture is a quarter of the width and a draw into it runs a quarter of the fragments.
+     * Read back row by row, both layouts give the same samples in the same order.
+     * Any data already set is discarded.
+     * 
+     * @param packed True for the packed layout, false for one sample per texel
+     * @return True if the layout is set, false if it is already initialized or the width does not divide.
+     */
+    bool set_packed_layout(bool packed);
+
+    bool is_packed_layout() const {
+        return m_format == GL_RGBA && (m_internal_format == GL_RGBA32F || m_internal_format == GL_RGBA16F);
+    }
+
+    // Number of samples of a row held by each texel
+    GLuint get_samples_per_texel() const { return is_packed_layout() ? PACKED_SAMPLES : 1; }
+
+    /**
+     * @brief Store the samples as 16-bit floats (GL_R16F, or GL_RGBA16F when packed) before initialization
+     * 
+     * Halves the memory and bandwidth of the texture for about 11 bits of precision. The data is
+     * still set and read back as 32-bit floats. An INPUT texture can also change it once initialized,
+     * which allocates the texture again with its value. GLES 3.0 can only render into 16-bit floats with
+     * EXT_color_buffer_half_float or EXT_color_buffer_float, so without them the texture keeps its
+     * 32-bit storage with a warning. Without a current context the check is left to initialization.
+     * 
+     * @param half_float True for 16-bit storage, false for 32-bit
+     * @return True if the storage is set or kept at 32-bit, false if it is an initialized output or not a float audio texture.
+     */
+    bool set_half_float(bool half_float);
+
+    bool is_half_float() const { return m_internal_format == GL_R16F || m_internal_format == GL_RGBA16F; }
+
+    /**
+     * @brief Check if the current context can render into 16-bit float textures
+     * 
+     * @return True with EXT_color_buffer_half_float or EXT_color_buffer_float, or without a current context.
+     */
+    static bool half_float_renderable();
+
     const void * const get_value() const override;
 
     void clear_value() override;
 
     GLuint get_color_attachment() const { return m_color_attachment; }
 
+    /**
+     * @brief Set the number of blocks of readback latency for an OUTPUT parameter
+     * 
+     * With a latency of 0 (default) get_value() reads the texture back synchronously.
+     * With a latency of N, get_value() queues an asynchronous readback into a ring of
+     * N + 1 pixel pack buffers and returns the data that was queued N calls earlier.
+     * Until the ring is primed, the returned data is all zeros.
+     * 
+     * @param blocks The number of blocks of latency
+     * @return True if the latency is successfully set, false otherwise.
+     */
+    bool set_readback_latency(const unsigned int blocks);
+
+    unsigned int get_readback_latency() const { return m_readback_latency; }
+
+    /**
+     * @brief Check if the next get_value() can complete without waiting on the GPU
+     * 
+     * @return True if the oldest pending readback has completed, false otherwise.
+     */
+    bool is_readback_ready() const;
+
 private:
 
     bool initialize(GLuint frame_buffer=0, AudioShaderProgram * shader_program=nullptr) override;
 
     void render() override;
 
+    // The sampler unit is program state, so set it again after another stage used the program
+    void reset_program_state() override {
+        m_sampler_unit_set = false;
+    }
+
+    bool relink_program(AudioShaderProgram * shader_program, const std::string & uniform_name) override;
+
     bool bind() override;
 
     bool unbind() override;
 
     std::unique_ptr<ParamData> create_param_data() override;
 
+    bool initialize_readback_ring();
+
+    // Falls back to 32-bit storage if a framebuffer cannot render into the 16-bit texture
+    bool check_half_float_attachment();
+
+    void delete_readback_ring();
+
+    void reset_readback_ring() const;
+
     GLuint m_texture;
-    GLuint m_PBO;
+
+    // Sampler uniform, resolved once per shader program in initialize()
+    GLint m_sampler_location = -1;
+    bool m_sampler_unit_set = false;
+
+    // Regions of the texture set since the last upload
+    struct DirtyRegion {
+        GLuint x_offset;
+        GLuint y_offset;
+        GLuint width;
+        GLuint height;
+    };
+    static constexpr unsigned int MAX_DIRTY_REGIONS = 64; // Above this a full upload is cheaper
+    std::vector<DirtyRegion> m_dirty_regions;
+
+    // Asynchronous readback ring (OUTPUT only)
+    unsigned int m_readback_latency = 0;
+    std::vector<GLuint> m_PBOs;
+    mutable std::vector<GLsync> m_readback_fences;
+    mutable unsigned int m_readback_index = 0;
+    mutable unsigned int m_readback_queued = 0;
+
+    // GL_RED is not a readback format of a 16-bit float attachment, so one is read as RGBA floats
+    bool m_readback_rgba = false;
+    mutable std::vector<float> m_readback_texels;
 
     const GLuint m_filter_type;
-    const GLuint m_parameter_width;
-    const GLuint m_parameter_height;
+    GLuint m_parameter_width;
+    GLuint m_parameter_height;
     const GLuint m_active_texture;
     const GLuint m_color_attachment;
     const GLint m_datatype;
-    const GLuint m_format;
-    const GLuint m_internal_format;
+    GLuint m_format;
+    GLuint m_internal_format;
 
     static const float FLAT_COLOR[4];
 };
@@ -15,14 +15,18 @@ protected:
     ~AudioUniformParameter() = default;
 
 private:
-    bool initialize(GLuint frame_buffer=0, AudioShaderProgram * shader_program=nullptr) override {
-        m_framebuffer_linked = frame_buffer;
-        m_shader_program_linked = shader_program;
-        return true;
-    }
+    bool initialize(GLuint frame_buffer=0, AudioShaderProgram * shader_program=nullptr) override;
 
     void render() override;
 
+    // Uniform values are program state, so upload again after another stage used the program
+    void reset_program_state() override {
+        m_initialized = false;
+        m_update_param = true;
+    }
+
+    bool relink_program(AudioShaderProgram * shader_program, const std::string & uniform_name) override;
+
     bool bind() override {
         return true;
     }
@@ -34,6 +38,7 @@ private:
     virtual void set_uniform(GLint location) = 0;
 
     bool m_initialized = false;
+    GLint m_location = -1; // Resolved once per shader program in initialize()
 };
 
 class AudioIntParameter : public AudioUniformParameter {
@@ -6,6 +6,7 @@
 #include "audio_render_stage_plugins/audio_render_stage_history.h"
 #include "audio_core/audio_tape.h"
 #include "audio_core/audio_control.h"
+#include "utilities/audio_fft_convolver.h"
 
 class AudioEffectRenderStage : public AudioRenderStage {
 public:
@@ -27,6 +28,9 @@ public:
         AudioRenderStage(stage_name, frames_per_buffer, sample_rate, num_channels, fragment_shader_path, frag_shader_imports) {
     }
 
+    // Effects only transform their stream
+    bool is_silent_without_input() const override { return true; };
+
     ~AudioEffectRenderStage() {};
 };
 
@@ -74,15 +78,34 @@ public:
 
     ~AudioEchoEffectRenderStage() {};
 
+    // Keep the echo history on the GPU instead of reading the output back into the tape every block
+    void set_gpu_history_enabled(bool enabled) { m_history2->set_gpu_ring_enabled(enabled); };
+    bool is_gpu_history_enabled() const { return m_history2->is_gpu_ring_enabled(); };
+
+    // The echo reads its own previous output, so blocks must be rendered one at a time
+    bool supports_batching() const override { return false; };
+
+    bool supports_fusion() const override { return false; };
+
+    // The echoes feed back through the history until they decay below SILENCE_THRESHOLD
+    unsigned int get_tail_blocks() const override;
+
 private:
     static constexpr float HISTORY_WINDOW_SIZE_SECONDS = 2.0f;
+    static constexpr float SILENCE_THRESHOLD = 0.001f; // -60 dB
 
     void render(const unsigned int time) override;
+    void resolve_parameters() override;
 
     bool disconnect_render_stage(AudioRenderStage * render_stage) override;
 
     std::unique_ptr<AudioRenderStageHistory2> m_history2;
     std::shared_ptr<AudioTape> m_tape;
+
+    // Echo parameters, resolved for the tail length. Null once removed
+    AudioParameter * m_num_echos_param = nullptr;
+    AudioParameter * m_delay_param = nullptr;
+    AudioParameter * m_decay_param = nullptr;
 };
 
 class AudioFrequencyFilterEffectRenderStage : public AudioEffectRenderStage {
@@ -105,7 +128,10 @@ public:
 
     void set_low_pass(const float low_pass) { m_low_pass = low_pass; m_b_coefficients_dirty = true; };
     void set_high_pass(const float high_pass) { m_high_pass = high_pass; m_b_coefficients_dirty = true; };
-    void set_filter_follower(const float filter_follower) { m_filter_follower = filter_follower; };
+    // The follower moves the cutoffs by filter_follower times the mean absolute value of each block, in the
+    // direct form and with FFT convolution alike. The direct form renders the amplitude on the GPU in a one
+    // texel pass before the filter, so following it reads nothing back, also with the GPU history
+    void set_filter_follower(const float filter_follower) { m_filter_follower = filter_follower; m_b_coefficients_dirty = true; };
     void set_resonance(const float resonance) { m_resonance = resonance; m_b_coefficients_dirty = true; };
 
     const float get_low_pass() { return m_low_pass; };
@@ -116,12 +142,45 @@ public:
     // Force coefficient update (useful when switching to this stage)
     void force_coefficient_update() { m_b_coefficients_dirty = true; };
 
-    ~AudioFrequencyFilterEffectRenderStage() {};
+    // Keep the filter history on the GPU instead of reading the input back into the tape every block
+    void set_gpu_history_enabled(bool enabled) { m_history2->set_gpu_ring_enabled(enabled); };
+    bool is_gpu_history_enabled() const { return m_history2->is_gpu_ring_enabled(); };
+
+    /**
+     * @brief Filter with a CPU convolver instead of the direct form in the shader, off by default
+     * 
+     * The convolution runs on the CPU, not on the GPU: every block the input is read back with a
+     * synchronous glReadPixels, which stalls until the GPU has rendered it, convolved with partitioned
+     * FFTs and uploaded again as a texture for the shader to output. The spectra of the filter are only
+     * recomputed when the coefficients change. The arithmetic drops from O(buffer * num_taps) to
+     * O(buffer log buffer + num_taps) per block, so it only pays off when the taps cost more than the
+     * readback and upload, i.e. for long filters. Measure with the render stage bench before enabling it.
+     * 
+     * @param enabled True for the CPU convolver, false for the direct form in the shader
+     */
+    void set_fft_convolution_enabled(const bool enabled);
+    bool is_fft_convolution_enabled() const { return m_fft_convolution_enabled; };
+
+    // The filter taps reach into previous blocks through the history, which is updated once per render
+    bool supports_batching() const override { return false; };
+
+    bool supports_fusion() const override { return false; };
+
+    // The taps reach num_taps samples into the recorded input
+    unsigned int get_tail_blocks() const override;
+
+    // Designs in the coefficient bank, for block amplitudes evenly spaced from 0 to 1
+    static constexpr unsigned int COEFF_BANK_SIZE = 16;
+
+    ~AudioFrequencyFilterEffectRenderStage();
 
 private:
     static const std::vector<float> calculate_firwin_b_coefficients(const float low_pass, const float high_pass, const unsigned int num_taps, const float resonance);
-    void update_b_coefficients(const float current_amplitude = 0.0);
+    void update_b_coefficients();
+    // Renders the mean absolute value of the stream block into the block amplitude texture
+    void render_block_amplitude();
     void render(const unsigned int time) override;
+    void resolve_parameters() override;
     bool disconnect_render_stage(AudioRenderStage * render_stage) override;
 
     std::unique_ptr<AudioRenderStageHistory2> m_history2;
@@ -132,7 +191,24 @@ private:
     float m_resonance;
     const float NYQUIST;
 
+    // Filter parameters, resolved so coefficient updates do not look them up by name. Null once removed
+    AudioParameter * m_num_taps_param = nullptr;
+    AudioTexture2DParameter * m_b_coeff_param = nullptr;
+    AudioParameter * m_coeff_bank_rows_param = nullptr;
+    AudioTexture2DParameter * m_block_amplitude_param = nullptr;
+
     bool m_b_coefficients_dirty = true;
+
+    // Amplitude pass of the follower, created with the first block it follows
+    std::unique_ptr<AudioShaderProgram> m_amplitude_program;
+    GLuint m_amplitude_framebuffer = 0;
+
+    // CPU convolver, its output is uploaded every block for the shader to pass through
+    bool m_fft_convolution_enabled = false;
+    AudioFFTConvolver m_fft_convolver;
+    std::vector<float> m_convolved_data;
+    AudioParameter * m_fft_convolution_param = nullptr;
+    AudioTexture2DParameter * m_convolved_audio_param = nullptr;
 };
 
 #endif // AUDIO_EFFECT_RENDER_STAGE_H
\ No newline at end of file
@@ -67,6 +67,15 @@ public:
      */
     ~AudioSingleShaderFileGeneratorRenderStage() {}
 
+    // The tape window is uploaded once per render
+    bool supports_batching() const override {
+        return false;
+    }
+
+    bool supports_fusion() const override {
+        return false;
+    }
+
 protected:
     void render(const unsigned int time) override;
 
@@ -109,6 +118,15 @@ public:
      */
     ~AudioFileGeneratorRenderStage() {}
 
+    // The tape window is uploaded once per render
+    bool supports_batching() const override {
+        return false;
+    }
+
+    bool supports_fusion() const override {
+        return false;
+    }
+
 protected:
     void render(const unsigned int time) override;
 
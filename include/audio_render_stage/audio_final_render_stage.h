@@ -46,10 +46,44 @@ public:
      */
     ~AudioFinalRenderStage() {}
 
+    // Interleaved output of the last render, get_blocks_per_render() blocks back to back
     const std::vector<float> & get_output_buffer_data() const { return m_output_buffer_data; }
-    
+
+    // Output of the last render per channel, get_blocks_per_render() blocks back to back
+
     const std::vector<std::vector<float>> & get_output_data_channel_seperated() const { return m_output_data_channel_seperated; }
 
+    /**
+     * @brief Set the number of blocks of latency used when reading the output back from the GPU
+     * 
+     * A latency of 0 reads the output back synchronously. Higher values pipeline the readback
+     * through pixel pack buffers so the CPU does not stall on the block just rendered.
+     * 
+     * @param blocks The number of blocks of latency
+     * @return True if the latency is successfully set, false otherwise.
+     */
+    bool set_readback_latency(const unsigned int blocks);
+
+    /**
+     * @brief Write the outputs in the packed layout, four samples per RGBA texel
+     * 
+     * The final draw runs a quarter of the fragments and the output is read back as GL_RGBA,
+     * the float readback format every GLES 3 driver supports. The data returned is unchanged.
+     * Must be called before initialization, with frames per buffer a multiple of four.
+     * 
+     * @param packed True to pack the outputs, false for one sample per texel
+     * @return True if the layout is set, false otherwise.
+     */
+    bool set_packed_output(const bool packed);
+
+    bool is_output_packed() const { return m_samples_per_texel > 1; }
+
+    // The output is read back after every render
+    bool supports_fusion() const override { return false; }
+
+    // The final mix keeps full precision
+    bool supports_half_float_streams() const override { return false; }
+
 private:
     /**
      * @brief Overrides the render_render_stage function to provide the rendering functionality.
@@ -58,9 +92,14 @@ private:
      */
     void render(unsigned int time) override;
 
+    void resolve_parameters() override;
+
     std::vector<float> m_output_buffer_data;
 
     std::vector<std::vector<float>> m_output_data_channel_seperated;
+
+    // Interleaved output, resolved so the per-block readback does not look it up by name. Null once removed
+    AudioTexture2DParameter * m_final_output_audio_texture = nullptr;
 };
 
 #endif
\ No newline at end of file
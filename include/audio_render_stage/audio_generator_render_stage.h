@@ -130,6 +130,12 @@ class AudioGeneratorRenderStage : public AudioRenderStage {
         bool connect_render_stage(AudioRenderStage * next_stage) override;
         bool disconnect_render_stage(AudioRenderStage * next_stage) override;
 
+        // The note parameters are synced in every render
+        bool supports_fusion() const override { return false; }
+
+        // Without notes, released ones included, the generator only adds its stream
+        bool is_silent_without_input() const override { return m_note_state.m_active_notes == 0; }
+
         // Helper class for encapsulating note state and parameter sync
         class NoteState {
         public:
@@ -168,6 +174,8 @@ class AudioGeneratorRenderStage : public AudioRenderStage {
     protected:
         void render(const unsigned int time) override;
 
+        void resolve_parameters() override;
+
     private:
         void delete_note(const unsigned int index);
 
@@ -175,6 +183,14 @@ class AudioGeneratorRenderStage : public AudioRenderStage {
 
         NoteState m_note_state = NoteState(MAX_NOTES_PLAYED_AT_ONCE);
 
+        // Note parameters, resolved so note updates do not look them up by name. Null once removed.
+        AudioParameter * m_play_positions_param = nullptr;
+        AudioParameter * m_stop_positions_param = nullptr;
+        AudioParameter * m_tones_param = nullptr;
+        AudioParameter * m_gains_param = nullptr;
+        AudioParameter * m_active_notes_param = nullptr;
+        AudioParameter * m_release_time_param = nullptr;
+
         std::unordered_map<int, int> m_delete_at_time;
     };
 
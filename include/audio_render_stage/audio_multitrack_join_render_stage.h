@@ -28,6 +28,9 @@ public:
 
     ~AudioMultitrackJoinRenderStage() {};
 
+    // The join only sums its streams
+    bool is_silent_without_input() const override { return true; };
+
     static const std::vector<std::string> default_frag_shader_imports;
 
 private:
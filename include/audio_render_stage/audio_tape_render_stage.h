@@ -32,6 +32,15 @@ public:
     bool is_recording() {
         return m_recording;
     }
+
+    // Records one block per render
+    bool supports_batching() const override {
+        return false;
+    }
+
+    bool supports_fusion() const override {
+        return false;
+    }
     std::weak_ptr<AudioTape> get_tape() {
         return m_tape_new;
     }
@@ -78,6 +87,15 @@ public:
     
     const unsigned int get_current_tape_position(const unsigned int time);
 
+    // The tape window is uploaded once per render
+    bool supports_batching() const override {
+        return false;
+    }
+
+    bool supports_fusion() const override {
+        return false;
+    }
+
 private:
     void render(const unsigned int time) override;
 
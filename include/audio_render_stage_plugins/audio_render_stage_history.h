@@ -55,6 +55,8 @@ public:
                              const float history_buffer_size_seconds = 2.0f, // History buffer size in seconds of data stored in texture
                              const std::string& plugin_name = ""); // Plugin name for parameterizing variable/function names (empty = default)
 
+    ~AudioRenderStageHistory2();
+
     // Plugin interface implementation
     std::string get_plugin_name() const override;
     std::vector<std::string> get_fragment_shader_imports() const override;
@@ -120,6 +122,19 @@ public:
     void update_audio_history_texture();
     void update_audio_history_texture(const unsigned int time);
 
+    // GPU ring history - the history texture ring is written on the GPU from a render stage
+    // texture, instead of being uploaded from the tape
+    void set_gpu_ring_enabled(bool enabled);
+    bool is_gpu_ring_enabled() const { return m_gpu_ring_enabled; }
+
+    // Copy one block from a render stage texture (frames_per_buffer x num_channels) into the ring
+    // at the given tape position (in samples). Only valid when the GPU ring is enabled. The ring
+    // takes the precision of the source, so a half float stream restarts it as a half float ring.
+    bool record_block_to_gpu_ring(const AudioTexture2DParameter * source, const unsigned int record_position);
+
+    // Forget all samples held in the GPU ring
+    void clear_gpu_ring();
+
     std::string get_audio_history_texture_name() { 
         return m_plugin_name.empty() ? "tape_history_texture" : ("tape_history_texture_" + m_plugin_name);
     }
@@ -132,6 +147,7 @@ private:
     AudioParameter * m_tape_window_offset_samples; // Will communicate the current offset of the audio history texture in the window (in samples) from the start of the window
     AudioParameter * m_tape_stopped; // Flag indicating if tape is stopped (1 = stopped, 0 = playing)
     AudioParameter * m_tape_loop; // Flag indicating if tape should loop (1 = loop enabled, 0 = loop disabled, default = 0)
+    AudioParameter * m_tape_ring_write_position; // End of the samples held in the history texture ring
 
     std::weak_ptr<AudioTape> m_tape; // Weak pointer to tape (non-owning)
 
@@ -155,6 +171,22 @@ private:
     // using the speed that was used for the previous frame's rendering
     std::optional<int> m_pending_speed_samples_per_buffer;
 
+    // GPU ring state, samples in [m_ring_start_position, m_ring_write_position) have been recorded
+    bool m_gpu_ring_enabled = false;
+    unsigned int m_ring_start_position = 0;
+    unsigned int m_ring_write_position = 0;
+    GLuint m_ring_read_framebuffer = 0;
+
+    void update_gpu_ring_parameters();
+
+    // Tape window state at the last upload, used to only upload the samples that changed
+    bool m_window_uploaded = false;
+    unsigned int m_uploaded_window_offset = 0;
+    unsigned long m_uploaded_tape_revision = 0;
+
+    // Upload the tape samples in [start, end) into their ring positions of the history texture
+    void upload_window_range(const AudioTape & tape, unsigned int start, unsigned int end);
+
     void set_window_offset_samples(const unsigned int window_offset_samples);
 
     const unsigned int get_window_offset_samples_for_tape_data() const;
@@ -5,9 +5,10 @@
 #include <vector>
 #include <string>
 #include <GLES3/gl3.h>
-#include <cstdio>
 #include <iostream>
 
+#include "utilities/shader_registry.h"
+
 // Forward declaration
 class AudioParameter;
 
@@ -76,66 +77,26 @@ public:
 
     /**
      * @brief Get processed fragment shader source for a given import path
-     * This method reads the shader file and applies plugin-specific replacements
+     * This method gets the shader source and applies plugin-specific replacements
      * Default implementation automatically replaces {PLUGIN_SUFFIX} placeholders
      * @param import_path Path to the shader file
      * @return Processed shader source string with plugin-specific replacements applied
      */
     virtual std::string get_processed_fragment_shader_source(const std::string& import_path) const {
-        // Read the shader file
-        FILE* file = fopen(import_path.c_str(), "r");
-        if (!file) {
-            std::cerr << "Error: Failed to open file " << import_path << std::endl;
-            return "";
-        }
-        
-        fseek(file, 0, SEEK_END);
-        long length = ftell(file);
-        fseek(file, 0, SEEK_SET);
-        
-        char* source = new char[length + 1];
-        fread(source, 1, length, file);
-        source[length] = '\0';
-        
-        fclose(file);
-        
-        std::string result(source);
-        delete[] source;
-        
         // Apply plugin placeholder replacement automatically
-        return replace_plugin_placeholder(result, get_plugin_name());
+        return replace_plugin_placeholder(ShaderRegistry::get_source(import_path), get_plugin_name());
     }
 
     /**
      * @brief Get processed vertex shader source for a given import path
-     * This method reads the shader file and applies plugin-specific replacements
+     * This method gets the shader source and applies plugin-specific replacements
      * Default implementation automatically replaces {PLUGIN_SUFFIX} placeholders
      * @param import_path Path to the shader file
      * @return Processed shader source string with plugin-specific replacements applied
      */
     virtual std::string get_processed_vertex_shader_source(const std::string& import_path) const {
-        // Read the shader file
-        FILE* file = fopen(import_path.c_str(), "r");
-        if (!file) {
-            std::cerr << "Error: Failed to open file " << import_path << std::endl;
-            return "";
-        }
-        
-        fseek(file, 0, SEEK_END);
-        long length = ftell(file);
-        fseek(file, 0, SEEK_SET);
-        
-        char* source = new char[length + 1];
-        fread(source, 1, length, file);
-        source[length] = '\0';
-        
-        fclose(file);
-        
-        std::string result(source);
-        delete[] source;
-        
         // Apply plugin placeholder replacement automatically
-        return replace_plugin_placeholder(result, get_plugin_name());
+        return replace_plugin_placeholder(ShaderRegistry::get_source(import_path), get_plugin_name());
     }
 
     /**
@@ -4,6 +4,8 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <functional>
 
 #include "audio_core/audio_render_graph.h"
 #include "audio_render_stage/audio_effect_render_stage.h"
@@ -21,14 +23,23 @@ public:
     void change_effect(const std::string & effect_name);
     void change_voice(const std::string & voice_name);
 
+    // Modules created so far; the names list every module that can be selected
     const std::unordered_map<std::string, std::shared_ptr<AudioEffectModule>> & get_effects() const;
     const std::vector<std::string> get_effect_names() const;
     const std::unordered_map<std::string, std::shared_ptr<AudioVoiceModule>> & get_voices() const;
     const std::vector<std::string> get_generator_names() const;
 
+    // Queues the modules not created yet to be built one at a time in the renderer's idle time,
+    // so a later switch does not have to build them
+    void prewarm_modules();
+
 private:
     void initialize_modules();
 
+    // Returns the module, creating and initializing it on first use. Returns nullptr for unknown names.
+    std::shared_ptr<AudioEffectModule> get_effect_module(const std::string & effect_name);
+    std::shared_ptr<AudioVoiceModule> get_voice_module(const std::string & voice_name);
+
     const unsigned int m_buffer_size;
     const unsigned int m_sample_rate;
     const unsigned int m_num_channels;
@@ -41,9 +52,19 @@ private:
 
     std::shared_ptr<AudioEffectModule> m_current_effect;
     std::shared_ptr<AudioVoiceModule> m_current_voice;
+    // Modules created so far
     std::unordered_map<std::string, std::shared_ptr<AudioEffectModule>> m_effect_modules;
     std::unordered_map<std::string, std::shared_ptr<AudioVoiceModule>> m_voice_modules;
 
+    // Available modules, in menu order, and how to build them
+    std::vector<std::string> m_effect_names;
+    std::vector<std::string> m_voice_names;
+    std::unordered_map<std::string, std::function<std::shared_ptr<AudioEffectModule>()>> m_effect_factories;
+    std::unordered_map<std::string, std::function<std::shared_ptr<AudioVoiceModule>()>> m_voice_factories;
+
+    // Expires with the track, so queued prewarm tasks can tell it is gone
+    std::shared_ptr<bool> m_alive = std::make_shared<bool>(true);
+
 };
 
 #endif // AUDIO_TRACK_H
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef AUDIO_COMMAND_QUEUE_H
+#define AUDIO_COMMAND_QUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @class AudioCommandQueue
+ * @brief Lock-free single-producer/single-consumer queue of commands for the audio render thread.
+ *
+ * The control thread posts commands with push() and the render thread runs them between blocks
+ * with execute_all(), so parameters are only ever touched by the thread that renders them.
+ * Only one thread may push and only one thread may execute at a time.
+ *
+ * A command is built and destroyed on the producer side: execute_all() only runs it, and the next
+ * push() releases the commands that ran. So the consumer never allocates or frees memory for them.
+ */
+class AudioCommandQueue {
+public:
+    using Command = std::function<void()>;
+
+    /**
+     * @brief Constructs an AudioCommandQueue object.
+     *
+     * @param capacity The number of commands that can be pending at once.
+     */
+    explicit AudioCommandQueue(const unsigned int capacity);
+
+    AudioCommandQueue(AudioCommandQueue const&) = delete;
+    void operator=(AudioCommandQueue const&) = delete;
+
+    /**
+     * @brief Queues a command, after releasing the commands that already ran. Producer side.
+     *
+     * @param command The command to run on the consumer thread.
+     * @return True if the command was queued, false if the queue is full (the command is dropped).
+     */
+    bool push(Command command);
+
+    /**
+     * @brief Runs every pending command in order, without destroying them. Consumer side.
+     *
+     * @return The number of commands run.
+     */
+    unsigned int execute_all();
+
+    /**
+     * @brief Destroys the commands that already ran. Producer side.
+     */
+    void release_executed();
+
+    // Number of pending commands
+    unsigned int size() const;
+
+    unsigned int get_capacity() const {
+        return static_cast<unsigned int>(m_commands.size());
+    }
+
+    // Number of commands dropped because the queue was full
+    unsigned int get_dropped_count() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<Command> m_commands;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_write_index{0};
+    std::atomic<unsigned int> m_dropped{0};
+    size_t m_release_index = 0; // Commands before it are destroyed, only the producer touches it
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_read_index{0};
+};
+
+#endif // AUDIO_COMMAND_QUEUE_H
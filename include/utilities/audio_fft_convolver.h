@@ -0,0 +1,111 @@
+#pragma once
+#ifndef AUDIO_FFT_CONVOLVER_H
+#define AUDIO_FFT_CONVOLVER_H
+
+#include <complex>
+#include <vector>
+
+/**
+ * @class AudioFFTConvolver
+ * @brief Uniformly partitioned FFT convolution of blocks of audio with a long impulse response.
+ *
+ * The impulse response is split into partitions of one block and each partition is kept as a
+ * spectrum, recomputed only when set_impulse_response() is called. Every block is transformed once
+ * into a frequency-domain delay line of the last num_partitions input spectra, multiplied with the
+ * partition spectra and transformed back with overlap-save. A block costs two FFTs of twice the
+ * block size (rounded up to a power of two) and one multiply-accumulate per partition and bin,
+ * instead of block size * num_taps multiply-adds for the direct form.
+ *
+ * Blocks are channel-major: block_size samples of the first channel, then of the next.
+ */
+class AudioFFTConvolver {
+public:
+    /**
+     * @brief Constructs an AudioFFTConvolver object.
+     *
+     * @param block_size The number of samples per channel in each block.
+     * @param num_channels The number of channels, each convolved with the same impulse response.
+     */
+    AudioFFTConvolver(const unsigned int block_size, const unsigned int num_channels);
+
+    AudioFFTConvolver(AudioFFTConvolver const&) = delete;
+    void operator=(AudioFFTConvolver const&) = delete;
+
+    /**
+     * @brief Transforms a new impulse response into its partition spectra
+     *
+     * The input history is kept, so the filter can change between blocks without a gap. When the
+     * number of partitions grows, the new partitions start without history.
+     *
+     * @param coefficients The impulse response.
+     * @param num_taps The number of coefficients.
+     */
+    void set_impulse_response(const float * coefficients, const unsigned int num_taps);
+
+    /**
+     * @brief Transforms a bank of impulse responses of the same length, that process() can mix per block
+     *
+     * @param coefficients The impulse responses, the first tap of each one stride after the previous.
+     * @param num_taps The number of coefficients of each response.
+     * @param num_responses The number of responses.
+     * @param stride The distance between the first taps of two responses.
+     */
+    void set_impulse_responses(const float * coefficients, const unsigned int num_taps,
+                               const unsigned int num_responses, const unsigned int stride);
+
+    /**
+     * @brief Convolves one block of every channel
+     *
+     * The block is filtered with the response of the bank at index response, mixed with the next one
+     * by weight. The convolution is linear in the response, so this equals filtering with the mixed
+     * coefficients, from the first partition to the last.
+     *
+     * @param input num_channels * block_size samples, channel-major.
+     * @param output num_channels * block_size samples, channel-major.
+     * @param new_block False to render the last block again with a different input, e.g. when the same
+     *                  frame is rendered twice, true to advance to the next block.
+     * @param response The response of the bank to filter with.
+     * @param weight The weight of the next response, from 0 to 1.
+     */
+    void process(const float * input, float * output, const bool new_block = true,
+                 const unsigned int response = 0, const float weight = 0.0f);
+
+    // Clears the input history, the impulse response is kept
+    void reset();
+
+    unsigned int get_block_size() const { return m_block_size; }
+
+    unsigned int get_fft_size() const { return m_fft_size; }
+
+    unsigned int get_num_partitions() const { return m_num_partitions; }
+
+    unsigned int get_num_responses() const { return static_cast<unsigned int>(m_partition_spectra.size()); }
+
+private:
+    // In-place radix-2 FFT of m_fft_size samples, the inverse is scaled by 1 / m_fft_size
+    void transform(std::vector<std::complex<float>> & data, const bool inverse) const;
+
+    const unsigned int m_block_size;
+    const unsigned int m_num_channels;
+    unsigned int m_fft_size;
+    unsigned int m_num_bins; // Bins of a real signal's spectrum, the rest are conjugates
+
+    // Twiddle factors and bit reversed indices of m_fft_size
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<unsigned int> m_bit_reversed;
+
+    // Partition spectra of every impulse response of the bank, m_num_bins each
+    unsigned int m_num_partitions = 0;
+    std::vector<std::vector<std::vector<std::complex<float>>>> m_partition_spectra;
+
+    // Per channel: the last m_fft_size input samples and a ring of the last m_num_partitions input spectra
+    std::vector<std::vector<float>> m_input_history;
+    std::vector<std::vector<std::vector<std::complex<float>>>> m_input_spectra;
+    unsigned int m_newest_spectrum = 0;
+
+    // Scratch buffers of m_fft_size
+    std::vector<std::complex<float>> m_fft_buffer;
+    std::vector<std::complex<float>> m_accumulator;
+};
+
+#endif // AUDIO_FFT_CONVOLVER_H
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef AUDIO_RING_BUFFER_H
+#define AUDIO_RING_BUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class AudioRingBuffer
+ * @brief Lock-free single-producer/single-consumer queue of fixed size audio blocks.
+ *
+ * The blocks live in one contiguous allocation. The producer fills the next free block in place
+ * with acquire_write()/commit() and the consumer reads the oldest block in place with
+ * acquire_read()/release(), so no block is copied by the ring itself. Only one thread may
+ * produce and only one thread may consume at a time.
+ *
+ * A full ring on write counts an overrun and an empty ring on read counts an underrun.
+ */
+class AudioRingBuffer {
+public:
+    /**
+     * @brief Constructs an AudioRingBuffer object.
+     *
+     * @param num_blocks The number of blocks the ring can hold.
+     * @param block_size The number of floats in each block.
+     */
+    AudioRingBuffer(const unsigned int num_blocks, const unsigned int block_size);
+
+    AudioRingBuffer(AudioRingBuffer const&) = delete;
+    void operator=(AudioRingBuffer const&) = delete;
+
+// -------------Producer----------------
+    /**
+     * @brief Returns the next free block to write to, without publishing it.
+     *
+     * @return The block to fill, or nullptr if the ring is full (counted as an overrun).
+     */
+    float * acquire_write();
+
+    /**
+     * @brief Publishes the block returned by the last successful acquire_write() to the consumer.
+     */
+    void commit();
+
+    /**
+     * @brief Copies a block into the ring.
+     *
+     * @param block The block_size floats to copy.
+     * @return True if the block was queued, false if the ring is full.
+     */
+    bool push(const float * block);
+
+// -------------Consumer----------------
+    /**
+     * @brief Returns the oldest queued block, without removing it.
+     *
+     * @return The block to read, or nullptr if the ring is empty (counted as an underrun).
+     */
+    const float * acquire_read();
+
+    /**
+     * @brief Hands the block returned by the last successful acquire_read() back to the producer.
+     */
+    void release();
+
+    /**
+     * @brief Copies the oldest queued block out of the ring.
+     *
+     * @param block The destination for block_size floats.
+     * @return True if a block was read, false if the ring is empty.
+     */
+    bool pop(float * block);
+
+    /**
+     * @brief Drops every queued block. Must be called from the consumer side.
+     */
+    void clear();
+
+// -------------Getters----------------
+    // Number of blocks ready to be read
+    unsigned int read_available() const;
+
+    // Number of blocks that can be written before the ring is full
+    unsigned int write_available() const;
+
+    unsigned int get_num_blocks() const {
+        return m_num_blocks;
+    }
+
+    unsigned int get_block_size() const {
+        return m_block_size;
+    }
+
+    // Number of reads that found the ring empty
+    unsigned int get_underrun_count() const {
+        return m_underruns.load(std::memory_order_relaxed);
+    }
+
+    // Number of writes that found the ring full
+    unsigned int get_overrun_count() const {
+        return m_overruns.load(std::memory_order_relaxed);
+    }
+
+    void reset_counters() {
+        m_underruns.store(0, std::memory_order_relaxed);
+        m_overruns.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    float * block_at(const size_t index) {
+        return m_data.data() + (index % m_num_blocks) * m_block_size;
+    }
+
+    const unsigned int m_num_blocks;
+    const unsigned int m_block_size;
+    std::vector<float> m_data; // num_blocks * block_size floats
+
+    // The indices count blocks since construction and only wrap when addressing the data.
+    // Each side owns its index and counter, kept on separate cache lines to avoid false sharing.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_write_index{0};
+    std::atomic<unsigned int> m_overruns{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_read_index{0};
+    std::atomic<unsigned int> m_underruns{0};
+};
+
+#endif // AUDIO_RING_BUFFER_H
@@ -0,0 +1,177 @@
+#pragma once
+#ifndef AUDIO_STAGE_TIMER_H
+#define AUDIO_STAGE_TIMER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <GLES3/gl3.h>
+
+// Per-stage timing is compiled in unless the build defines AUDIO_STAGE_TIMING=0
+#ifndef AUDIO_STAGE_TIMING
+#define AUDIO_STAGE_TIMING 1
+#endif
+
+/**
+ * @class AudioStageTimer
+ * @brief Records how long one render stage spends in each phase of a block.
+ *
+ * The render thread opens a block with begin_block(), times phases with Scope and closes the block
+ * with end_block(), which publishes one sample to a fixed-size ring. Any thread can read the ring
+ * with get_stats() without locking: a sample being overwritten while it is read may mix fields of two
+ * blocks, which only blurs the statistics. GPU time is measured with GL_EXT_disjoint_timer_query
+ * when the context supports it and arrives a few blocks late, so it is reported per block but not
+ * aligned with the CPU phases of the same block.
+ *
+ * With AUDIO_STAGE_TIMING=0 every call is an empty inline function.
+ */
+class AudioStageTimer {
+public:
+    enum class Phase : unsigned int {
+        UPLOAD,     // Parameter uploads
+        DRAW,       // Draw call submission
+        READBACK,   // Texture readback to the CPU
+        RECORD,     // Recording to a tape
+        GPU,        // GPU execution of the draw
+        COUNT
+    };
+
+    static constexpr std::size_t NUM_PHASES = static_cast<std::size_t>(Phase::COUNT);
+    static constexpr std::size_t RING_SIZE = 512;
+
+    /**
+     * @struct PhaseStats
+     * @brief Statistics of one phase over the samples in the ring, in microseconds.
+     */
+    struct PhaseStats {
+        float min = 0.0f;
+        float mean = 0.0f;
+        float p99 = 0.0f;
+    };
+
+    /**
+     * @struct Stats
+     * @brief Statistics of a stage over the samples in the ring.
+     */
+    struct Stats {
+        unsigned int num_samples = 0;
+        std::array<PhaseStats, NUM_PHASES> phases;
+        PhaseStats cpu_total;
+
+        const PhaseStats & operator[](Phase phase) const {
+            return phases[static_cast<std::size_t>(phase)];
+        }
+    };
+
+#if AUDIO_STAGE_TIMING
+    /**
+     * @class Scope
+     * @brief Adds the time until the end of the scope to a phase of the current block.
+     */
+    class Scope {
+    public:
+        Scope(AudioStageTimer & timer, Phase phase)
+            : m_timer(timer), m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+        ~Scope() {
+            m_timer.add(m_phase, std::chrono::steady_clock::now() - m_start);
+        }
+
+        Scope(Scope const&) = delete;
+        void operator=(Scope const&) = delete;
+
+    private:
+        AudioStageTimer & m_timer;
+        const Phase m_phase;
+        const std::chrono::steady_clock::time_point m_start;
+    };
+
+    AudioStageTimer() = default;
+    ~AudioStageTimer();
+
+    AudioStageTimer(AudioStageTimer const&) = delete;
+    void operator=(AudioStageTimer const&) = delete;
+
+    /**
+     * @brief Starts a block. Render thread only.
+     */
+    void begin_block() {
+        m_current.fill(0.0f);
+    }
+
+    /**
+     * @brief Adds time to a phase of the current block. Render thread only.
+     */
+    void add(Phase phase, std::chrono::steady_clock::duration duration) {
+        m_current[static_cast<std::size_t>(phase)] +=
+            std::chrono::duration<float, std::micro>(duration).count();
+    }
+
+    /**
+     * @brief Publishes the current block to the ring. Render thread only.
+     */
+    void end_block();
+
+    /**
+     * @brief Starts measuring the GPU time of the following GL commands. Render thread only.
+     *
+     * Does nothing if the current context has no GL_EXT_disjoint_timer_query.
+     */
+    void begin_gpu();
+
+    /**
+     * @brief Stops measuring the GPU time started by begin_gpu(). Render thread only.
+     */
+    void end_gpu();
+
+    /**
+     * @brief Computes the statistics of the samples in the ring. Any thread.
+     */
+    Stats get_stats() const;
+
+    /**
+     * @brief Gets the number of blocks published so far. Any thread.
+     */
+    std::size_t get_block_count() const {
+        return m_write_index.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Whether the current context supports GPU timing. Needs a current context.
+     */
+    static bool gpu_timing_supported();
+
+private:
+    static constexpr std::size_t NUM_GPU_QUERIES = 4;
+
+    void collect_gpu_results();
+
+    std::array<float, NUM_PHASES> m_current = {};
+    std::array<std::array<std::atomic<float>, NUM_PHASES>, RING_SIZE> m_samples = {};
+    std::atomic<std::size_t> m_write_index{0};
+
+    // Queries are polled in the order they were issued, one result per finished draw
+    std::array<GLuint, NUM_GPU_QUERIES> m_gpu_queries = {};
+    std::size_t m_gpu_issued = 0;
+    std::size_t m_gpu_collected = 0;
+    bool m_gpu_initialized = false;
+    bool m_gpu_active = false;
+    float m_gpu_latest = 0.0f;
+#else
+    class Scope {
+    public:
+        Scope(AudioStageTimer &, Phase) {}
+    };
+
+    void begin_block() {}
+    void add(Phase, std::chrono::steady_clock::duration) {}
+    void end_block() {}
+    void begin_gpu() {}
+    void end_gpu() {}
+    Stats get_stats() const { return Stats(); }
+    std::size_t get_block_count() const { return 0; }
+    static bool gpu_timing_supported() { return false; }
+#endif
+};
+
+#endif // AUDIO_STAGE_TIMER_H
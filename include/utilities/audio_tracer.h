@@ -0,0 +1,113 @@
+#pragma once
+#ifndef AUDIO_TRACER_H
+#define AUDIO_TRACER_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#define AUDIO_TRACE_CONCAT_IMPL(a, b) a##b
+#define AUDIO_TRACE_CONCAT(a, b) AUDIO_TRACE_CONCAT_IMPL(a, b)
+
+// Traces the rest of the enclosing scope. The name must outlive the scope, the category must be a literal.
+#define AUDIO_TRACE_SCOPE(name, category) \
+    AudioTracer::Scope AUDIO_TRACE_CONCAT(audio_trace_scope_, __LINE__)(name, category)
+
+/**
+ * @class AudioTracer
+ * @brief Optional tracer that writes Chrome trace-event JSON, viewable in chrome://tracing or Perfetto.
+ *
+ * Every thread records its events into its own lock-free ring and a background thread writes them
+ * to the trace file, so tracing never blocks the audio or UI threads on I/O. Events carry the thread
+ * and the audio block being rendered when they happened. While the tracer is stopped, a traced scope
+ * costs one relaxed atomic load. Events are dropped, and counted, when a thread outruns the writer.
+ */
+class AudioTracer {
+public:
+    /**
+     * @class Scope
+     * @brief Records a complete event covering its lifetime.
+     */
+    class Scope {
+    public:
+        Scope(const char * name, const char * category) : m_name(name), m_category(category) {
+            if (is_enabled()) {
+                m_start = std::chrono::steady_clock::now();
+                m_active = true;
+            }
+        }
+        Scope(const std::string & name, const char * category) : Scope(name.c_str(), category) {}
+        ~Scope() {
+            if (m_active) {
+                complete(m_name, m_category, m_start, std::chrono::steady_clock::now());
+            }
+        }
+
+        Scope(Scope const&) = delete;
+        void operator=(Scope const&) = delete;
+
+    private:
+        const char * m_name;
+        const char * m_category;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_active = false;
+    };
+
+    /**
+     * @brief Starts tracing to a file.
+     *
+     * @param path The trace file to write, replaced if it exists.
+     * @return True if tracing started, false if the file cannot be opened or tracing already runs.
+     */
+    static bool start(const std::string & path);
+
+    /**
+     * @brief Starts tracing if the SHADER_DSP_TRACE environment variable names a trace file.
+     *
+     * @return True if tracing started.
+     */
+    static bool start_from_environment();
+
+    /**
+     * @brief Stops tracing and writes the remaining events. Does nothing if tracing is stopped.
+     */
+    static void stop();
+
+    static bool is_enabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Names the calling thread in the trace.
+     */
+    static void set_thread_name(const std::string & name);
+
+    /**
+     * @brief Sets the audio block attached to the events recorded from now on, by every thread.
+     */
+    static void set_block(const unsigned int block) {
+        s_block.store(block, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records an event that has a duration.
+     */
+    static void complete(const char * name, const char * category,
+                         std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    /**
+     * @brief Records an event without duration, e.g. a control change.
+     */
+    static void instant(const std::string & name, const char * category);
+
+    /**
+     * @brief Gets the number of events dropped because a thread's ring was full.
+     */
+    static unsigned int get_dropped_count();
+
+private:
+    static std::atomic<bool> s_enabled;
+    static std::atomic<unsigned int> s_block;
+};
+
+#endif // AUDIO_TRACER_H
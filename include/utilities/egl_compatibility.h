@@ -9,6 +9,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <unordered_map>
+#include <mutex>
 
 // EGL compatibility layer for OpenGL ES context creation
 class EGLCompatibility {
@@ -32,6 +33,21 @@ public:
     // is made current again.
     static void set_swap_interval(SDL_Window* window, int interval);
 
+    // Creates an offscreen EGL context backed by a small pbuffer surface, or by
+    // no surface at all where only EGL_KHR_surfaceless_context is available, so
+    // rendering can run without an SDL window, event loop or windowing system.
+    // Headless contexts live on their own display (a GPU device, then the
+    // EGL_MESA_platform_surfaceless platform, then the default display), so
+    // they never need an X server. The new context is made current on the
+    // calling thread. Safe to call from any thread.
+    static bool initialize_headless_context(EGLContext& out_context);
+
+    // Destroys a context created by initialize_headless_context.
+    static void cleanup_headless_context(EGLContext context);
+
+    // Makes a headless context (and its pbuffer surface) current on this thread.
+    static void make_headless_current(EGLContext context);
+
     static void global_cleanup();
 
 private:
@@ -47,7 +63,13 @@ private:
     // after every eglMakeCurrent call (some drivers reset it).
     static std::unordered_map<SDL_Window*, int> s_surfaceIntervals;
 
+    // Display and pbuffer surfaces (EGL_NO_SURFACE when surfaceless) of the headless contexts
+    static EGLDisplay s_headlessDisplay;
+    static std::unordered_map<EGLContext, EGLSurface> s_headlessSurfaces;
+    static std::mutex s_headlessMutex;
+
     static bool initialize_egl_display();
+    static bool initialize_headless_display();
     static bool choose_egl_config();
     static EGLSurface create_egl_surface(SDL_Window* window);
     static EGLContext create_egl_context(EGLSurface surface);
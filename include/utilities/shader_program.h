@@ -3,6 +3,9 @@
 #define AUDIO_SHADER_PROGRAM_H
 
 #include <string>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
 #include <GLES3/gl3.h>
 #include <EGL/egl.h>
 
@@ -11,23 +14,56 @@ public:
     AudioShaderProgram(const std::string& vertex_shader_source, const std::string& fragment_shader_source);
     ~AudioShaderProgram();
 
+    // Links the program, or shares the one already linked in this context from the same sources.
+    // With a binary cache directory set, a linked program is loaded from disk when the driver accepts it.
     bool initialize();
     GLuint get_program() const;
     const std::string get_vertex_shader_source() const {return m_vertex_shader_source;}
     const std::string get_fragment_shader_source() const {return m_fragment_shader_source;}
-    
+
     void use_program() const;
 
+    // Location of a uniform in the linked program, looked up once and then served from a table
+    // shared by every parameter of the program. Returns -1 if the uniform is not active.
+    GLint get_uniform_location(const std::string& name);
+
+    // Uniform values belong to the linked program, which may be shared with other instances built
+    // from the same sources. Returns true if another instance used the program since this one last
+    // claimed it, in which case this instance must upload its uniform values again.
+    bool claim_program_state();
+
+    // Directory of the on-disk program binary cache. An empty path (the default) disables it.
+    static void set_binary_cache_directory(const std::string& directory);
+    static const std::string& get_binary_cache_directory();
+
+    // Number of programs compiled from source and loaded from the binary cache so far
+    static unsigned int get_compile_count();
+    static unsigned int get_binary_load_count();
+
 private:
+    // A linked program shared by every AudioShaderProgram with the same sources in one context
+    struct LinkedProgram {
+        GLuint program = 0;
+        std::unordered_map<std::string, GLint> uniform_locations;
+        const AudioShaderProgram * state_owner = nullptr;
+
+        ~LinkedProgram();
+    };
+
     bool compile_shader(GLuint shader, const std::string& source);
-    bool link_program();
+    bool link_program(GLuint program);
+    bool build_program(LinkedProgram& linked);
+
+    bool load_program_binary(GLuint program, const std::string& path);
+    void save_program_binary(GLuint program, const std::string& path);
+    std::string binary_cache_path() const;
+
+    static std::unordered_map<void*, std::unordered_map<std::string, std::weak_ptr<LinkedProgram>>> s_program_cache;
 
-    GLuint m_vertex_shader;
-    GLuint m_fragment_shader;
-    GLuint m_shader_program;
+    std::shared_ptr<LinkedProgram> m_linked;
 
     std::string m_vertex_shader_source;
     std::string m_fragment_shader_source;
 };
 
-#endif // AUDIO_SHADER_PROGRAM_H
\ No newline at end of file
+#endif // AUDIO_SHADER_PROGRAM_H
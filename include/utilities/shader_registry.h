@@ -0,0 +1,88 @@
+#pragma once
+#ifndef SHADER_REGISTRY_H
+#define SHADER_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Stages write the debug_audio_texture attachment unless the build defines AUDIO_DEBUG_OUTPUTS=0
+#ifndef AUDIO_DEBUG_OUTPUTS
+#define AUDIO_DEBUG_OUTPUTS 1
+#endif
+
+/**
+ * @class ShaderRegistry
+ * @brief Serves GLSL sources from the shader bundle embedded in the binary at build time.
+ *
+ * The build generates a table of every shader under shaders/, keyed by the path it is copied to
+ * (e.g. "build/shaders/global_settings.glsl"), so render stages do not read files when they are
+ * created. Paths outside the bundle, such as shaders written by tests, are read from disk.
+ * Import prefixes combined from bundled shaders are resolved once and shared by every stage.
+ */
+class ShaderRegistry {
+public:
+    /**
+     * @struct Entry
+     * @brief One embedded shader, as emitted by the build.
+     */
+    struct Entry {
+        const char * path;
+        const char * source;
+    };
+
+    /**
+     * @brief Gets the source of a shader.
+     *
+     * @param path The path of the shader, as used in the import lists.
+     * @return The shader source, or an empty string if it is neither bundled nor readable from disk.
+     */
+    static std::string get_source(const std::string & path);
+
+    /**
+     * @brief Whether a shader is part of the embedded bundle.
+     *
+     * @param path The path of the shader.
+     * @return True if the shader is served without touching the disk.
+     */
+    static bool is_embedded(const std::string & path);
+
+    /**
+     * @brief Combines a list of imports into the prefix of a shader.
+     *
+     * Only the first #version directive is kept. Prefixes made only of bundled shaders are memoized.
+     *
+     * @param import_paths The shaders to import, in order.
+     * @param version_added Set to true if the prefix contains a #version directive.
+     * @return The combined imports.
+     */
+    static std::string combine_imports(const std::vector<std::string> & import_paths, bool & version_added);
+
+    /**
+     * @brief Appends a shader source to a combined source, dropping its #version line if one was already added.
+     *
+     * The build settings shaders can test with #if, such as AUDIO_DEBUG_OUTPUTS, are defined right after
+     * the #version directive that is kept.
+     *
+     * @param combined_source The source being combined.
+     * @param version_added Whether combined_source already has a #version directive. Updated.
+     * @param source The source to append.
+     */
+    static void append_source(std::string & combined_source, bool & version_added, const std::string & source);
+
+    /**
+     * @brief Gets the number of shaders in the embedded bundle.
+     */
+    static std::size_t get_embedded_count();
+
+    /**
+     * @brief Gets the number of shader files read from disk so far.
+     */
+    static unsigned int get_disk_read_count();
+};
+
+// Generated by the build from shaders/**/*.glsl
+extern const ShaderRegistry::Entry SHADER_REGISTRY_ENTRIES[];
+extern const std::size_t SHADER_REGISTRY_ENTRY_COUNT;
+
+#endif // SHADER_REGISTRY_H
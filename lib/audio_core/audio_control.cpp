@@ -1,8 +1,32 @@
 #include "audio_core/audio_control.h"
+#include "utilities/audio_tracer.h"
 #include <stack>
 #include <typeinfo>
 #include <typeindex>
 
+static AudioControlBase::SetterDispatcher s_setter_dispatcher;
+
+void AudioControlBase::set_setter_dispatcher(SetterDispatcher dispatcher) {
+    s_setter_dispatcher = std::move(dispatcher);
+}
+
+bool AudioControlBase::dispatch_setter(const std::string& control_name, std::function<void()> setter_call) {
+    if (AudioTracer::is_enabled()) {
+        // Mark the change where it is made, and trace the setter where it runs
+        AudioTracer::instant(control_name, "control");
+        setter_call = [control_name, setter_call = std::move(setter_call)]() {
+            AUDIO_TRACE_SCOPE(control_name, "control");
+            setter_call();
+        };
+    }
+
+    if (s_setter_dispatcher) {
+        return s_setter_dispatcher(setter_call);
+    }
+    setter_call();
+    return true;
+}
+
 // Global registry for controls
 AudioControlRegistry& AudioControlRegistry::instance() {
     static AudioControlRegistry inst;
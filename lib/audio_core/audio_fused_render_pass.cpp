@@ -0,0 +1,354 @@
+#include <iostream>
+#include <regex>
+#include <algorithm>
+
+#include "audio_core/audio_fused_render_pass.h"
+#include "audio_core/audio_render_stage.h"
+#include "audio_parameter/audio_texture2d_parameter.h"
+#include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "utilities/shader_registry.h"
+
+// A sample of the stream at the fragment, the only way a point-wise stage may read its input
+static const std::regex STREAM_SAMPLE(R"(texture\s*\(\s*stream_audio_texture\s*,\s*TexCoord\s*\))");
+static const std::regex STREAM_NAME(R"(\bstream_audio_texture\b)");
+static const std::regex DISCARD(R"(\bdiscard\b)");
+
+static const std::regex FUNCTION_HEADER(R"(^\s*(?:(?:highp|mediump|lowp)\s+)?\w+\s+(\w+)\s*\([^()]*\)\s*$)");
+static const std::regex DECLARATION(R"(^\s*(?:(?:uniform|const|highp|mediump|lowp)\s+)*(\w+)\s+(\w+)\s*(?:\[[^\]]*\])?\s*(?:=[\s\S]*)?$)");
+static const std::regex PRECISION(R"(precision\s+\w+\s+\w+\s*;)");
+
+// Name of the value carrying the output of the previous stage through the fused main()
+static const std::string FUSED_STREAM = "fused_stream_audio";
+
+static std::string strip_comments(const std::string & source) {
+    std::string stripped;
+    stripped.reserve(source.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (source.compare(i, 2, "//") == 0) {
+            while (i < source.size() && source[i] != '\n') {
+                ++i;
+            }
+            stripped += '\n';
+        } else if (source.compare(i, 2, "/*") == 0) {
+            const size_t end = source.find("*/", i + 2);
+            i = end == std::string::npos ? source.size() : end + 1;
+            stripped += ' ';
+        } else {
+            stripped += source[i];
+        }
+    }
+    return stripped;
+}
+
+static bool has_top_level_comma(const std::string & statement) {
+    int depth = 0;
+    for (const char c : statement) {
+        if (c == '(' || c == '[') {
+            depth++;
+        } else if (c == ')' || c == ']') {
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool add_global_name(const std::string & statement, std::vector<std::string> & names) {
+    const size_t first = statement.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos || statement.compare(first, 9, "precision") == 0) {
+        return true;
+    }
+
+    std::smatch match;
+    if (std::regex_match(statement, match, FUNCTION_HEADER)) {
+        // Prototypes and definitions name the same function
+        if (std::find(names.begin(), names.end(), match[1].str()) == names.end()) {
+            names.push_back(match[1].str());
+        }
+        return true;
+    }
+
+    // One declarator per statement, and no extra textures or stage inputs/outputs
+    if (has_top_level_comma(statement) || !std::regex_match(statement, match, DECLARATION)) {
+        return false;
+    }
+    if (match[1].str().rfind("sampler", 0) == 0) {
+        return false;
+    }
+    names.push_back(match[2].str());
+    return true;
+}
+
+// Names declared at global scope by a comment-free stage body, or false if one cannot be renamed
+static bool collect_global_names(const std::string & code, std::vector<std::string> & names) {
+    std::string statement;
+    int depth = 0;
+    bool line_start = true;
+
+    for (size_t i = 0; i < code.size(); ++i) {
+        const char c = code[i];
+
+        if (depth == 0 && line_start && c == '#') {
+            // Only the #version directive, which is dropped when the body is appended, is allowed
+            const size_t end = code.find('\n', i);
+            const std::string directive = code.substr(i, end == std::string::npos ? std::string::npos : end - i);
+            if (directive.rfind("#version", 0) != 0) {
+                return false;
+            }
+            i = end == std::string::npos ? code.size() : end;
+            line_start = true;
+            continue;
+        }
+        if (c == '\n') {
+            line_start = true;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            line_start = false;
+        }
+
+        if (depth > 0) {
+            if (c == '{') {
+                depth++;
+            } else if (c == '}') {
+                depth--;
+            }
+            continue;
+        }
+
+        if (c == '{') {
+            // Only function bodies open a scope at global level (no structs or uniform blocks)
+            std::smatch match;
+            if (!std::regex_match(statement, match, FUNCTION_HEADER)) {
+                return false;
+            }
+            if (std::find(names.begin(), names.end(), match[1].str()) == names.end()) {
+                names.push_back(match[1].str());
+            }
+            statement.clear();
+            depth = 1;
+        } else if (c == ';') {
+            if (!add_global_name(statement, names)) {
+                return false;
+            }
+            statement.clear();
+        } else {
+            statement += c;
+        }
+    }
+
+    return depth == 0 && statement.find_first_not_of(" \t\r\n") == std::string::npos;
+}
+
+AudioFusedRenderPass::AudioFusedRenderPass(std::vector<std::shared_ptr<AudioRenderStage>> render_stages)
+    : m_render_stages(std::move(render_stages)) {
+    m_name = "fused(";
+    for (size_t i = 0; i < m_render_stages.size(); ++i) {
+        m_name += (i == 0 ? "" : "+") + m_render_stages[i]->get_name();
+    }
+    m_name += ")";
+}
+
+bool AudioFusedRenderPass::is_point_wise_source(const std::string & body) {
+    const std::string code = strip_comments(body);
+
+    const auto samples = std::distance(std::sregex_iterator(code.begin(), code.end(), STREAM_SAMPLE), std::sregex_iterator());
+    const auto references = std::distance(std::sregex_iterator(code.begin(), code.end(), STREAM_NAME), std::sregex_iterator());
+    if (samples != references || std::regex_search(code, DISCARD)) {
+        return false;
+    }
+
+    std::vector<std::string> names;
+    return collect_global_names(code, names) && std::find(names.begin(), names.end(), "main") != names.end();
+}
+
+bool AudioFusedRenderPass::namespace_source(const std::string & body,
+                                            const std::string & suffix,
+                                            const bool sample_stream,
+                                            std::string & namespaced_body,
+                                            std::vector<std::string> & global_names) {
+    namespaced_body = strip_comments(body);
+    global_names.clear();
+    if (!collect_global_names(namespaced_body, global_names)) {
+        return false;
+    }
+
+    if (!sample_stream) {
+        namespaced_body = std::regex_replace(namespaced_body, STREAM_SAMPLE, FUSED_STREAM);
+    }
+    for (const auto & name : global_names) {
+        namespaced_body = std::regex_replace(namespaced_body, std::regex("\\b" + name + "\\b"), name + suffix);
+    }
+    return true;
+}
+
+bool AudioFusedRenderPass::initialize() {
+    if (m_render_stages.size() < 2) {
+        return false;
+    }
+
+    // Every stage draws the same full-screen quad
+    const auto & first = m_render_stages.front();
+    for (auto & render_stage : m_render_stages) {
+        if (!render_stage->is_initialized() || render_stage->m_vertex_shader_source != first->m_vertex_shader_source) {
+            return false;
+        }
+    }
+
+    if (!generate_fragment_shader_source()) {
+        return false;
+    }
+
+    m_shader_program = std::make_unique<AudioShaderProgram>(first->m_vertex_shader_source, m_fragment_shader_source);
+    if (!m_shader_program->initialize()) {
+        std::cerr << "Warning: Failed to link " << m_name << ", rendering its stages separately." << std::endl;
+        return false;
+    }
+    AudioUniformBufferParameter::bind_registered_blocks(m_shader_program->get_program());
+
+    if (!link_parameters()) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+bool AudioFusedRenderPass::generate_fragment_shader_source() {
+    // The imports of every stage, each once and in order of first use
+    std::vector<std::string> imports;
+    for (auto & render_stage : m_render_stages) {
+        for (const auto & import_path : render_stage->m_initial_frag_shader_imports) {
+            if (std::find(imports.begin(), imports.end(), import_path) == imports.end()) {
+                imports.push_back(import_path);
+            }
+        }
+    }
+
+    bool version_added = false;
+    std::string source = ShaderRegistry::combine_imports(imports, version_added);
+
+    // A body may lower the default precision, so the defaults of the imports are restated after each one
+    std::string default_precision;
+    const std::string imports_code = strip_comments(source);
+    for (auto it = std::sregex_iterator(imports_code.begin(), imports_code.end(), PRECISION); it != std::sregex_iterator(); ++it) {
+        default_precision += it->str() + "\n";
+    }
+
+    source += "\nvec4 " + FUSED_STREAM + ";\n";
+    std::string fused_main = "\nvoid main() {\n";
+
+    m_global_names.clear();
+    for (size_t i = 0; i < m_render_stages.size(); ++i) {
+        const auto & render_stage = m_render_stages[i];
+        const std::string suffix = "_stage" + std::to_string(i);
+
+        std::string body;
+        std::vector<std::string> global_names;
+        if (!namespace_source(render_stage->get_fragment_shader_body(), suffix, i == 0, body, global_names) ||
+            std::find(global_names.begin(), global_names.end(), "main") == global_names.end()) {
+            return false;
+        }
+
+        ShaderRegistry::append_source(source, version_added, body);
+        source += "\n" + default_precision;
+
+        if (i > 0) {
+            fused_main += "    " + FUSED_STREAM + " = output_audio_texture;\n";
+        }
+        fused_main += "    main" + suffix + "();\n";
+        m_global_names.push_back(std::move(global_names));
+    }
+
+    m_fragment_shader_source = source + fused_main + "}\n";
+    return true;
+}
+
+bool AudioFusedRenderPass::link_parameters() {
+    for (size_t i = 0; i < m_render_stages.size(); ++i) {
+        auto * render_stage = m_render_stages[i].get();
+        const auto & global_names = m_global_names[i];
+        const std::string suffix = "_stage" + std::to_string(i);
+
+        for (auto & param : render_stage->m_parameters) {
+            AudioParameter * parameter = param.get();
+
+            // Outputs are written through the framebuffer of the last stage
+            if (parameter->connection_type == AudioParameter::ConnectionType::OUTPUT) {
+                continue;
+            }
+
+            std::string uniform_name;
+            if (std::find(global_names.begin(), global_names.end(), parameter->name) != global_names.end()) {
+                uniform_name = parameter->name + suffix;
+            } else if (i == 0) {
+                // Declared by the imports, shared by every stage of the run
+                uniform_name = parameter->name;
+            } else if (parameter == render_stage->m_stream_audio_texture ||
+                       parameter->connection_type == AudioParameter::ConnectionType::INITIALIZATION) {
+                // The stream is replaced by the previous stage, and the settings match the first stage
+                continue;
+            } else {
+                // A per-stage uniform declared by an import cannot be namespaced
+                return false;
+            }
+
+            if (!parameter->relink_program(m_shader_program.get(), uniform_name)) {
+                return false;
+            }
+            m_linked_parameters.push_back({render_stage, parameter});
+        }
+    }
+    return true;
+}
+
+void AudioFusedRenderPass::release() {
+    for (auto & linked : m_linked_parameters) {
+        linked.parameter->relink_program(linked.render_stage->m_shader_program.get(), linked.parameter->name);
+    }
+    m_linked_parameters.clear();
+}
+
+void AudioFusedRenderPass::render(const unsigned int time) {
+    auto * first = m_render_stages.front().get();
+    auto * last = m_render_stages.back().get();
+
+    for (auto & render_stage : m_render_stages) {
+        if (render_stage->m_time != time) {
+            render_stage->m_local_time++;
+        }
+        render_stage->m_time = time;
+        render_stage->m_output_silenced = false;
+    }
+
+    glUseProgram(m_shader_program->get_program());
+
+    // Identical runs in other tracks share the fused program, and with it the uniform values
+    if (m_shader_program->claim_program_state()) {
+        for (auto & linked : m_linked_parameters) {
+            linked.parameter->reset_program_state();
+        }
+    }
+
+    // The last stage's framebuffer writes into the stream of the stage after the run
+    glBindFramebuffer(GL_FRAMEBUFFER, last->m_framebuffer);
+    glViewport(0, 0, last->frames_per_buffer, last->num_channels * last->m_blocks_per_render);
+
+    // The whole pass is timed on the first stage
+    {
+        AudioStageTimer::Scope upload_scope(first->m_stage_timer, AudioStageTimer::Phase::UPLOAD);
+        for (auto & linked : m_linked_parameters) {
+            linked.parameter->render();
+        }
+    }
+
+    AudioStageTimer::Scope draw_scope(first->m_stage_timer, AudioStageTimer::Phase::DRAW);
+    last->apply_draw_buffers();
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    first->m_stage_timer.begin_gpu();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    first->m_stage_timer.end_gpu();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glUseProgram(0);
+}
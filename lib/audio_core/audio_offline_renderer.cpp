@@ -0,0 +1,255 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "audio_render_stage/audio_final_render_stage.h"
+#include "audio_core/audio_offline_renderer.h"
+#include "utilities/egl_compatibility.h"
+
+AudioOfflineRenderer::AudioOfflineRenderer(AudioRenderGraph * render_graph,
+                                           const unsigned int buffer_size,
+                                           const unsigned int sample_rate,
+                                           const unsigned int num_channels) :
+    m_render_graph(render_graph),
+    m_buffer_size(buffer_size),
+    m_sample_rate(sample_rate),
+    m_num_channels(num_channels) {
+
+    // Same global time parameter the real time renderer exposes to the shaders
+    auto global_time = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time->set_value(0);
+    m_global_parameters.push_back(std::unique_ptr<AudioParameter>(global_time));
+
+    m_tape_block.resize(buffer_size * num_channels);
+}
+
+AudioOfflineRenderer::~AudioOfflineRenderer() {
+    if (m_headless_context != EGL_NO_CONTEXT) {
+        EGLCompatibility::make_headless_current(m_headless_context);
+    }
+
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+        m_VAO = 0;
+    }
+    if (m_VBO) {
+        glDeleteBuffers(1, &m_VBO);
+        m_VBO = 0;
+    }
+
+    // GL objects owned by the graph and parameters must go before the context
+    m_render_outputs.clear();
+    m_global_parameters.clear();
+    m_render_graph.reset();
+
+    if (m_headless_context != EGL_NO_CONTEXT) {
+        EGLCompatibility::cleanup_headless_context(m_headless_context);
+        m_headless_context = EGL_NO_CONTEXT;
+    }
+    m_initialized = false;
+}
+
+bool AudioOfflineRenderer::initialize() {
+    if (m_initialized) {
+        std::cerr << "Error: Offline renderer already initialized." << std::endl;
+        return false;
+    }
+
+    if (m_render_graph == nullptr) {
+        std::cerr << "Error: No render graph added." << std::endl;
+        return false;
+    }
+
+    // Reuse the caller's context if there is one, otherwise render headless
+    if (eglGetCurrentContext() == EGL_NO_CONTEXT) {
+        if (!EGLCompatibility::initialize_headless_context(m_headless_context)) {
+            std::cerr << "Error: Failed to create headless context for offline rendering." << std::endl;
+            return false;
+        }
+    }
+
+    // Set GL settings for audio rendering
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    if (!m_render_graph->initialize()) {
+        std::cerr << "Failed to initialize render graph." << std::endl;
+        return false;
+    }
+
+    for (auto& param : m_global_parameters) {
+        if (!param->initialize()) {
+            std::cerr << "Failed to initialize global parameters" << std::endl;
+            return false;
+        }
+    }
+
+    if (!initialize_quad()) {
+        std::cerr << "Failed to create quad." << std::endl;
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+bool AudioOfflineRenderer::initialize_quad() {
+    // Just a default set of vertices to cover the screen
+    GLfloat vertices[] = {
+        // Position    Texcoords
+        -1.0f, -1.0f, 0.0f, 0.0f,  // Bottom-left
+        -1.0f,  1.0f, 0.0f, 1.0f,  // Top-left
+         1.0f, -1.0f, 1.0f, 0.0f,  // Bottom-right
+         1.0f,  1.0f, 1.0f, 1.0f,  // Top-right
+        -1.0f,  1.0f, 0.0f, 1.0f,  // Top-left
+         1.0f, -1.0f, 1.0f, 0.0f   // Bottom-right
+    };
+
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0); // Vertex attributes
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)(2 * sizeof(GLfloat))); // Texture attributes
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Failed to initialize OpenGL: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AudioOfflineRenderer::add_render_output(AudioOutput * output_link) {
+    m_render_outputs.push_back(std::unique_ptr<AudioOutput>(output_link));
+    return true;
+}
+
+bool AudioOfflineRenderer::set_output_tape(std::shared_ptr<AudioTape> tape) {
+    if (tape && tape->num_channels() != m_num_channels) {
+        std::cerr << "Error: Tape has " << tape->num_channels() << " channels, expected " << m_num_channels << std::endl;
+        return false;
+    }
+    m_output_tape = tape;
+    return true;
+}
+
+bool AudioOfflineRenderer::set_readback_latency(const unsigned int blocks) {
+    // Rebuilding the readback ring would drop the blocks already in flight
+    if (m_render_count != 0) {
+        std::cerr << "Error: Readback latency must be set before rendering starts." << std::endl;
+        return false;
+    }
+
+    auto output_stage = m_render_graph ? m_render_graph->get_output_render_stage() : nullptr;
+    if (output_stage == nullptr || !output_stage->set_readback_latency(blocks)) {
+        return false;
+    }
+    m_readback_latency = blocks;
+    return true;
+}
+
+bool AudioOfflineRenderer::render_blocks(const unsigned int num_blocks) {
+    if (!m_initialized) {
+        std::cerr << "Error: Offline renderer not initialized." << std::endl;
+        return false;
+    }
+
+    if (m_headless_context != EGL_NO_CONTEXT) {
+        EGLCompatibility::make_headless_current(m_headless_context);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // With readback latency the output stage hands back the batch rendered
+    // m_readback_latency calls ago, so the first renders are only priming the pipeline
+    const unsigned int start_blocks = m_rendered_blocks;
+    const unsigned int target_blocks = start_blocks + num_blocks;
+    while (m_rendered_blocks < target_blocks) {
+        render_block();
+        if (m_render_count > m_readback_latency) {
+            push_to_sinks();
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    const float rendered_seconds = static_cast<float>((m_rendered_blocks - start_blocks) * m_buffer_size) / static_cast<float>(m_sample_rate);
+    m_realtime_factor = elapsed > 0.0f ? rendered_seconds / elapsed : 0.0f;
+
+    return true;
+}
+
+bool AudioOfflineRenderer::render_seconds(const float seconds) {
+    if (seconds < 0.0f) {
+        std::cerr << "Error: Cannot render a negative duration." << std::endl;
+        return false;
+    }
+    const unsigned int num_blocks = static_cast<unsigned int>(std::ceil(seconds * m_sample_rate / m_buffer_size));
+    return render_blocks(num_blocks);
+}
+
+void AudioOfflineRenderer::render_block() {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    m_render_graph->bind();
+
+    // Set the time for the frame
+    auto time_param = find_global_parameter("global_time");
+    time_param->set_value(m_frame_count);
+
+    glBindVertexArray(m_VAO);
+
+    for (auto& param : m_global_parameters) {
+        param->render();
+    }
+
+    m_render_graph->render(m_frame_count);
+
+    glBindVertexArray(0);
+
+    m_frame_count += m_render_graph->get_blocks_per_render();
+    m_render_count++;
+}
+
+void AudioOfflineRenderer::push_to_sinks() {
+    auto output_stage = m_render_graph->get_output_render_stage();
+
+    const unsigned int blocks_per_render = m_render_graph->get_blocks_per_render();
+    const float * data = output_stage->get_output_buffer_data().data();
+    const auto & channels = output_stage->get_output_data_channel_seperated();
+
+    for (unsigned int block = 0; block < blocks_per_render; ++block) {
+        for (auto& output : m_render_outputs) {
+            output->push(data + block * m_buffer_size * m_num_channels);
+        }
+
+        if (m_output_tape) {
+            for (unsigned int ch = 0; ch < m_num_channels; ++ch) {
+                auto channel_block = channels[ch].begin() + block * m_buffer_size;
+                std::copy(channel_block, channel_block + m_buffer_size, m_tape_block.begin() + ch * m_buffer_size);
+            }
+            m_output_tape->record(m_tape_block.data());
+        }
+    }
+
+    m_rendered_blocks += blocks_per_render;
+}
+
+AudioParameter * AudioOfflineRenderer::find_global_parameter(const std::string name) const {
+    for (auto &param : m_global_parameters) {
+        if (param->name == name) {
+            return param.get();
+        }
+    }
+    return nullptr;
+}
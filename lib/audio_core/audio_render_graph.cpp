@@ -9,8 +9,10 @@
 #include "audio_core/audio_render_stage.h"
 #include "audio_render_stage/audio_final_render_stage.h"
 #include "audio_render_stage/audio_multitrack_join_render_stage.h"
+#include "audio_parameter/audio_texture2d_parameter.h"
 
 #include "audio_core/audio_render_graph.h"
+#include "utilities/audio_tracer.h"
 
 AudioRenderGraph::AudioRenderGraph(AudioRenderStage * output) {
     // Check if the output is a final render stage
@@ -22,6 +24,7 @@ AudioRenderGraph::AudioRenderGraph(AudioRenderStage * output) {
     if (!construct_render_order(output)) {
         throw std::runtime_error("Failed to construct render order.");
     }
+    m_output_render_stage = dynamic_cast<AudioFinalRenderStage *>(output);
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -51,6 +54,7 @@ AudioRenderGraph::AudioRenderGraph(std::vector<AudioRenderStage *> inputs) {
     if (!construct_render_order(outputs[0])) {
         throw std::runtime_error("Failed to construct render order.");
     }
+    m_output_render_stage = dynamic_cast<AudioFinalRenderStage *>(outputs[0]);
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -95,11 +99,26 @@ AudioRenderStage * AudioRenderGraph::from_input_to_output(AudioRenderStage * nod
 }
 
 AudioRenderGraph::~AudioRenderGraph() {
+    release_fused_passes();
+    delete m_pending_plan.exchange(nullptr);
+
     m_outputs.clear();
     m_inputs.clear();
     m_render_order.clear();
 }
 
+AudioRenderGraph::EditScope::EditScope(AudioRenderGraph & graph)
+    : m_graph(graph), m_guard(graph.m_edit_mutex) {
+    m_graph.m_edit_depth++;
+}
+
+AudioRenderGraph::EditScope::~EditScope() {
+    // The outermost scope publishes every edit made inside it at once
+    if (--m_graph.m_edit_depth == 0 && m_graph.m_plan_changed) {
+        m_graph.publish_render_plan();
+    }
+}
+
 // Pull directly from render stage graph
 bool AudioRenderGraph::construct_render_order(AudioRenderStage * node) {
 
@@ -158,9 +177,15 @@ bool AudioRenderGraph::initialize() {
         }
     }
 
-    if (!bind_render_stages()) {
-        std::cerr << "Failed to bind render graph." << std::endl;
-        return false;
+    {
+        // Bind every stage, dropping any plan published by edits made before initialization
+        std::lock_guard<std::recursive_mutex> guard(m_edit_mutex);
+        delete m_pending_plan.exchange(nullptr);
+        m_active_plan.reset();
+        if (!adopt_render_plan(make_render_plan())) {
+            std::cerr << "Failed to bind render graph." << std::endl;
+            return false;
+        }
     }
 
     m_initialized = true;
@@ -168,26 +193,397 @@ bool AudioRenderGraph::initialize() {
     return true;
 }
 
-bool AudioRenderGraph::bind_render_stages() {
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
-    // bind the render stages
+bool AudioRenderGraph::set_blocks_per_render(const unsigned int blocks_per_render) {
+    if (m_initialized) {
+        std::cerr << "Error: Blocks per render must be set before the render graph is initialized." << std::endl;
+        return false;
+    }
+
+    // Check every stage first so a failure leaves the graph unchanged
+    if (blocks_per_render > 1) {
+        for (auto & [gid, render_stage] : m_render_stages_map) {
+            if (!render_stage->supports_batching()) {
+                std::cerr << "Error: Render stage " << render_stage->get_name() << " does not support batched rendering." << std::endl;
+                return false;
+            }
+        }
+    }
+
     for (auto & [gid, render_stage] : m_render_stages_map) {
-        if (!render_stage->bind()) {
-            std::cerr << "Error: Failed to bind render stage " << gid << std::endl;
+        if (!render_stage->set_blocks_per_render(blocks_per_render)) {
             return false;
         }
     }
 
+    m_blocks_per_render = blocks_per_render;
     return true;
 }
 
-void AudioRenderGraph::render(unsigned int time) {
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
+bool AudioRenderGraph::match_blocks_per_render(AudioRenderStage * render_stage) {
+    if (render_stage->get_blocks_per_render() == m_blocks_per_render) {
+        return true;
+    }
+    if (render_stage->is_initialized()) {
+        printf("Render stage %d renders %u blocks per draw but the graph renders %u\n",
+               render_stage->gid, render_stage->get_blocks_per_render(), m_blocks_per_render);
+        return false;
+    }
+    return render_stage->set_blocks_per_render(m_blocks_per_render);
+}
+
+bool AudioRenderGraph::set_half_float_streams(bool half_float) {
+    if (m_initialized) {
+        std::cerr << "Error: Stream precision must be set before the render graph is initialized." << std::endl;
+        return false;
+    }
+    if (half_float && !AudioTexture2DParameter::half_float_renderable()) {
+        std::cerr << "Warning: Half float textures are not renderable, the streams keep 32-bit precision." << std::endl;
+        half_float = false;
+    }
+
+    for (auto & [gid, render_stage] : m_render_stages_map) {
+        if (!match_stream_precision(render_stage.get(), half_float)) {
+            return false;
+        }
+    }
+
+    m_half_float_streams = half_float;
+    return true;
+}
+
+bool AudioRenderGraph::match_stream_precision(AudioRenderStage * render_stage, const bool half_float) {
+    // The policy is for the links between stages, so stages needing full precision keep it
+    if (render_stage->has_half_float_streams() == half_float || !render_stage->supports_half_float_streams()) {
+        return true;
+    }
+    if (render_stage->is_initialized()) {
+        printf("Render stage %d is already initialized, its streams keep their precision\n", render_stage->gid);
+        return true;
+    }
+    return render_stage->set_half_float_streams(half_float);
+}
+
+std::unique_ptr<AudioRenderGraph::RenderPlan> AudioRenderGraph::make_render_plan() {
+    auto plan = std::make_unique<RenderPlan>();
+    plan->stage_fusion_enabled = m_stage_fusion_enabled;
+    plan->silence_culling_enabled = m_silence_culling_enabled;
 
-    // Render the render stages in order
     for (auto & gid : m_render_order) {
-        m_render_stages_map[gid]->render(time);
+        auto & render_stage = m_render_stages_map[gid];
+        plan->render_stages.push_back(render_stage);
+
+        auto & outputs = plan->output_links[gid];
+        for (auto * output : render_stage->m_connected_output_render_stages) {
+            outputs.push_back(output->gid);
+        }
+        std::sort(outputs.begin(), outputs.end());
+
+        auto & inputs = plan->input_links[gid];
+        auto & input_stages = plan->input_stages[gid];
+        for (auto * input : render_stage->m_connected_stream_render_stages) {
+            inputs.push_back(input->gid);
+            input_stages.push_back(input);
+        }
+        std::sort(inputs.begin(), inputs.end());
+    }
+    return plan;
+}
+
+void AudioRenderGraph::publish_render_plan() {
+    m_plan_changed = false;
+    if (!m_initialized) {
+        return; // initialize() binds the graph as it is then
+    }
+
+    // A plan that bind() did not adopt yet is superseded, and freed with the retired plans on the render side
+    std::unique_ptr<RenderPlan> superseded(m_pending_plan.exchange(make_render_plan().release(), std::memory_order_acq_rel));
+    if (superseded) {
+        m_retired_plans.push_back(std::move(superseded));
+    }
+}
+
+void AudioRenderGraph::bind() {
+    if (m_pending_plan.load(std::memory_order_acquire) == nullptr) {
+        return;
+    }
+
+    // The stage links may be mid-edit, in which case the current plan renders one more block
+    std::unique_lock<std::recursive_mutex> lock(m_edit_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || m_edit_depth > 0) {
+        return;
+    }
+
+    std::unique_ptr<RenderPlan> plan(m_pending_plan.exchange(nullptr, std::memory_order_acq_rel));
+    if (plan && !adopt_render_plan(std::move(plan))) {
+        std::cerr << "Error: Failed to bind render graph." << std::endl;
+    }
+
+    // Between two blocks no plan but the active one is in use, so the stages only the retired plans
+    // kept alive are destroyed here, with their textures, in the render context
+    m_retired_plans.clear();
+}
+
+bool AudioRenderGraph::adopt_render_plan(std::unique_ptr<RenderPlan> plan) {
+    bool success = true;
+    const RenderPlan * previous = m_active_plan.get();
+
+    for (auto & render_stage : plan->render_stages) {
+        const GID gid = render_stage->gid;
+        const bool is_new = previous == nullptr || previous->output_links.find(gid) == previous->output_links.end();
+
+        // Only the stages whose outputs moved attach other textures to their framebuffer
+        if (is_new || previous->output_links.at(gid) != plan->output_links.at(gid)) {
+            if (!render_stage->bind()) {
+                std::cerr << "Error: Failed to bind render stage " << gid << std::endl;
+                success = false;
+            }
+            // The textures it renders into now are not cleared yet
+            render_stage->m_output_silenced = false;
+        }
+
+        // A stream texture that lost its producer would otherwise keep the last block rendered into it
+        if (!is_new && previous->input_links.at(gid) != plan->input_links.at(gid)) {
+            for (auto & param : render_stage->m_parameters) {
+                if (param->connection_type == AudioParameter::ConnectionType::PASSTHROUGH &&
+                    param->get_previous_parameter() == nullptr &&
+                    dynamic_cast<AudioTexture2DParameter *>(param.get()) != nullptr) {
+                    param->clear_value();
+                }
+            }
+        }
     }
+
+    build_fused_passes(*plan);
+
+    if (m_active_plan) {
+        m_retired_plans.push_back(std::move(m_active_plan));
+    }
+    m_active_plan = std::move(plan);
+    return success;
+}
+
+void AudioRenderGraph::set_stage_fusion_enabled(const bool enabled) {
+    EditScope edit(*this);
+    m_stage_fusion_enabled = enabled;
+    m_plan_changed = true;
+}
+
+void AudioRenderGraph::set_silence_culling_enabled(const bool enabled) {
+    EditScope edit(*this);
+    m_silence_culling_enabled = enabled;
+    m_plan_changed = true;
+}
+
+bool AudioRenderGraph::is_silent(const RenderPlan & plan, AudioRenderStage * render_stage) {
+    bool inputs_silent = plan.silence_culling_enabled;
+    for (auto * input : plan.input_stages.at(render_stage->gid)) {
+        inputs_silent = inputs_silent && input->m_output_silenced;
+    }
+    return is_silent(render_stage, inputs_silent);
+}
+
+bool AudioRenderGraph::is_silent(AudioRenderStage * render_stage, const bool inputs_silent) {
+    if (!inputs_silent || !render_stage->is_silent_without_input()) {
+        render_stage->m_silent_blocks = 0;
+        return false;
+    }
+
+    // Render the tail left over from the last sound first
+    if (render_stage->m_silent_blocks >= render_stage->get_tail_blocks()) {
+        return true;
+    }
+    render_stage->m_silent_blocks += m_blocks_per_render;
+    return false;
+}
+
+std::vector<AudioRenderGraph::GID> AudioRenderGraph::get_silent_stages() const {
+    std::vector<GID> silent_stages;
+    if (!m_active_plan || !m_active_plan->silence_culling_enabled) {
+        return silent_stages;
+    }
+    for (auto & render_stage : m_active_plan->render_stages) {
+        if (render_stage->m_output_silenced) {
+            silent_stages.push_back(render_stage->gid);
+        }
+    }
+    return silent_stages;
+}
+
+void AudioRenderGraph::build_fused_passes(const RenderPlan & plan) {
+    std::vector<std::vector<std::shared_ptr<AudioRenderStage>>> runs;
+
+    if (plan.stage_fusion_enabled) {
+        std::unordered_map<GID, std::shared_ptr<AudioRenderStage>> render_stages;
+        for (auto & render_stage : plan.render_stages) {
+            render_stages[render_stage->gid] = render_stage;
+        }
+
+        std::unordered_map<GID, bool> fusible;
+        auto is_fusible = [&fusible](AudioRenderStage * render_stage) {
+            auto it = fusible.find(render_stage->gid);
+            if (it == fusible.end()) {
+                it = fusible.emplace(render_stage->gid, render_stage->is_fusible()).first;
+            }
+            return it->second;
+        };
+
+        // Stages already tried as part of a run, fused or not
+        std::unordered_set<GID> visited;
+
+        for (auto & first : plan.render_stages) {
+            const GID gid = first->gid;
+            if (visited.count(gid) || plan.input_links.at(gid).size() > 1 || !is_fusible(first.get())) {
+                continue;
+            }
+
+            // Extend the run while the next stage is fed by the current one only
+            std::vector<std::shared_ptr<AudioRenderStage>> run = {first};
+            GID current = gid;
+            while (plan.output_links.at(current).size() == 1) {
+                auto & next = render_stages[plan.output_links.at(current).front()];
+                if (plan.input_links.at(next->gid).size() != 1 || !is_fusible(next.get())) {
+                    break;
+                }
+                run.push_back(next);
+                current = next->gid;
+            }
+            if (run.size() < 2) {
+                continue;
+            }
+
+            for (auto & render_stage : run) {
+                visited.insert(render_stage->gid);
+            }
+            runs.push_back(std::move(run));
+        }
+    }
+
+    // Keep the passes whose run did not change, they still draw from and into the same textures
+    std::unordered_map<GID, std::unique_ptr<AudioFusedRenderPass>> kept_passes;
+    std::vector<std::vector<std::shared_ptr<AudioRenderStage>>> new_runs;
+    for (auto & run : runs) {
+        auto pass = m_fused_passes.find(run.front()->gid);
+        if (pass != m_fused_passes.end() && pass->second->get_render_stages() == run) {
+            kept_passes[run.front()->gid] = std::move(pass->second);
+            m_fused_passes.erase(pass);
+        } else {
+            new_runs.push_back(std::move(run));
+        }
+    }
+
+    // The stages of the dropped passes may be fused again below, so release them first
+    release_fused_passes();
+    m_fused_passes = std::move(kept_passes);
+
+    for (auto & run : new_runs) {
+        const GID gid = run.front()->gid;
+        auto pass = std::make_unique<AudioFusedRenderPass>(run);
+        if (pass->initialize()) {
+            m_fused_passes[gid] = std::move(pass);
+        }
+    }
+
+    for (auto & [gid, pass] : m_fused_passes) {
+        for (auto & render_stage : pass->get_render_stages()) {
+            m_fused_stages.insert(render_stage->gid);
+        }
+    }
+}
+
+void AudioRenderGraph::release_fused_passes() {
+    for (auto & [gid, pass] : m_fused_passes) {
+        pass->release();
+    }
+    m_fused_passes.clear();
+    m_fused_stages.clear();
+}
+
+std::vector<std::vector<AudioRenderGraph::GID>> AudioRenderGraph::get_fused_runs() const {
+    std::vector<std::vector<GID>> runs;
+    if (!m_active_plan) {
+        return runs;
+    }
+    for (auto & render_stage : m_active_plan->render_stages) {
+        auto pass = m_fused_passes.find(render_stage->gid);
+        if (pass == m_fused_passes.end()) {
+            continue;
+        }
+        std::vector<GID> run;
+        for (auto & render_stage : pass->second->get_render_stages()) {
+            run.push_back(render_stage->gid);
+        }
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+void AudioRenderGraph::render(unsigned int time) {
+    // The plan only changes in bind(), so rendering never waits on an edit
+    if (!m_active_plan) {
+        return;
+    }
+
+    const RenderPlan & plan = *m_active_plan;
+
+    // Render the render stages in order, skipping the ones that only output silence
+    for (auto & render_stage : plan.render_stages) {
+        const GID gid = render_stage->gid;
+
+        // A fused pass renders its whole run in place of its first stage
+        if (auto pass = m_fused_passes.find(gid); pass != m_fused_passes.end()) {
+            // Inside the run each stage is fed by the one before only, which is not skipped yet,
+            // so the run is silent once its last stage is silent behind a silent stage
+            const auto & run = pass->second->get_render_stages();
+            bool silent = is_silent(plan, run.front().get());
+            for (size_t i = 1; i < run.size(); i++) {
+                silent = is_silent(run[i].get(), silent);
+            }
+            if (silent) {
+                for (auto & fused_stage : run) {
+                    fused_stage->skip_render(time);
+                }
+                continue;
+            }
+
+            AUDIO_TRACE_SCOPE(pass->second->get_name(), "stage");
+            render_stage->m_stage_timer.begin_block();
+            pass->second->render(time);
+            render_stage->m_stage_timer.end_block();
+            continue;
+        }
+        if (m_fused_stages.count(gid)) {
+            continue;
+        }
+
+        if (is_silent(plan, render_stage.get())) {
+            render_stage->skip_render(time);
+            continue;
+        }
+
+        AUDIO_TRACE_SCOPE(render_stage->name, "stage");
+        render_stage->m_stage_timer.begin_block();
+        render_stage->render(time);
+        render_stage->m_stage_timer.end_block();
+    }
+}
+
+std::unordered_map<AudioRenderGraph::GID, AudioStageTimer::Stats> AudioRenderGraph::get_stage_timings() {
+    std::unordered_map<GID, AudioStageTimer::Stats> timings;
+#if AUDIO_STAGE_TIMING
+    // Keep the stages alive without holding the graph lock while the statistics are computed
+    std::vector<std::shared_ptr<AudioRenderStage>> render_stages;
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_edit_mutex);
+        for (auto & gid : m_render_order) {
+            render_stages.push_back(m_render_stages_map[gid]);
+        }
+    }
+
+    for (auto & render_stage : render_stages) {
+        timings[render_stage->gid] = render_stage->get_stage_timer().get_stats();
+    }
+#endif
+    return timings;
 }
 
 bool AudioRenderGraph::insert_render_stage_behind(GID front, std::shared_ptr<AudioRenderStage> render_stage) {
@@ -224,6 +620,8 @@ bool AudioRenderGraph::insert_render_stage_infront(GID back, std::shared_ptr<Aud
 }
 
 bool AudioRenderGraph::insert_leading_render_stage(GID back, std::shared_ptr<AudioRenderStage> render_stage) {
+    EditScope edit(*this);
+
     // Make sure back exists
     if (m_render_stages_map.find(back) == m_render_stages_map.end()) {
         printf("Did not find render stage %d in graph\n", back);
@@ -235,6 +633,16 @@ bool AudioRenderGraph::insert_leading_render_stage(GID back, std::shared_ptr<Aud
         return false;
     }
 
+    // Render the same number of blocks per draw as the rest of the graph
+    if (!match_blocks_per_render(render_stage.get())) {
+        return false;
+    }
+
+    // Store the streams like the rest of the graph
+    if (!match_stream_precision(render_stage.get(), m_half_float_streams)) {
+        return false;
+    }
+
     // Initialize the render stage if not already initialized
     if (!render_stage->is_initialized()) {
         if (!render_stage->initialize()) {
@@ -249,7 +657,6 @@ bool AudioRenderGraph::insert_leading_render_stage(GID back, std::shared_ptr<Aud
 
     auto * back_render_stage = find_render_stage(back);
 
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
 
     m_render_stages_map[render_stage_gid]->connect_render_stage(back_render_stage);
 
@@ -267,7 +674,7 @@ bool AudioRenderGraph::insert_leading_render_stage(GID back, std::shared_ptr<Aud
         throw std::runtime_error("Failed to construct render order.");
     }
 
-    m_needs_update = true;
+    m_plan_changed = true;
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -279,6 +686,8 @@ bool AudioRenderGraph::insert_leading_render_stage(GID back, std::shared_ptr<Aud
 }
 
 bool AudioRenderGraph::insert_render_stage_between(GID front, GID back, std::shared_ptr<AudioRenderStage> render_stage) {
+    EditScope edit(*this);
+
     // Make sure front exists
     if (m_render_stages_map.find(front) == m_render_stages_map.end()) {
         printf("Did not find render stage %d in graph\n", front);
@@ -295,6 +704,16 @@ bool AudioRenderGraph::insert_render_stage_between(GID front, GID back, std::sha
         return false;
     }
 
+    // Render the same number of blocks per draw as the rest of the graph
+    if (!match_blocks_per_render(render_stage.get())) {
+        return false;
+    }
+
+    // Store the streams like the rest of the graph
+    if (!match_stream_precision(render_stage.get(), m_half_float_streams)) {
+        return false;
+    }
+
     // Initialize the render stage if not already initialized
     if (!render_stage->is_initialized()) {
         if (!render_stage->initialize()) {
@@ -319,7 +738,6 @@ bool AudioRenderGraph::insert_render_stage_between(GID front, GID back, std::sha
         return false;
     }
 
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
 
     front_render_stage->disconnect_render_stage(back_render_stage);
 
@@ -341,7 +759,7 @@ bool AudioRenderGraph::insert_render_stage_between(GID front, GID back, std::sha
         throw std::runtime_error("Failed to construct render order.");
     }
 
-    m_needs_update = true;
+    m_plan_changed = true;
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -352,15 +770,9 @@ bool AudioRenderGraph::insert_render_stage_between(GID front, GID back, std::sha
     return true;
 }
 
-void AudioRenderGraph::bind() {
-    // If the render order changed, rebind the render stages
-    if (m_needs_update) {
-        bind_render_stages();
-        m_needs_update = false;
-    }
-}
-
 std::shared_ptr<AudioRenderStage> AudioRenderGraph::remove_render_stage(GID gid) {
+    EditScope edit(*this);
+
     // Make sure render stage exists
     if (m_render_stages_map.find(gid) == m_render_stages_map.end()) {
         printf("Did not find render stage %d in graph\n", gid);
@@ -383,7 +795,6 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::remove_render_stage(GID gid)
         return nullptr;
     }
 
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
     // move out the render stage
     auto current = m_render_stages_map[gid];
     m_render_stages_map.erase(gid);
@@ -421,7 +832,7 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::remove_render_stage(GID gid)
         throw std::runtime_error("Failed to construct render order.");
     }
 
-    m_needs_update = true;
+    m_plan_changed = true;
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -433,6 +844,8 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::remove_render_stage(GID gid)
 }
 
 std::shared_ptr<AudioRenderStage> AudioRenderGraph::replace_render_stage(GID gid, std::shared_ptr<AudioRenderStage> render_stage) {
+    EditScope edit(*this);
+
     // TODO: If its a generator, pass the current play list to the new render stage so it can continue without stopping
     // Make sure render stage exists
     if (m_render_stages_map.find(gid) == m_render_stages_map.end()) {
@@ -446,6 +859,16 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::replace_render_stage(GID gid
         return nullptr;
     }
 
+    // Render the same number of blocks per draw as the rest of the graph
+    if (!match_blocks_per_render(render_stage.get())) {
+        return nullptr;
+    }
+
+    // Store the streams like the rest of the graph
+    if (!match_stream_precision(render_stage.get(), m_half_float_streams)) {
+        return nullptr;
+    }
+
     // Initialize the render stage if not already initialized
     if (!render_stage->is_initialized()) {
         if (!render_stage->initialize()) {
@@ -462,7 +885,6 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::replace_render_stage(GID gid
 
     printf("Replacing render stage %d with %d\n", gid, render_stage->gid);
 
-    std::lock_guard<std::mutex> guard(m_graph_mutex);
     // Disconnect inputs
     for (AudioRenderStage * input : inputs) {
         input->disconnect_render_stage(m_render_stages_map[gid].get());
@@ -502,7 +924,7 @@ std::shared_ptr<AudioRenderStage> AudioRenderGraph::replace_render_stage(GID gid
         throw std::runtime_error("Failed to construct render order.");
     }
 
-    m_needs_update = true;
+    m_plan_changed = true;
 
     printf("Render stage order: ");
     for (auto & gid : m_render_order) {
@@ -11,6 +11,8 @@
 #include "audio_render_stage/audio_multitrack_join_render_stage.h"
 #include "audio_render_stage/audio_file_generator_render_stage.h"
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "utilities/shader_registry.h"
+#include "audio_core/audio_fused_render_pass.h"
 
 const std::vector<std::string> AudioRenderStage::default_frag_shader_imports = {
     "build/shaders/global_settings.glsl",
@@ -188,7 +190,7 @@ bool AudioRenderStage::initialize_stage_parameters() {
     }
 
 
-    for (auto &[name, param] : m_parameters) {
+    for (auto & param : m_parameters) {
         // Link parameter to the stage
         if (!param->initialize(m_framebuffer, m_shader_program.get())) {
             printf("Error: Failed to initialize parameter %s\n", param->name.c_str());
@@ -208,7 +210,7 @@ bool AudioRenderStage::bind() {
     // Bind the framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
     // bind the parameters to the next render stage
-    for (auto & [name, param] : m_parameters) {
+    for (auto & param : m_parameters) {
         if (!param->bind()) {
             printf("Error: Failed to process linked parameters for %s\n", param->name.c_str());
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -223,7 +225,7 @@ bool AudioRenderStage::unbind() {
     // Unbind the framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     // unbind the parameters to the next render stage
-    for (auto & [name, param] : m_parameters) {
+    for (auto & param : m_parameters) {
         if (!param->unbind()) {
             printf("Error: Failed to process linked parameters for %s\n", param->name.c_str());
             return false;
@@ -238,18 +240,61 @@ void AudioRenderStage::render(const unsigned int time) {
     }
 
     m_time = time;
+    m_output_silenced = false;
 
     // Use the shader program of the stage
     glUseProgram(m_shader_program->get_program());
 
+    // Stages built from the same sources share one linked program, and with it the uniform values
+    if (m_shader_program->claim_program_state()) {
+        for (auto & param : m_parameters) {
+            param->reset_program_state();
+        }
+    }
+
     // Bind the framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
 
+    // The audio textures hold m_blocks_per_render blocks of num_channels rows
+    glViewport(0, 0, frames_per_buffer / m_samples_per_texel, num_channels * m_blocks_per_render);
+
     // Render parameters
-    for (auto & [name, param] : m_parameters) {
-        param->render();
+    {
+        AudioStageTimer::Scope upload_scope(m_stage_timer, AudioStageTimer::Phase::UPLOAD);
+        for (auto & param : m_parameters) {
+            param->render();
+        }
+    }
+
+    AudioStageTimer::Scope draw_scope(m_stage_timer, AudioStageTimer::Phase::DRAW);
+
+    apply_draw_buffers();
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    m_stage_timer.begin_gpu();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    m_stage_timer.end_gpu();
+
+    // unbind the framebuffer and texture and shader program
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glUseProgram(0);
+}
+
+void AudioRenderStage::skip_render(const unsigned int time) {
+    m_time = time;
+    if (m_output_silenced) {
+        return;
     }
 
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    apply_draw_buffers();
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_output_silenced = true;
+}
+
+void AudioRenderStage::apply_draw_buffers() {
     // CRITICAL: glDrawBuffers array indices map to shader output layout locations.
     // drawBuffers[0] maps to layout(location=0), drawBuffers[1] maps to layout(location=1), etc.
     // The array must have exactly as many elements as there are shader outputs, and indices must match.
@@ -267,25 +312,60 @@ void AudioRenderStage::render(const unsigned int time) {
             glDrawBuffers(max_index + 1, m_draw_buffers.data());
         }
     }
+}
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+bool AudioRenderStage::is_fusible() const {
+    if (!supports_fusion() || !m_plugins.empty() || m_stream_audio_texture == nullptr) {
+        return false;
+    }
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    // The stream is the only texture a point-wise stage samples
+    for (auto & param : m_parameters) {
+        if (dynamic_cast<AudioUniformBufferParameter *>(param.get())) {
+            return false;
+        }
+        if (dynamic_cast<AudioTexture2DParameter *>(param.get()) && param.get() != m_stream_audio_texture &&
+            param->connection_type != AudioParameter::ConnectionType::OUTPUT) {
+            return false;
+        }
+    }
 
-    // unbind the framebuffer and texture and shader program
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glUseProgram(0);
+    return AudioFusedRenderPass::is_point_wise_source(get_fragment_shader_body());
+}
+
+std::string AudioRenderStage::get_fragment_shader_body() const {
+    return m_uses_shader_string ? m_fragment_shader_source_string : get_shader_source(m_fragment_shader_path);
+}
+
+// Render order of a parameter: textures, then uniform buffers, then plain uniforms,
+// so the per-block loop groups the same kind of GL state changes together
+static unsigned int parameter_render_order(const AudioParameter * parameter) {
+    if (dynamic_cast<const AudioTexture2DParameter *>(parameter)) {
+        return 0;
+    }
+    if (dynamic_cast<const AudioUniformBufferParameter *>(parameter)) {
+        return 1;
+    }
+    return 2;
 }
 
 bool AudioRenderStage::add_parameter(AudioParameter * parameter) {
-    // Put in the parameter list
-    m_parameters[parameter->name] = std::unique_ptr<AudioParameter>(parameter);
+    // A parameter with the same name is replaced
+    if (find_parameter(parameter->name) != nullptr) {
+        remove_parameter(parameter->name);
+    }
+
+    // Put in the parameter list after the parameters of the same render order
+    const unsigned int order = parameter_render_order(parameter);
+    auto position = std::find_if(m_parameters.begin(), m_parameters.end(),
+                                 [order](const std::unique_ptr<AudioParameter> & param) { return parameter_render_order(param.get()) > order; });
+    m_parameters.insert(position, std::unique_ptr<AudioParameter>(parameter));
 
     // Add to the input or output list
     if (parameter->connection_type == AudioParameter::ConnectionType::INPUT) {
-        m_input_parameters.push_back(m_parameters[parameter->name].get());
+        m_input_parameters.push_back(parameter);
     } else if (parameter->connection_type == AudioParameter::ConnectionType::OUTPUT) {
-        m_output_parameters.push_back(m_parameters[parameter->name].get());
+        m_output_parameters.push_back(parameter);
         
         // If it's an AudioTexture2DParameter output, add to draw buffers
         if (auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(parameter)) {
@@ -304,18 +384,19 @@ bool AudioRenderStage::add_parameter(AudioParameter * parameter) {
             m_draw_buffers[index] = draw_buffer;
         }
     }
+
+    resolve_parameters();
     return true;
 }
 
 bool AudioRenderStage::remove_parameter(const std::string & name) {
     // Check if the parameter exists
-    if (m_parameters.find(name) == m_parameters.end()) {
+    auto* param = find_parameter(name);
+    if (param == nullptr) {
         std::cerr << "Error: Parameter " << name << " not found." << std::endl;
         return false;
     }
 
-    auto* param = m_parameters[name].get();
-
     // If it's an AudioTexture2DParameter output, remove from draw buffers
     if (param->connection_type == AudioParameter::ConnectionType::OUTPUT) {
         if (auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(param)) {
@@ -344,15 +425,26 @@ bool AudioRenderStage::remove_parameter(const std::string & name) {
         }
     }
 
-    // Remove from the parameter map
-    m_parameters.erase(name);
+    // Remove from the parameter list
+    m_parameters.erase(std::find_if(m_parameters.begin(), m_parameters.end(),
+                                    [param](const std::unique_ptr<AudioParameter> & p) { return p.get() == param; }));
+
+    // No handle may keep pointing to the deleted parameter
+    resolve_parameters();
 
     return true;
 }
 
+void AudioRenderStage::resolve_parameters() {
+    m_stream_audio_texture = dynamic_cast<AudioTexture2DParameter *>(find_parameter("stream_audio_texture"));
+    m_output_audio_texture = dynamic_cast<AudioTexture2DParameter *>(find_parameter("output_audio_texture"));
+}
+
 AudioParameter * AudioRenderStage::find_parameter(const std::string name) const {
-    if (m_parameters.find(name) != m_parameters.end()) {
-        return m_parameters.at(name).get();
+    for (auto & param : m_parameters) {
+        if (param->name == name) {
+            return param.get();
+        }
     }
     return nullptr;
 }  
@@ -387,147 +479,17 @@ bool AudioRenderStage::register_plugin(AudioRenderStagePlugin* plugin) {
 }
 
 const std::string AudioRenderStage::get_shader_source(const std::string & file_path) {
-    // Open file
-    FILE * file = fopen(file_path.c_str(), "r");
-    if (!file) {
-        std::cerr << "Error: Failed to open file " << file_path << std::endl;
-        return nullptr;
-    }
-
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    // load the vertex shader source code
-    GLchar * source = new GLchar[length + 1];
-    fread(source, 1, length, file);
-    source[length] = '\0';
-
-    // Close file
-    fclose(file);
-
-    return std::string(source);
+    return ShaderRegistry::get_source(file_path);
 }
 
 const std::string AudioRenderStage::combine_shader_source(const std::vector<std::string> & import_paths, const std::string & shader_path) {
-    std::string combined_source = "";
-    bool version_added = false;
-    
-    for (auto & import_path : import_paths) {
-        std::string import_source = get_shader_source(import_path);
-        
-        // Check if this import contains a #version directive
-        if (import_source.find("#version") != std::string::npos) {
-            if (!version_added) {
-                // Find the first #version line and add it
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                    // Add the rest of the import source without the #version line
-                    combined_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_source += import_source;
-                }
-                version_added = true;
-            } else {
-                // Remove #version line from subsequent imports
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_source += import_source;
-                }
-            }
-        } else {
-            combined_source += import_source;
-        }
-        combined_source += "\n";
-    }
-    
-    std::string shader_source = get_shader_source(shader_path);
-    
-    // Check if the main shader has a #version directive
-    if (shader_source.find("#version") != std::string::npos) {
-        if (!version_added) {
-            // If no version was added yet, keep the one from the main shader
-            combined_source += shader_source;
-        } else {
-            // Remove #version line from main shader
-            size_t version_pos = shader_source.find("#version");
-            size_t newline_pos = shader_source.find('\n', version_pos);
-            if (newline_pos != std::string::npos) {
-                combined_source += shader_source.substr(newline_pos + 1);
-            } else {
-                combined_source += shader_source;
-            }
-        }
-    } else {
-        combined_source += shader_source;
-    }
-
-    return combined_source;
+    return combine_shader_source_with_string(import_paths, get_shader_source(shader_path));
 }
 
 const std::string AudioRenderStage::combine_shader_source_with_string(const std::vector<std::string> & import_paths, const std::string & shader_source) {
-    std::string combined_source = "";
     bool version_added = false;
-    
-    for (auto & import_path : import_paths) {
-        std::string import_source = get_shader_source(import_path);
-        
-        // Check if this import contains a #version directive
-        if (import_source.find("#version") != std::string::npos) {
-            if (!version_added) {
-                // Find the first #version line and add it
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                    // Add the rest of the import source without the #version line
-                    combined_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_source += import_source;
-                }
-                version_added = true;
-            } else {
-                // Remove #version line from subsequent imports
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_source += import_source;
-                }
-            }
-        } else {
-            combined_source += import_source;
-        }
-        combined_source += "\n";
-    }
-    
-    // Use the provided shader source string instead of reading from file
-    // Check if the shader source has a #version directive
-    if (shader_source.find("#version") != std::string::npos) {
-        if (!version_added) {
-            // If no version was added yet, keep the one from the shader source
-            combined_source += shader_source;
-        } else {
-            // Remove #version line from shader source
-            size_t version_pos = shader_source.find("#version");
-            size_t newline_pos = shader_source.find('\n', version_pos);
-            if (newline_pos != std::string::npos) {
-                combined_source += shader_source.substr(newline_pos + 1);
-            } else {
-                combined_source += shader_source;
-            }
-        }
-    } else {
-        combined_source += shader_source;
-    }
-
+    std::string combined_source = ShaderRegistry::combine_imports(import_paths, version_added);
+    ShaderRegistry::append_source(combined_source, version_added, shader_source);
     return combined_source;
 }
 
@@ -662,7 +624,7 @@ bool AudioRenderStage::disconnect_render_stage() {
 }
 
 void AudioRenderStage::print_input_textures() {
-    for (auto & [name, input] : m_parameters) {
+    for (auto & input : m_parameters) {
         if (input->connection_type == AudioParameter::ConnectionType::PASSTHROUGH) {
             if (dynamic_cast<AudioTexture2DParameter *>(input.get())) {
                 printf("Input 2DTexture parameter %s in render stage %d\n", input->name.c_str(), this->gid);
@@ -677,7 +639,7 @@ void AudioRenderStage::print_input_textures() {
 }
 
 void AudioRenderStage::clear_input_textures() {
-    for (auto & [name, input] : m_parameters) {
+    for (auto & input : m_parameters) {
         if (input->connection_type == AudioParameter::ConnectionType::PASSTHROUGH) {
             if (dynamic_cast<AudioTexture2DParameter *>(input.get())) {
                 printf("Clearing input 2DTexture parameter %s in render stage %d\n", input->name.c_str(), this->gid);
@@ -688,7 +650,7 @@ void AudioRenderStage::clear_input_textures() {
 }
 
 void AudioRenderStage::print_output_textures() {
-    for (auto & [name, output] : m_parameters) {
+    for (auto & output : m_parameters) {
         if (output->connection_type == AudioParameter::ConnectionType::OUTPUT) {
             if (auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(output.get())) {
                 printf("Output 2DTexture parameter %s in render stage %d\n", output->name.c_str(), this->gid);
@@ -732,12 +694,17 @@ void AudioRenderStage::setup_default_parameters() {
                                     width, height,
                                     0,
                                     m_color_attachment_count++, GL_NEAREST);
+#if AUDIO_DEBUG_OUTPUTS
     auto debug_audio_texture =
         new AudioTexture2DParameter("debug_audio_texture",
                                     AudioParameter::ConnectionType::OUTPUT,
                                     width, height,
                                     0,
                                     m_color_attachment_count++, GL_NEAREST);
+#else
+    // Keep its attachment free so the outputs after it stay at their layout locations
+    m_color_attachment_count++;
+#endif
 
     auto buffer_size =
         new AudioIntParameter("buffer_size",
@@ -753,6 +720,11 @@ void AudioRenderStage::setup_default_parameters() {
         new AudioIntParameter("sample_rate",
                   AudioParameter::ConnectionType::INITIALIZATION);
     samp_rate->set_value(sample_rate);
+
+    auto n_blocks =
+        new AudioIntParameter("num_blocks",
+                  AudioParameter::ConnectionType::INITIALIZATION);
+    n_blocks->set_value(m_blocks_per_render);
     
     if (!this->add_parameter(output_audio_texture)) {
         std::cerr << "Failed to add output_audio_texture" << std::endl;
@@ -760,9 +732,11 @@ void AudioRenderStage::setup_default_parameters() {
     if (!this->add_parameter(stream_audio_texture)) {
         std::cerr << "Failed to add stream_audio_texture" << std::endl;
     }
+#if AUDIO_DEBUG_OUTPUTS
     if (!this->add_parameter(debug_audio_texture)) {
         std::cerr << "Failed to add debug_audio_texture" << std::endl;
     }
+#endif
     if (!this->add_parameter(buffer_size)) {
         std::cerr << "Failed to add buffer_size" << std::endl;
     }
@@ -772,10 +746,77 @@ void AudioRenderStage::setup_default_parameters() {
     if (!this->add_parameter(samp_rate)) {
         std::cerr << "Failed to add sample_rate" << std::endl;
     }
+    if (!this->add_parameter(n_blocks)) {
+        std::cerr << "Failed to add num_blocks" << std::endl;
+    }
+}
+
+bool AudioRenderStage::set_blocks_per_render(const unsigned int blocks_per_render) {
+    if (m_initialized) {
+        std::cerr << "Error: Blocks per render must be set before initialization of " << name << std::endl;
+        return false;
+    }
+    if (blocks_per_render == 0) {
+        std::cerr << "Error: Blocks per render must be at least 1" << std::endl;
+        return false;
+    }
+    if (blocks_per_render > 1 && !supports_batching()) {
+        std::cerr << "Error: Render stage " << name << " does not support batched rendering" << std::endl;
+        return false;
+    }
+
+    // Every texture shaped like an audio block (stream, output, debug, ...) grows with the batch.
+    // Plugin textures such as histories have their own dimensions and are left alone.
+    const GLuint block_rows = num_channels * m_blocks_per_render;
+    for (auto & param : m_parameters) {
+        auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(param.get());
+        if (texture_param == nullptr) {
+            continue;
+        }
+        const GLuint block_width = frames_per_buffer / texture_param->get_samples_per_texel();
+        if (texture_param->get_width() == block_width && texture_param->get_height() == block_rows) {
+            if (!texture_param->resize(block_width, num_channels * blocks_per_render)) {
+                return false;
+            }
+        }
+    }
+
+    auto * n_blocks = find_parameter("num_blocks");
+    if (n_blocks) {
+        n_blocks->set_value(static_cast<int>(blocks_per_render));
+    }
+
+    m_blocks_per_render = blocks_per_render;
+    return true;
+}
+
+bool AudioRenderStage::set_half_float_streams(const bool half_float) {
+    if (m_initialized) {
+        std::cerr << "Error: Stream precision must be set before initialization of " << name << std::endl;
+        return false;
+    }
+    if (half_float && !supports_half_float_streams()) {
+        std::cerr << "Error: Render stage " << name << " does not support half float streams" << std::endl;
+        return false;
+    }
+
+    // The streams are the textures the stages before this one render into
+    for (auto & param : m_parameters) {
+        auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(param.get());
+        if (texture_param == nullptr || param->connection_type != AudioParameter::ConnectionType::PASSTHROUGH) {
+            continue;
+        }
+        if (!texture_param->set_half_float(half_float)) {
+            return false;
+        }
+    }
+
+    m_half_float_streams = half_float;
+    return true;
 }
 
 void AudioRenderStage::clear_output_textures() {
-    for (auto & [name, output] : m_parameters) {
+    for (auto & output : m_parameters) {
         if (output->connection_type == AudioParameter::ConnectionType::OUTPUT) {
             if (auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(output.get())) {
                 printf("Clearing output 2DTexture parameter %s in render stage %d\n", output->name.c_str(), this->gid);
@@ -798,198 +839,33 @@ void AudioRenderStage::clear_output_textures() {
 
 void AudioRenderStage::rebuild_shader_sources() {
     // Start with initial imports (no plugin-specific processing needed for these)
-    std::string combined_frag_source = "";
-    std::string combined_vert_source = "";
     bool frag_version_added = false;
     bool vert_version_added = false;
-    
-    // Process initial fragment shader imports
-    for (const auto& import_path : m_initial_frag_shader_imports) {
-        std::string import_source = get_shader_source(import_path);
-        
-        // Handle #version directive
-        if (import_source.find("#version") != std::string::npos) {
-            if (!frag_version_added) {
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_frag_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                    combined_frag_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_frag_source += import_source;
-                }
-                frag_version_added = true;
-            } else {
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_frag_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_frag_source += import_source;
-                }
-            }
-        } else {
-            combined_frag_source += import_source;
-        }
-        combined_frag_source += "\n";
-    }
-    
-    // Process initial vertex shader imports
-    for (const auto& import_path : m_initial_vert_shader_imports) {
-        std::string import_source = get_shader_source(import_path);
-        
-        // Handle #version directive
-        if (import_source.find("#version") != std::string::npos) {
-            if (!vert_version_added) {
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_vert_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                    combined_vert_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_vert_source += import_source;
-                }
-                vert_version_added = true;
-            } else {
-                size_t version_pos = import_source.find("#version");
-                size_t newline_pos = import_source.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_vert_source += import_source.substr(newline_pos + 1);
-                } else {
-                    combined_vert_source += import_source;
-                }
-            }
-        } else {
-            combined_vert_source += import_source;
-        }
-        combined_vert_source += "\n";
-    }
+    std::string combined_frag_source = ShaderRegistry::combine_imports(m_initial_frag_shader_imports, frag_version_added);
+    std::string combined_vert_source = ShaderRegistry::combine_imports(m_initial_vert_shader_imports, vert_version_added);
 
     // Process each plugin's shader imports separately - plugins handle their own replacements
     for (auto* registered_plugin : m_plugins) {
-        // Process fragment shader imports for this plugin
-        auto frag_imports = registered_plugin->get_fragment_shader_imports();
-        for (const auto& import_path : frag_imports) {
-            // Get processed shader source from plugin (with replacements already applied)
-            std::string import_source = registered_plugin->get_processed_fragment_shader_source(import_path);
-            
-            // Handle #version directive (skip if already added)
-            if (import_source.find("#version") != std::string::npos) {
-                if (!frag_version_added) {
-                    size_t version_pos = import_source.find("#version");
-                    size_t newline_pos = import_source.find('\n', version_pos);
-                    if (newline_pos != std::string::npos) {
-                        combined_frag_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                        combined_frag_source += import_source.substr(newline_pos + 1);
-                    } else {
-                        combined_frag_source += import_source;
-                    }
-                    frag_version_added = true;
-                } else {
-                    size_t version_pos = import_source.find("#version");
-                    size_t newline_pos = import_source.find('\n', version_pos);
-                    if (newline_pos != std::string::npos) {
-                        combined_frag_source += import_source.substr(newline_pos + 1);
-                    } else {
-                        combined_frag_source += import_source;
-                    }
-                }
-            } else {
-                combined_frag_source += import_source;
-            }
+        for (const auto& import_path : registered_plugin->get_fragment_shader_imports()) {
+            ShaderRegistry::append_source(combined_frag_source, frag_version_added,
+                                          registered_plugin->get_processed_fragment_shader_source(import_path));
             combined_frag_source += "\n";
         }
-        
-        // Process vertex shader imports for this plugin
-        auto vert_imports = registered_plugin->get_vertex_shader_imports();
-        for (const auto& import_path : vert_imports) {
-            // Get processed shader source from plugin (with replacements already applied)
-            std::string import_source = registered_plugin->get_processed_vertex_shader_source(import_path);
-            
-            // Handle #version directive (skip if already added)
-            if (import_source.find("#version") != std::string::npos) {
-                if (!vert_version_added) {
-                    size_t version_pos = import_source.find("#version");
-                    size_t newline_pos = import_source.find('\n', version_pos);
-                    if (newline_pos != std::string::npos) {
-                        combined_vert_source += import_source.substr(version_pos, newline_pos - version_pos + 1);
-                        combined_vert_source += import_source.substr(newline_pos + 1);
-                    } else {
-                        combined_vert_source += import_source;
-                    }
-                    vert_version_added = true;
-                } else {
-                    size_t version_pos = import_source.find("#version");
-                    size_t newline_pos = import_source.find('\n', version_pos);
-                    if (newline_pos != std::string::npos) {
-                        combined_vert_source += import_source.substr(newline_pos + 1);
-                    } else {
-                        combined_vert_source += import_source;
-                    }
-                }
-            } else {
-                combined_vert_source += import_source;
-            }
+
+        for (const auto& import_path : registered_plugin->get_vertex_shader_imports()) {
+            ShaderRegistry::append_source(combined_vert_source, vert_version_added,
+                                          registered_plugin->get_processed_vertex_shader_source(import_path));
             combined_vert_source += "\n";
         }
     }
 
     // Add main shader sources
     if (m_uses_shader_string) {
-        std::string main_shader = m_fragment_shader_source_string;
-        if (main_shader.find("#version") != std::string::npos) {
-            if (!frag_version_added) {
-                combined_frag_source += main_shader;
-                frag_version_added = true;
-            } else {
-                size_t version_pos = main_shader.find("#version");
-                size_t newline_pos = main_shader.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_frag_source += main_shader.substr(newline_pos + 1);
-                } else {
-                    combined_frag_source += main_shader;
-                }
-            }
-        } else {
-            combined_frag_source += main_shader;
-        }
-    } else {
-        std::string main_shader = get_shader_source(m_fragment_shader_path);
-        if (main_shader.find("#version") != std::string::npos) {
-            if (!frag_version_added) {
-                combined_frag_source += main_shader;
-                frag_version_added = true;
-            } else {
-                size_t version_pos = main_shader.find("#version");
-                size_t newline_pos = main_shader.find('\n', version_pos);
-                if (newline_pos != std::string::npos) {
-                    combined_frag_source += main_shader.substr(newline_pos + 1);
-                } else {
-                    combined_frag_source += main_shader;
-                }
-            }
-        } else {
-            combined_frag_source += main_shader;
-        }
-    }
-    
-    std::string vert_shader = get_shader_source(m_vertex_shader_path);
-    if (vert_shader.find("#version") != std::string::npos) {
-        if (!vert_version_added) {
-            combined_vert_source += vert_shader;
-            vert_version_added = true;
-        } else {
-            size_t version_pos = vert_shader.find("#version");
-            size_t newline_pos = vert_shader.find('\n', version_pos);
-            if (newline_pos != std::string::npos) {
-                combined_vert_source += vert_shader.substr(newline_pos + 1);
-            } else {
-                combined_vert_source += vert_shader;
-            }
-        }
+        ShaderRegistry::append_source(combined_frag_source, frag_version_added, m_fragment_shader_source_string);
     } else {
-        combined_vert_source += vert_shader;
+        ShaderRegistry::append_source(combined_frag_source, frag_version_added, get_shader_source(m_fragment_shader_path));
     }
+    ShaderRegistry::append_source(combined_vert_source, vert_version_added, get_shader_source(m_vertex_shader_path));
 
     m_fragment_shader_source = combined_frag_source;
     m_vertex_shader_source = combined_vert_source;
@@ -4,11 +4,16 @@
 #include <cstring>
 #include <thread>
 #include <condition_variable>
+#include <algorithm>
+#include <chrono>
 
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
 #include "audio_render_stage/audio_final_render_stage.h"
 #include "audio_core/audio_renderer.h"
 #include "audio_core/audio_render_graph.h"
+#include "audio_core/audio_control.h"
+#include "utilities/egl_compatibility.h"
+#include "utilities/audio_tracer.h"
 
 AudioRenderer * AudioRenderer::instance = nullptr;
 
@@ -25,6 +30,13 @@ AudioRenderer::AudioRenderer() {
 
 bool AudioRenderer::add_render_output(AudioOutput * output_link)
 {
+    // The render thread walks the outputs, so the list only changes between blocks
+    if (is_foreign_thread()) {
+        return post_command([this, output_link]() {
+            output_link->set_demand_signal(&m_output_demand);
+            m_render_outputs.push_back(std::unique_ptr<AudioOutput>(output_link));
+        });
+    }
     m_render_outputs.push_back(std::unique_ptr<AudioOutput>(output_link));
     return true;
 }
@@ -116,13 +128,59 @@ bool AudioRenderer::initialize(const unsigned int buffer_size, const unsigned in
     this->m_num_channels = num_channels;
     this->m_sample_rate = sample_rate;
 
-    // Initialize SDL2 using the parent class method
-    if (!initialize_sdl(buffer_size, num_channels, "Audio Processing", SDL_WINDOW_OPENGL, false)) {
+    if (m_headless) {
+        // No window or windowing system, the context is only used for offscreen rendering
+        if (!EGLCompatibility::initialize_headless_context(m_headless_context)) {
+            std::cerr << "Error: Failed to create headless context for audio rendering." << std::endl;
+            return false;
+        }
+    } else if (!initialize_sdl(buffer_size, num_channels, "Audio Processing", SDL_WINDOW_OPENGL, false)) {
+        // Initialize SDL2 using the parent class method
         return false;
     }
 
     activate_render_context(); // Set the current context for this thread
 
+    if (!initialize_render_resources()) {
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+bool AudioRenderer::set_headless(const bool headless)
+{
+    if (m_initialized || is_render_thread_running()) {
+        std::cerr << "Error: Cannot change the context type after initialization." << std::endl;
+        return false;
+    }
+    m_headless = headless;
+    return true;
+}
+
+bool AudioRenderer::set_readback_latency(const unsigned int blocks)
+{
+    // Rebuilding the readback ring would drop the blocks already in flight
+    if (m_initialized || is_render_thread_running()) {
+        std::cerr << "Error: Readback latency must be set before initialization." << std::endl;
+        return false;
+    }
+    m_readback_latency = blocks;
+    return true;
+}
+
+void AudioRenderer::activate_render_context()
+{
+    if (m_headless_context != EGL_NO_CONTEXT) {
+        EGLCompatibility::make_headless_current(m_headless_context);
+        return;
+    }
+    IRenderableEntity::activate_render_context();
+}
+
+bool AudioRenderer::initialize_render_resources()
+{
     // Set GL settings for audio rendering
     glDisable(GL_BLEND);
     glDisable(GL_DEPTH_TEST);
@@ -140,6 +198,13 @@ bool AudioRenderer::initialize(const unsigned int buffer_size, const unsigned in
         return false;
     }
 
+    // The outputs are handed the blocks read back m_readback_latency renders ago
+    if (m_readback_latency > 0 &&
+        !m_render_graph->get_output_render_stage()->set_readback_latency(m_readback_latency)) {
+        std::cerr << "Failed to set the readback latency of the output stage." << std::endl;
+        return false;
+    }
+
     // Initialize global parameters
     if (!initialize_global_parameters()) {
         std::cerr << "Failed to initialize time parameters." << std::endl;
@@ -155,16 +220,216 @@ bool AudioRenderer::initialize(const unsigned int buffer_size, const unsigned in
     // Initialize the textures with data
     render();
 
-    m_initialized = true;
     return true;
 }
 
+void AudioRenderer::release_render_resources()
+{
+    // Delete the vertex array and buffer only if they are initialized
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+        m_VAO = 0;
+    }
+    if (m_VBO) {
+        glDeleteBuffers(1, &m_VBO);
+        m_VBO = 0;
+    }
+
+    // GL objects owned by the graph and parameters must go before the context
+    m_idle_tasks.clear();
+    m_global_parameters.clear();
+    m_render_graph.reset();
+}
+
+bool AudioRenderer::initialize_render_thread(const unsigned int buffer_size, const unsigned int sample_rate, const unsigned int num_channels)
+{
+    if (m_initialized || is_render_thread_running()) {
+        std::cerr << "Error: Audio renderer already initialized." << std::endl;
+        return false;
+    }
+
+    if (m_render_graph == nullptr) {
+        std::cerr << "Error: No render graph added." << std::endl;
+        return false;
+    }
+
+    this->m_buffer_size = buffer_size;
+    this->m_num_channels = num_channels;
+    this->m_sample_rate = sample_rate;
+
+    // Outputs wake the thread up as soon as they have room for another block
+    for (auto& output : m_render_outputs) {
+        output->set_demand_signal(&m_output_demand);
+    }
+
+    std::promise<bool> started;
+    auto started_result = started.get_future();
+    m_render_thread_running = true;
+    m_render_thread = std::thread(&AudioRenderer::render_thread_main, this, std::move(started));
+
+    if (!started_result.get()) {
+        stop_render_thread();
+        return false;
+    }
+
+    // Control changes from the UI now reach the graph between two blocks. A setter that does not fit
+    // in the queue is rejected rather than run concurrently with the render, the control keeps its value
+    AudioControlBase::set_setter_dispatcher([this](std::function<void()>& setter) {
+        return post_command(std::move(setter));
+    });
+    return true;
+}
+
+void AudioRenderer::stop_render_thread()
+{
+    AudioControlBase::set_setter_dispatcher(nullptr);
+
+    if (m_render_thread.joinable()) {
+        m_render_thread_running = false;
+        m_output_demand.release();
+        m_render_thread.join();
+    }
+    m_render_thread_running = false;
+
+    // The commands that ran are destroyed here, the producer side, never on the render thread
+    m_commands.release_executed();
+
+    for (auto& output : m_render_outputs) {
+        output->set_demand_signal(nullptr);
+    }
+}
+
+bool AudioRenderer::post_command(std::function<void()> command)
+{
+    if (!is_foreign_thread()) {
+        command();
+        return true;
+    }
+
+    if (!m_commands.push(std::move(command))) {
+        std::cerr << "Error: Render command queue full, command dropped." << std::endl;
+        return false;
+    }
+    m_output_demand.release();
+    return true;
+}
+
+bool AudioRenderer::add_idle_task(std::function<void()> task, const std::string & kind)
+{
+    return post_command([this, task = std::move(task), kind]() mutable {
+        m_idle_tasks.push_back(IdleTask{std::move(task), kind});
+    });
+}
+
+float AudioRenderer::expected_idle_task_seconds(const std::string & kind) const
+{
+    auto estimate = m_idle_task_seconds.find(kind);
+    if (estimate != m_idle_task_seconds.end()) {
+        return estimate->second;
+    }
+
+    // A kind that never ran is expected to be as slow as the slowest one
+    if (m_idle_task_seconds.empty()) {
+        return IDLE_TASK_INITIAL_SECONDS;
+    }
+    return std::max_element(m_idle_task_seconds.begin(), m_idle_task_seconds.end(),
+                            [](const auto & a, const auto & b) { return a.second < b.second; })->second;
+}
+
+void AudioRenderer::run_idle_task()
+{
+    if (m_idle_tasks.empty() || outputs_ready() || m_lead_output == nullptr) {
+        return;
+    }
+
+    // The queued audio must cover the task and the render of the next block after it
+    IdleTask & next = m_idle_tasks.front();
+    const float block_seconds = static_cast<float>(m_buffer_size) / static_cast<float>(m_sample_rate);
+    const float expected_seconds = expected_idle_task_seconds(next.kind);
+    const float queued_seconds = m_lead_output->get_queued_seconds();
+    if (queued_seconds < expected_seconds + block_seconds) {
+        if (++next.deferrals == IDLE_TASK_DEFERRAL_WARNING) {
+            std::cerr << "Warning: Idle task '" << next.kind << "' deferred " << next.deferrals
+                      << " times, it is expected to take " << expected_seconds * 1000.0f << " ms with "
+                      << queued_seconds * 1000.0f << " ms of audio queued." << std::endl;
+        }
+        return;
+    }
+
+    IdleTask task = std::move(next);
+    m_idle_tasks.pop_front();
+    AUDIO_TRACE_SCOPE("AudioRenderer::idle_task", "audio");
+    const auto start = std::chrono::steady_clock::now();
+    task.task();
+    const float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    auto estimate = m_idle_task_seconds.find(task.kind);
+    if (estimate == m_idle_task_seconds.end()) {
+        m_idle_task_seconds[task.kind] = elapsed;
+    } else {
+        estimate->second = std::max(elapsed, IDLE_TASK_DECAY * estimate->second + (1.0f - IDLE_TASK_DECAY) * elapsed);
+    }
+}
+
+bool AudioRenderer::is_foreign_thread() const
+{
+    return m_render_thread_running.load(std::memory_order_acquire) &&
+           std::this_thread::get_id() != m_render_thread_id.load(std::memory_order_acquire);
+}
+
+void AudioRenderer::render_thread_main(std::promise<bool> started)
+{
+    m_render_thread_id = std::this_thread::get_id();
+    AudioTracer::set_thread_name("audio render");
+
+    EGLContext context = EGL_NO_CONTEXT;
+    if (!EGLCompatibility::initialize_headless_context(context)) {
+        std::cerr << "Error: Failed to create headless context for the render thread." << std::endl;
+        started.set_value(false);
+        return;
+    }
+
+    if (!initialize_render_resources()) {
+        release_render_resources();
+        EGLCompatibility::cleanup_headless_context(context);
+        started.set_value(false);
+        return;
+    }
+    m_initialized = true;
+    started.set_value(true);
+
+    // Like the EventLoop, render once up front, as the loop presents a block before it renders the next
+    render();
+
+    // Outputs that never signal demand are polled twice per block
+    const auto poll_period = std::chrono::microseconds(500000LL * m_buffer_size / m_sample_rate);
+
+    while (m_render_thread_running.load(std::memory_order_acquire)) {
+        m_commands.execute_all();
+
+        if (outputs_ready()) {
+            present();
+            render();
+        } else {
+            (void)m_output_demand.try_acquire_for(poll_period);
+        }
+    }
+
+    m_commands.execute_all();
+    m_initialized = false;
+    release_render_resources();
+    EGLCompatibility::cleanup_headless_context(context);
+}
+
 void AudioRenderer::render()
 {
     IRenderableEntity::render();
 
     // No need to call activate_render_context() here, event loop will do it
-    if (!m_initialized) return;
+    if (!m_initialized || is_foreign_thread()) return;
+
+    AudioTracer::set_block(m_frame_count);
+    AUDIO_TRACE_SCOPE("AudioRenderer::render", "audio");
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
@@ -185,6 +450,9 @@ void AudioRenderer::render()
 
     // Unbind everything
     glBindVertexArray(0);
+
+    // The next block is not due yet, so there is time for background work
+    run_idle_task();
 }
 
 void AudioRenderer::present()
@@ -192,31 +460,36 @@ void AudioRenderer::present()
     IRenderableEntity::present();
 
     // No need to call activate_render_context() here, event loop will do it
-    push_to_output_buffers(m_render_graph->get_output_render_stage()->get_output_buffer_data().data());
-    m_frame_count++;
+    if (!m_initialized || is_foreign_thread()) return;
+
+    AUDIO_TRACE_SCOPE("AudioRenderer::present", "audio");
+
+    // A batched graph hands out several consecutive blocks per render
+    const unsigned int blocks_per_render = m_render_graph->get_blocks_per_render();
+    const float * data = m_render_graph->get_output_render_stage()->get_output_buffer_data().data();
+    for (unsigned int block = 0; block < blocks_per_render; ++block) {
+        push_to_output_buffers(data + block * m_buffer_size * m_num_channels);
+    }
+    m_frame_count += blocks_per_render;
 }
 
 AudioRenderer::~AudioRenderer()
 {
+    // The render thread releases its own GL resources in its own context
+    stop_render_thread();
+
     activate_render_context();
 
     // Stop the loop
     m_initialized = false;
 
-    // Delete the vertex array and buffer only if they are initialized
-    if (m_VAO) {
-        glDeleteVertexArrays(1, &m_VAO);
-        m_VAO = 0;
-    }
-    if (m_VBO) {
-        glDeleteBuffers(1, &m_VBO);
-        m_VBO = 0;
-    }
-
+    release_render_resources();
     m_render_outputs.clear();
-    m_global_parameters.clear();
-    m_render_graph.reset();
-    m_initialized = false;
+
+    if (m_headless_context != EGL_NO_CONTEXT) {
+        EGLCompatibility::cleanup_headless_context(m_headless_context);
+        m_headless_context = EGL_NO_CONTEXT;
+    }
     m_frame_count = 0;
     m_lead_output = nullptr;
 }
@@ -224,12 +497,22 @@ AudioRenderer::~AudioRenderer()
 void AudioRenderer::push_to_output_buffers(const float * data)
 {
     m_increment = false;
+    // Each output queues the block for its own consumer, no ring sits in between
     for (auto& output : m_render_outputs) {
+        AUDIO_TRACE_SCOPE("AudioOutput::push", "output");
         output->push(data);
     }
 }
 
 bool AudioRenderer::is_ready() {
+    // The render thread paces itself, the EventLoop only runs the renderer without one
+    if (is_render_thread_running()) {
+        return false;
+    }
+    return outputs_ready();
+}
+
+bool AudioRenderer::outputs_ready() {
 
     if (m_increment) {
         return true;
@@ -275,5 +558,3 @@ AudioParameter * AudioRenderer::find_global_parameter(const std::string name) co
     }
     return nullptr;
 }
-
-// Now using the base class implementation of activate_render_context()
\ No newline at end of file
@@ -203,6 +203,7 @@ void AudioTape::record(const float * audio_stream_data, unsigned int samples_off
         // Shift window forward if needed (drop oldest)
         if (write_end_global > window_end_exclusive) {
             unsigned int shift = write_end_global - window_end_exclusive;
+            log_modified_range(window_start, window_start + std::min(shift, capacity));
             if (shift >= capacity) {
                 for (auto &ch : m_data) {
                     std::fill(ch.begin(), ch.end(), 0.0f);
@@ -220,6 +221,8 @@ void AudioTape::record(const float * audio_stream_data, unsigned int samples_off
         // Shift window backward if needed (prepend zeros)
         if (write_start_global < window_start) {
             unsigned int shift_back = window_start - write_start_global;
+            // The record position does not move back with the data, so the whole window changes
+            log_modified_range(window_start, window_end_exclusive);
             if (shift_back >= capacity) {
                 for (auto &ch : m_data) {
                     std::fill(ch.begin(), ch.end(), 0.0f);
@@ -243,6 +246,8 @@ void AudioTape::record(const float * audio_stream_data, unsigned int samples_off
             std::copy_n(src, m_frames_per_buffer, dst);
         }
 
+        log_modified_range(write_start_global, write_end_global);
+
         if (m_current_record_position < write_end_global) {
             m_current_record_position = write_end_global;
         }
@@ -261,6 +266,8 @@ void AudioTape::record(const float * audio_stream_data, unsigned int samples_off
             std::copy_n(src, m_frames_per_buffer, dst);
         }
 
+        log_modified_range(write_start, write_end);
+
         if (m_current_record_position < write_end) {
             m_current_record_position = write_end;
         }
@@ -464,6 +471,61 @@ void AudioTape::clear() {
     }
     m_current_record_position = 0;
     m_current_playback_position = 0;
+
+    // Everything may have changed
+    m_revision++;
+    m_cleared_revision = m_revision;
+}
+
+void AudioTape::log_modified_range(unsigned int start, unsigned int end) {
+    m_revision++;
+    m_modified_ranges[m_revision % MODIFIED_RANGE_LOG_SIZE] = {m_revision, start, end};
+}
+
+bool AudioTape::get_modified_ranges_since(unsigned long revision, std::vector<std::pair<unsigned int, unsigned int>> & ranges) const {
+    if (revision < m_cleared_revision || m_revision - revision > MODIFIED_RANGE_LOG_SIZE) {
+        return false;
+    }
+
+    for (unsigned long r = revision + 1; r <= m_revision; ++r) {
+        const auto & modified = m_modified_ranges[r % MODIFIED_RANGE_LOG_SIZE];
+        ranges.push_back({modified.start, modified.end});
+    }
+    return true;
+}
+
+void AudioTape::playback_range_for_render_stage_history(unsigned int channel,
+                                                        unsigned int start_global,
+                                                        unsigned int count,
+                                                        float * dest) const {
+    std::fill(dest, dest + count, 0.0f);
+    if (channel >= m_num_channels) {
+        return;
+    }
+
+    const auto &channel_data = m_data[channel];
+    const unsigned int channel_size = static_cast<unsigned int>(channel_data.size());
+
+    // Range of global indices that hold data
+    unsigned int data_start = 0;
+    unsigned int data_end = channel_size;
+    if (m_fixed_size) {
+        // Fixed-size sliding window
+        data_start = (m_current_record_position > channel_size)
+                         ? (m_current_record_position - channel_size)
+                         : 0u;
+        data_end = data_start + channel_size;
+    }
+
+    const unsigned int copy_start = std::max(start_global, data_start);
+    const unsigned int copy_end = std::min(start_global + count, data_end);
+    if (copy_start >= copy_end) {
+        return;
+    }
+
+    std::copy(channel_data.begin() + (copy_start - data_start),
+              channel_data.begin() + (copy_end - data_start),
+              dest + (copy_start - start_global));
 }
 
 bool AudioTape::export_to_wav_file(const std::string& output_filepath) const {
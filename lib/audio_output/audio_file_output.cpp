@@ -87,16 +87,17 @@ bool AudioFileOutput::stop() {
 }
 
 bool AudioFileOutput::is_ready() {
-    // Audio is only ready for writing once every
-    static auto last_check = std::chrono::high_resolution_clock::now();
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - last_check).count();
+    // When paced, audio is only ready for writing once every buffer duration
+    if (m_realtime_paced) {
+        auto now = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_ready_check).count();
 
-    if (duration < 1000000 * m_frames_per_buffer / m_sample_rate) {
-        return false;
-    }
+        if (duration < 1000000 * m_frames_per_buffer / m_sample_rate) {
+            return false;
+        }
 
-    last_check = now;
+        m_last_ready_check = now;
+    }
 
     // Check if the audio file is ready for writing
     if (!m_file.is_open()) {
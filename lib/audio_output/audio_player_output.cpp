@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 #include <SDL2/SDL.h>
 
 #include "audio_output/audio_player_output.h"
@@ -30,12 +31,25 @@ bool AudioPlayerOutput::open() {
     desired_spec.channels = m_channels;
     desired_spec.samples = m_frames_per_buffer;
     desired_spec.callback = nullptr;
+    desired_spec.userdata = nullptr;
+
+    if (m_mode == Mode::CALLBACK) {
+        // The ring must exist before the device can call back into it
+        m_ring = std::make_unique<AudioRingBuffer>(m_queue_depth, m_frames_per_buffer * m_channels);
+        m_callback_block = nullptr;
+        m_callback_offset = 0;
+        m_latency_frames.store(0, std::memory_order_relaxed);
+        desired_spec.callback = &AudioPlayerOutput::audio_callback;
+        desired_spec.userdata = this;
+    }
 
     m_device_id = SDL_OpenAudioDevice(device_name, 0, &desired_spec, &obtained_spec, 0);
     if (m_device_id == 0) {
         error(SDL_GetError());
+        m_ring.reset();
         return false;
     }
+    m_device_samples = obtained_spec.samples;
 
     printf("Opened audio device: %s\n", device_name ? device_name : "default");
     printf("Sample rate: %d\n", obtained_spec.freq);
@@ -68,10 +82,88 @@ AudioPlayerOutput::~AudioPlayerOutput() {
     printf("AudioPlayerOutput Destroyed\n");
 }
 
+bool AudioPlayerOutput::set_mode(const Mode mode) {
+    if (m_device_id != 0) {
+        fprintf(stderr, "Error: Output mode must be set before the device is opened.\n");
+        return false;
+    }
+    m_mode = mode;
+    return true;
+}
+
+bool AudioPlayerOutput::set_queue_depth(const unsigned int blocks) {
+    if (m_device_id != 0) {
+        fprintf(stderr, "Error: Queue depth must be set before the device is opened.\n");
+        return false;
+    }
+    if (blocks == 0) {
+        fprintf(stderr, "Error: Queue depth must be at least 1 block.\n");
+        return false;
+    }
+    m_queue_depth = blocks;
+    return true;
+}
+
+void AudioPlayerOutput::audio_callback(void * userdata, Uint8 * stream, int len) {
+    auto * player = static_cast<AudioPlayerOutput *>(userdata);
+    auto & ring = *player->m_ring;
+    const unsigned int block_size = ring.get_block_size();
+
+    float * out = reinterpret_cast<float *>(stream);
+    unsigned int samples = static_cast<unsigned int>(len) / sizeof(float);
+
+    // Everything queued ahead of this device buffer is latency the next pushed block will see
+    unsigned int queued_samples = ring.read_available() * block_size;
+    if (player->m_callback_block) {
+        queued_samples -= player->m_callback_offset;
+    }
+    player->m_latency_frames.store(queued_samples / player->m_channels + player->m_device_samples, std::memory_order_relaxed);
+
+    while (samples > 0) {
+        if (player->m_callback_block == nullptr) {
+            player->m_callback_block = ring.acquire_read();
+            player->m_callback_offset = 0;
+            if (player->m_callback_block == nullptr) {
+                // Underrun (counted by the ring): play silence for the rest of the buffer
+                std::memset(out, 0, samples * sizeof(float));
+                return;
+            }
+        }
+
+        // The device buffer does not have to line up with the blocks
+        const unsigned int count = std::min(samples, block_size - player->m_callback_offset);
+        std::memcpy(out, player->m_callback_block + player->m_callback_offset, count * sizeof(float));
+        out += count;
+        samples -= count;
+        player->m_callback_offset += count;
+
+        if (player->m_callback_offset == block_size) {
+            ring.release();
+            player->m_callback_block = nullptr;
+            player->notify_demand();
+        }
+    }
+}
+
+float AudioPlayerOutput::get_output_latency() const {
+    return static_cast<float>(m_latency_frames.load(std::memory_order_relaxed)) / static_cast<float>(m_sample_rate);
+}
+
+unsigned int AudioPlayerOutput::get_underrun_count() const {
+    return m_ring ? m_ring->get_underrun_count() : 0;
+}
+
+unsigned int AudioPlayerOutput::get_overrun_count() const {
+    return m_ring ? m_ring->get_overrun_count() : 0;
+}
+
 bool AudioPlayerOutput::is_ready() {
     // Check if the audio device is running
     if (!m_is_running) {
         return false;
+    // In callback mode, render until the ring holds the target queue depth
+    } else if (m_mode == Mode::CALLBACK) {
+        return m_ring->write_available() > 0;
     // Check if the queued audio size is less than the buffer size
     } else if (SDL_GetQueuedAudioSize(m_device_id) >= 2 * m_frames_per_buffer * m_channels * sizeof(float)) {
         return false;
@@ -86,6 +178,11 @@ void AudioPlayerOutput::push(const float * data) {
         return;
     }
 
+    if (m_mode == Mode::CALLBACK) {
+        m_ring->push(data);
+        return;
+    }
+
     int bytesToWrite = m_frames_per_buffer * m_channels * sizeof(float);
     if (SDL_QueueAudio(m_device_id, data, bytesToWrite) < 0) {
         error(SDL_GetError());
@@ -119,6 +216,10 @@ bool AudioPlayerOutput::close() {
     
     SDL_CloseAudioDevice(m_device_id);
     m_device_id = 0;
+
+    // The audio thread is gone, so the ring can go too
+    m_callback_block = nullptr;
+    m_ring.reset();
     
     // Quit the audio subsystem to ensure clean state for next initialization
     SDL_QuitSubSystem(SDL_INIT_AUDIO);
@@ -132,14 +233,33 @@ size_t AudioPlayerOutput::queued_bytes() const {
         return 0;
     }
 
+    if (m_mode == Mode::CALLBACK) {
+        return static_cast<size_t>(m_ring->read_available()) * m_ring->get_block_size() * sizeof(float);
+    }
+
     return static_cast<size_t>(SDL_GetQueuedAudioSize(m_device_id));
 }
 
+float AudioPlayerOutput::get_queued_seconds() const {
+    const size_t frame_bytes = m_channels * sizeof(float);
+    return static_cast<float>(queued_bytes() / frame_bytes) / static_cast<float>(m_sample_rate);
+}
+
 void AudioPlayerOutput::clear_queue() {
     if (m_device_id == 0) {
         return;
     }
 
+    if (m_mode == Mode::CALLBACK) {
+        // The ring is cleared from the consumer side, so keep the callback out meanwhile
+        SDL_LockAudioDevice(m_device_id);
+        m_ring->clear();
+        m_callback_block = nullptr;
+        m_callback_offset = 0;
+        SDL_UnlockAudioDevice(m_device_id);
+        return;
+    }
+
     SDL_ClearQueuedAudio(m_device_id);
 }
 
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <cstring>
 #include <regex>
 #include <string>
 
 #include "audio_core/audio_render_stage.h"
 #include "audio_parameter/audio_texture2d_parameter.h"
+#include "utilities/audio_tracer.h"
 
 const float AudioTexture2DParameter::FLAT_COLOR[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
@@ -20,7 +22,6 @@ AudioTexture2DParameter::AudioTexture2DParameter(const std::string name,
                           )
         : AudioParameter(name, connection_type),
         m_texture(0),
-        m_PBO(0),
         m_parameter_width(parameter_width),
         m_parameter_height(parameter_height),
         m_active_texture(active_texture),
@@ -34,6 +35,7 @@ AudioTexture2DParameter::AudioTexture2DParameter(const std::string name,
 };
 
 AudioTexture2DParameter::~AudioTexture2DParameter() {
+    delete_readback_ring();
     if (m_texture != 0) {
         glDeleteTextures(1, &m_texture);
         m_texture = 0;
@@ -54,6 +56,12 @@ bool AudioTexture2DParameter::initialize(GLuint frame_buffer, AudioShaderProgram
         return false;
     }
 
+    // The storage may have been set before there was a context to check it
+    if (is_half_float() && !half_float_renderable()) {
+        printf("Warning: Half float textures are not renderable, parameter %s falls back to 32-bit storage\n", name.c_str());
+        m_internal_format = m_format == GL_RGBA ? GL_RGBA32F : GL_R32F;
+    }
+
     // Generate the texture
     glGenTextures(1, &m_texture);
 
@@ -77,9 +85,13 @@ bool AudioTexture2DParameter::initialize(GLuint frame_buffer, AudioShaderProgram
         }
         glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_parameter_width, m_parameter_height, 0, m_format, m_datatype, m_data->get_data());
 
+        // The value is uploaded, so the first render does not upload it again over what was drawn into the texture
+        m_update_param = false;
+        m_dirty_regions.clear();
+
     } else if (connection_type == ConnectionType::PASSTHROUGH || connection_type == ConnectionType::OUTPUT) {
         // Allocate memory for the texture and initialize it with 0s
-        std::vector<unsigned char> zero_data(m_parameter_width * m_parameter_height * 4, 0); // Assuming 4 channels (RGBA)
+        std::vector<unsigned char> zero_data(m_data->get_size(), 0);
         glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_parameter_width, m_parameter_height, 0, m_format, m_datatype, zero_data.data());
     }
     
@@ -89,6 +101,12 @@ bool AudioTexture2DParameter::initialize(GLuint frame_buffer, AudioShaderProgram
         return false;
     }
 
+    // Outputs and streams are rendered into, so the driver must accept them as color buffers
+    if ((connection_type == ConnectionType::OUTPUT || connection_type == ConnectionType::PASSTHROUGH) &&
+        !check_half_float_attachment()) {
+        return false;
+    }
+
     // Look for the texture in the shader program
     if (connection_type == ConnectionType::OUTPUT) {
         // do regex search for output texture
@@ -99,8 +117,9 @@ bool AudioTexture2DParameter::initialize(GLuint frame_buffer, AudioShaderProgram
             return false;
         }
     } else {
-        auto location = glGetUniformLocation(m_shader_program_linked->get_program(), name.c_str());
-        if (location == -1) {
+        m_sampler_location = m_shader_program_linked->get_uniform_location(name);
+        m_sampler_unit_set = false;
+        if (m_sampler_location == -1) {
             printf("Source: %s\n", m_shader_program_linked->get_fragment_shader_source().c_str());
             printf("Error: Could not find texture in shader program in parameter %s\n", name.c_str());
             return false;
@@ -109,27 +128,24 @@ bool AudioTexture2DParameter::initialize(GLuint frame_buffer, AudioShaderProgram
 
     // Unbind the texture
     glBindTexture(GL_TEXTURE_2D, 0);
-    // Using pixel buffer object may be faster, the extra code for that is commented out
-
-    //// Initialize the PBO
-    //glGenBuffers(1, &m_PBO);
 
-    //// Bind the PBO
-    //glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PBO);
-
-    //// Allocate memory for the PBO
-    //glBufferData(GL_PIXEL_PACK_BUFFER, (m_parameter_width * m_parameter_height) * sizeof(float), nullptr, GL_STREAM_READ);
+    // Pixel pack buffers for asynchronous readback
+    if (!initialize_readback_ring()) {
+        return false;
+    }
 
-    //// Unbind the PBO
-    //glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
 
-    //// Check for errors
-    //status = glGetError();
-    //if (status != GL_NO_ERROR) {
-    //    printf("Error: OpenGL error in initializing parameter %s\n", name);
-    //    return false;
-    //}
+bool AudioTexture2DParameter::relink_program(AudioShaderProgram * shader_program, const std::string & uniform_name) {
+    // Outputs are attachments of the framebuffer, not part of the program
+    if (connection_type == ConnectionType::OUTPUT) {
+        return true;
+    }
 
+    m_shader_program_linked = shader_program;
+    m_sampler_location = m_shader_program_linked->get_uniform_location(uniform_name);
+    m_sampler_unit_set = false;
     return true;
 }
 
@@ -139,14 +155,73 @@ void AudioTexture2DParameter::render() {
     }
     glActiveTexture(GL_TEXTURE0 + m_active_texture);
     glBindTexture(GL_TEXTURE_2D, m_texture);
-    glUniform1i(glGetUniformLocation(m_shader_program_linked->get_program(), name.c_str()), m_active_texture);
+
+    // The texture unit never changes, so the sampler only needs setting once per program
+    if (!m_sampler_unit_set) {
+        glUniform1i(m_sampler_location, m_active_texture);
+        m_sampler_unit_set = true;
+    }
 
     if (connection_type == ConnectionType::INPUT && m_update_param) {
+        AUDIO_TRACE_SCOPE(name, "upload");
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_parameter_width, m_parameter_height, m_format, m_datatype, m_data->get_data());
         m_update_param = false;
+        m_dirty_regions.clear();
+    } else if (connection_type == ConnectionType::INPUT && !m_dirty_regions.empty()) {
+        // Upload only the dirty regions straight out of the full texture data
+        AUDIO_TRACE_SCOPE(name, "upload");
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, m_parameter_width);
+        for (const auto & region : m_dirty_regions) {
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, region.x_offset);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, region.y_offset);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, region.x_offset, region.y_offset, region.width, region.height, m_format, m_datatype, m_data->get_data());
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+        m_dirty_regions.clear();
     }
 }
 
+bool AudioTexture2DParameter::set_value(const void * value_ptr, GLuint x_offset, GLuint y_offset, GLuint width, GLuint height) {
+    if (connection_type != ConnectionType::INPUT) {
+        printf("Error: Can only set a region of input parameter %s\n", name.c_str());
+        return false;
+    }
+
+    if (x_offset + width > m_parameter_width || y_offset + height > m_parameter_height) {
+        printf("Error: Region out of bounds in parameter %s\n", name.c_str());
+        return false;
+    }
+
+    if (width == 0 || height == 0) {
+        return true;
+    }
+
+    // Copy the region into the full texture data row by row
+    const size_t texel_size = m_data->get_size() / (m_parameter_width * m_parameter_height);
+    const size_t row_size = width * texel_size;
+    const char * src = static_cast<const char *>(value_ptr);
+    char * dst = static_cast<char *>(m_data->get_data());
+    for (GLuint row = 0; row < height; ++row) {
+        std::memcpy(dst + ((y_offset + row) * m_parameter_width + x_offset) * texel_size, src + row * row_size, row_size);
+    }
+
+    // A full upload is already pending
+    if (m_update_param) {
+        return true;
+    }
+
+    if (m_dirty_regions.size() >= MAX_DIRTY_REGIONS) {
+        m_dirty_regions.clear();
+        m_update_param = true;
+        return true;
+    }
+
+    m_dirty_regions.push_back({x_offset, y_offset, width, height});
+    return true;
+}
+
 bool AudioTexture2DParameter::bind() {
     AudioTexture2DParameter* linked_param = nullptr;
     if (m_linked_parameter == nullptr) {
@@ -182,6 +257,7 @@ bool AudioTexture2DParameter::bind() {
         // Link the texture to the framebuffer
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + m_color_attachment,
                                GL_TEXTURE_2D, linked_param->get_texture(), 0);
+        m_readback_rgba = linked_param->is_half_float() && !linked_param->is_packed_layout();
     }
 
     // Unbind texture
@@ -210,27 +286,298 @@ const void * const AudioTexture2DParameter::get_value() const {
         }
         return previous_param->get_value();
     }
-    else {
+    else if (m_PBOs.empty()) {
+        AUDIO_TRACE_SCOPE(name, "readback");
+
         // Bind framebuffer to read from texture
         glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_linked);
         glReadBuffer(GL_COLOR_ATTACHMENT0 + m_color_attachment);
         
         // Read pixels from framebuffer instead of using glGetTexImage
-        glReadPixels(0, 0, m_parameter_width, m_parameter_height, m_format, m_datatype, m_data->get_data());
+        if (m_readback_rgba) {
+            // Keep the red channel of each texel
+            m_readback_texels.resize(m_parameter_width * m_parameter_height * 4);
+            glReadPixels(0, 0, m_parameter_width, m_parameter_height, GL_RGBA, GL_FLOAT, m_readback_texels.data());
+            float * data = static_cast<float *>(m_data->get_data());
+            for (size_t i = 0; i < m_parameter_width * m_parameter_height; ++i) {
+                data[i] = m_readback_texels[i * 4];
+            }
+        } else {
+            glReadPixels(0, 0, m_parameter_width, m_parameter_height, m_format, m_datatype, m_data->get_data());
+        }
         
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+        return m_data->get_data();
+    }
+    else {
+        AUDIO_TRACE_SCOPE(name, "readback");
+        const GLuint ring_size = m_PBOs.size();
+
+        // Queue the readback of this block into the next pixel pack buffer
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_linked);
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + m_color_attachment);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PBOs[m_readback_index]);
+        if (m_readback_rgba) {
+            glReadPixels(0, 0, m_parameter_width, m_parameter_height, GL_RGBA, GL_FLOAT, nullptr);
+        } else {
+            glReadPixels(0, 0, m_parameter_width, m_parameter_height, m_format, m_datatype, nullptr);
+        }
+        m_readback_fences[m_readback_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        m_readback_index = (m_readback_index + 1) % ring_size;
+
+        // Until the ring is primed there is nothing to collect
+        if (m_readback_queued < m_readback_latency) {
+            m_readback_queued++;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            return m_data->get_data();
+        }
+
+        // The next slot to write holds the oldest pending readback
+        GLsync & fence = m_readback_fences[m_readback_index];
+        if (fence != nullptr) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PBOs[m_readback_index]);
+        const size_t texel_count = m_parameter_width * m_parameter_height;
+        const size_t mapped_size = m_readback_rgba ? texel_count * 4 * sizeof(float) : m_data->get_size();
+        void * mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, mapped_size, GL_MAP_READ_BIT);
+        if (mapped != nullptr) {
+            if (m_readback_rgba) {
+                // Keep the red channel of each texel
+                const float * texels = static_cast<const float *>(mapped);
+                float * data = static_cast<float *>(m_data->get_data());
+                for (size_t i = 0; i < texel_count; ++i) {
+                    data[i] = texels[i * 4];
+                }
+            } else {
+                std::memcpy(m_data->get_data(), mapped, m_data->get_size());
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            printf("Error: Failed to map pixel pack buffer in parameter %s\n", name.c_str());
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
         return m_data->get_data();
     }
 }
 
+bool AudioTexture2DParameter::resize(GLuint width, GLuint height) {
+    if (m_texture != 0) {
+        printf("Error: Cannot resize initialized texture parameter %s\n", name.c_str());
+        return false;
+    }
+
+    m_parameter_width = width;
+    m_parameter_height = height;
+    m_data = create_param_data();
+    m_dirty_regions.clear();
+    return true;
+}
+
+bool AudioTexture2DParameter::set_packed_layout(bool packed) {
+    if (m_texture != 0) {
+        printf("Error: Cannot change the layout of initialized texture parameter %s\n", name.c_str());
+        return false;
+    }
+    if (packed == is_packed_layout()) {
+        return true;
+    }
+    if (packed && m_parameter_width % PACKED_SAMPLES != 0) {
+        printf("Error: Width of texture parameter %s is not a multiple of %u samples\n", name.c_str(), PACKED_SAMPLES);
+        return false;
+    }
+
+    const bool half_float = is_half_float();
+    m_parameter_width = packed ? m_parameter_width / PACKED_SAMPLES : m_parameter_width * PACKED_SAMPLES;
+    m_format = packed ? GL_RGBA : GL_RED;
+    if (packed) {
+        m_internal_format = half_float ? GL_RGBA16F : GL_RGBA32F;
+    } else {
+        m_internal_format = half_float ? GL_R16F : GL_R32F;
+    }
+    m_data = create_param_data();
+    m_dirty_regions.clear();
+    return true;
+}
+
+bool AudioTexture2DParameter::half_float_renderable() {
+    const char * extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    return extensions == nullptr ||
+           std::strstr(extensions, "GL_EXT_color_buffer_half_float") != nullptr ||
+           std::strstr(extensions, "GL_EXT_color_buffer_float") != nullptr;
+}
+
+bool AudioTexture2DParameter::set_half_float(bool half_float) {
+    if (m_texture != 0 && connection_type != ConnectionType::INPUT) {
+        printf("Error: Cannot change the storage of initialized texture parameter %s\n", name.c_str());
+        return false;
+    }
+    if (half_float && !half_float_renderable()) {
+        printf("Warning: Half float textures are not renderable, parameter %s keeps 32-bit storage\n", name.c_str());
+        half_float = false;
+    }
+
+    switch (m_internal_format) {
+        case GL_R32F:
+        case GL_R16F:
+            m_internal_format = half_float ? GL_R16F : GL_R32F;
+            break;
+        case GL_RGBA32F:
+        case GL_RGBA16F:
+            m_internal_format = half_float ? GL_RGBA16F : GL_RGBA32F;
+            break;
+        default:
+            printf("Error: Texture parameter %s does not store float samples\n", name.c_str());
+            return false;
+    }
+
+    // An initialized input is allocated again with its value
+    if (m_texture != 0) {
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_parameter_width, m_parameter_height, 0, m_format, m_datatype, m_data->get_data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_update_param = false;
+        m_dirty_regions.clear();
+
+        if (glGetError() != GL_NO_ERROR) {
+            printf("Error: OpenGL error in changing the storage of parameter %s\n", name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AudioTexture2DParameter::set_readback_latency(const unsigned int blocks) {
+    if (connection_type != ConnectionType::OUTPUT) {
+        printf("Error: Readback latency can only be set on output parameter %s\n", name.c_str());
+        return false;
+    }
+
+    m_readback_latency = blocks;
+
+    // Rebuild the ring if the parameter is already initialized
+    if (m_texture != 0) {
+        delete_readback_ring();
+        return initialize_readback_ring();
+    }
+    return true;
+}
+
+bool AudioTexture2DParameter::is_readback_ready() const {
+    if (m_PBOs.empty() || m_readback_queued < m_readback_latency) {
+        return true;
+    }
+
+    GLsync fence = m_readback_fences[m_readback_index];
+    if (fence == nullptr) {
+        return true;
+    }
+
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+bool AudioTexture2DParameter::check_half_float_attachment() {
+    if (!is_half_float()) {
+        return true;
+    }
+
+    GLint previous_framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    if (complete) {
+        return true;
+    }
+
+    printf("Warning: Framebuffer cannot render into half float parameter %s, falling back to 32-bit storage\n", name.c_str());
+    m_internal_format = m_format == GL_RGBA ? GL_RGBA32F : GL_R32F;
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    std::vector<unsigned char> zero_data(m_data->get_size(), 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_parameter_width, m_parameter_height, 0, m_format, m_datatype, zero_data.data());
+
+    if (glGetError() != GL_NO_ERROR) {
+        printf("Error: OpenGL error in falling back to 32-bit storage in parameter %s\n", name.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool AudioTexture2DParameter::initialize_readback_ring() {
+    if (connection_type != ConnectionType::OUTPUT || m_readback_latency == 0) {
+        return true;
+    }
+
+    const GLuint ring_size = m_readback_latency + 1;
+    m_PBOs.resize(ring_size, 0);
+    m_readback_fences.assign(ring_size, nullptr);
+    m_readback_index = 0;
+    m_readback_queued = 0;
+
+    // A half float attachment is only bound later and is read back as RGBA floats, so leave room for them
+    const size_t buffer_size = std::max<size_t>(m_data->get_size(), m_parameter_width * m_parameter_height * 4 * sizeof(float));
+
+    glGenBuffers(ring_size, m_PBOs.data());
+    for (auto pbo : m_PBOs) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, buffer_size, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLenum status = glGetError();
+    if (status != GL_NO_ERROR) {
+        printf("Error: OpenGL error in initializing readback buffers for parameter %s\n", name.c_str());
+        delete_readback_ring();
+        return false;
+    }
+    return true;
+}
+
+void AudioTexture2DParameter::delete_readback_ring() {
+    reset_readback_ring();
+    if (!m_PBOs.empty()) {
+        glDeleteBuffers(m_PBOs.size(), m_PBOs.data());
+        m_PBOs.clear();
+    }
+    m_readback_fences.clear();
+}
+
+void AudioTexture2DParameter::reset_readback_ring() const {
+    for (auto & fence : m_readback_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    m_readback_index = 0;
+    m_readback_queued = 0;
+}
+
 void AudioTexture2DParameter::clear_value() {
     AudioParameter::clear_value();
 
+    // Drop any pending readbacks so stale blocks are not returned
+    reset_readback_ring();
+    std::memset(m_data->get_data(), 0, m_data->get_size());
+
     // Only clear if texture is initialized
     if (m_texture != 0) {
         glBindTexture(GL_TEXTURE_2D, m_texture);
-        std::vector<unsigned char> zero_data(m_parameter_width * m_parameter_height * 4, 0); // Assuming 4 channels (RGBA)
+        std::vector<unsigned char> zero_data(m_data->get_size(), 0);
         glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_parameter_width, m_parameter_height, 0, m_format, m_datatype, zero_data.data());
         glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -12,18 +12,39 @@ AudioUniformParameter::AudioUniformParameter(const std::string name,
     }
 }
 
+bool AudioUniformParameter::initialize(GLuint frame_buffer, AudioShaderProgram * shader_program) {
+    m_framebuffer_linked = frame_buffer;
+    m_shader_program_linked = shader_program;
+
+    // A (re)built program starts with default uniform values, so upload on the next render
+    m_location = m_shader_program_linked ? m_shader_program_linked->get_uniform_location(name) : -1;
+    m_initialized = false;
+    m_update_param = true;
+    return true;
+}
+
+bool AudioUniformParameter::relink_program(AudioShaderProgram * shader_program, const std::string & uniform_name) {
+    m_shader_program_linked = shader_program;
+
+    // The value has to be uploaded to the other program on the next render
+    m_location = m_shader_program_linked->get_uniform_location(uniform_name);
+    m_initialized = false;
+    m_update_param = true;
+    return true;
+}
+
 void AudioUniformParameter::render() {
+    // Uniform values are part of the program state, so only upload when the value changed
+    if (!m_update_param || m_location == -1) {
+        return;
+    }
+
     // Check if the parameter is an input or initialization parameter
-    if (connection_type == ConnectionType::INPUT || (connection_type == ConnectionType::INITIALIZATION && !m_initialized && m_update_param)) {
-        // Get the location of the uniform
-        GLint location = glGetUniformLocation(m_shader_program_linked->get_program(), name.c_str());
-        if (location == -1) {
-            return;
-        }
+    if (connection_type == ConnectionType::INPUT || (connection_type == ConnectionType::INITIALIZATION && !m_initialized)) {
         // Set the uniform
-        set_uniform(location);
+        set_uniform(m_location);
         // Set the initialized flag
         m_initialized = true;
         m_update_param = false;
     }
-}   
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 #include <vector>
 #include <cmath>
 #include <stdexcept>
+#include <limits>
+#include <algorithm>
 #include <numeric>  // for std::accumulate
 
 #include "audio_parameter/audio_uniform_parameter.h"
@@ -9,6 +11,7 @@
 #include "audio_parameter/audio_texture2d_parameter.h"
 #include "audio_render_stage/audio_effect_render_stage.h"
 #include "audio_render_stage_plugins/audio_render_stage_history.h"
+#include "utilities/shader_registry.h"
 
 const std::vector<std::string> AudioGainEffectRenderStage::default_frag_shader_imports = {
     "build/shaders/global_settings.glsl",
@@ -146,7 +149,6 @@ AudioEchoEffectRenderStage::AudioEchoEffectRenderStage(const std::string & stage
     if (!this->add_parameter(decay_parameter)) {
         std::cerr << "Failed to add decay_parameter" << std::endl;
     }
-
     m_controls.clear();
     auto num_echos_control = std::make_shared<AudioControl<int>>(
         "num_echos",
@@ -193,6 +195,40 @@ AudioEchoEffectRenderStage::AudioEchoEffectRenderStage(const std::string & stage
     m_history2->update_window();
 }
 
+void AudioEchoEffectRenderStage::resolve_parameters() {
+    AudioEffectRenderStage::resolve_parameters();
+    m_num_echos_param = find_parameter("num_echos");
+    m_delay_param = find_parameter("delay");
+    m_decay_param = find_parameter("decay");
+}
+
+unsigned int AudioEchoEffectRenderStage::get_tail_blocks() const {
+    // Without its echo parameters the shader does not echo
+    if (!m_num_echos_param || !m_delay_param || !m_decay_param) {
+        return 0;
+    }
+    const int num_echos = *(int *)m_num_echos_param->get_value();
+    const float delay = *(float *)m_delay_param->get_value();
+    const float decay = std::fabs(*(float *)m_decay_param->get_value());
+    if (num_echos <= 0 || delay <= 0.0f || decay == 0.0f) {
+        return 0;
+    }
+
+    // The echoes read back at most num_echos * delay, so over every such window the loudest
+    // recorded sample is scaled by at most the sum of the echo gains
+    float loop_gain = 0.0f;
+    for (int i = 1; i <= num_echos; i++) {
+        loop_gain += std::pow(decay, (float)i);
+    }
+    if (loop_gain >= 1.0f) {
+        return std::numeric_limits<unsigned int>::max(); // The echoes never die out
+    }
+
+    const float windows = std::ceil(std::log(SILENCE_THRESHOLD) / std::log(loop_gain));
+    const float tail_seconds = windows * num_echos * delay;
+    return (unsigned int)std::ceil(tail_seconds * sample_rate / frames_per_buffer);
+}
+
 void AudioEchoEffectRenderStage::render(unsigned int time) {
     auto current_time = m_time;
 
@@ -208,14 +244,31 @@ void AudioEchoEffectRenderStage::render(unsigned int time) {
 
     AudioRenderStage::render(time);
 
-    // Get the audio data
-    auto * data = (float *)this->find_parameter("output_audio_texture")->get_value();
-
     // Calculate the recording position based on the frame time
     // This allows us to overwrite the current frame's data if we are re-rendering the same frame
 
     // FIXME: find a better way than use local time
     unsigned int record_position = m_local_time * frames_per_buffer;
+
+    // Nothing to record once the output parameter is removed
+    if (m_output_audio_texture == nullptr) {
+        return;
+    }
+
+    if (m_history2->is_gpu_ring_enabled()) {
+        // Copy the output straight into the history texture without a readback
+        AudioStageTimer::Scope record_scope(m_stage_timer, AudioStageTimer::Phase::RECORD);
+        m_history2->record_block_to_gpu_ring(m_output_audio_texture, record_position);
+        return;
+    }
+
+    // Get the audio data
+    float * data = nullptr;
+    {
+        AudioStageTimer::Scope readback_scope(m_stage_timer, AudioStageTimer::Phase::READBACK);
+        data = (float *)m_output_audio_texture->get_value();
+    }
+    AudioStageTimer::Scope record_scope(m_stage_timer, AudioStageTimer::Phase::RECORD);
     m_tape->record(data, record_position);
 }
 
@@ -227,6 +280,7 @@ bool AudioEchoEffectRenderStage::disconnect_render_stage(AudioRenderStage * rend
     }
 
     m_tape->clear();
+    m_history2->clear_gpu_ring();
     m_history2->set_tape_position(0u);
 
     return true;
@@ -257,17 +311,45 @@ AudioFrequencyFilterEffectRenderStage::AudioFrequencyFilterEffectRenderStage(con
       m_low_pass(1.0f),
       m_high_pass(230.0f),
       m_filter_follower(0.0f),
-      m_resonance(1.0f) {
+      m_resonance(1.0f),
+      m_fft_convolver(frames_per_buffer, num_channels),
+      m_convolved_data(frames_per_buffer * num_channels, 0.0f) {
 
     auto num_taps_parameter =
         new AudioIntParameter("num_taps",
                                 AudioParameter::ConnectionType::INPUT);
     num_taps_parameter->set_value(frames_per_buffer - 1);
 
+    // One row per design of the coefficient bank, the first row without the follower
     auto b_coeff_texture =
         new AudioTexture2DParameter("b_coeff_texture",
                                 AudioParameter::ConnectionType::INPUT,
-                                MAX_TEXTURE_SIZE, 1,
+                                MAX_TEXTURE_SIZE, COEFF_BANK_SIZE,
+                                m_active_texture_count++,
+                                0, GL_NEAREST);
+
+    auto coeff_bank_rows_parameter =
+        new AudioIntParameter("coeff_bank_rows",
+                                AudioParameter::ConnectionType::INPUT);
+    coeff_bank_rows_parameter->set_value(1);
+
+    auto fft_convolution_parameter =
+        new AudioIntParameter("fft_convolution",
+                                AudioParameter::ConnectionType::INPUT);
+    fft_convolution_parameter->set_value(0);
+
+    // Mean absolute value of the block, rendered by the amplitude pass for the follower
+    auto block_amplitude_parameter =
+        new AudioTexture2DParameter("block_amplitude_texture",
+                                AudioParameter::ConnectionType::INPUT,
+                                1, 1,
+                                m_active_texture_count++,
+                                0, GL_NEAREST);
+
+    auto convolved_audio_texture =
+        new AudioTexture2DParameter("convolved_audio_texture",
+                                AudioParameter::ConnectionType::INPUT,
+                                frames_per_buffer, num_channels,
                                 m_active_texture_count++,
                                 0, GL_NEAREST);
 
@@ -277,7 +359,18 @@ AudioFrequencyFilterEffectRenderStage::AudioFrequencyFilterEffectRenderStage(con
     if (!this->add_parameter(b_coeff_texture)) {
         std::cerr << "Failed to add b_coeff_texture" << std::endl;
     }
-
+    if (!this->add_parameter(coeff_bank_rows_parameter)) {
+        std::cerr << "Failed to add coeff_bank_rows_parameter" << std::endl;
+    }
+    if (!this->add_parameter(fft_convolution_parameter)) {
+        std::cerr << "Failed to add fft_convolution_parameter" << std::endl;
+    }
+    if (!this->add_parameter(block_amplitude_parameter)) {
+        std::cerr << "Failed to add block_amplitude_parameter" << std::endl;
+    }
+    if (!this->add_parameter(convolved_audio_texture)) {
+        std::cerr << "Failed to add convolved_audio_texture" << std::endl;
+    }
     m_tape = std::make_shared<AudioTape>(frames_per_buffer, sample_rate, num_channels, MAX_TEXTURE_SIZE);
     float history_window_size_seconds = float(MAX_TEXTURE_SIZE) / float(sample_rate);
     m_history2 = std::make_unique<AudioRenderStageHistory2>(frames_per_buffer, sample_rate, num_channels, history_window_size_seconds);
@@ -462,35 +555,183 @@ const std::vector<float> AudioFrequencyFilterEffectRenderStage::calculate_firwin
     return h;
 }
 
+void AudioFrequencyFilterEffectRenderStage::resolve_parameters() {
+    AudioEffectRenderStage::resolve_parameters();
+    m_num_taps_param = find_parameter("num_taps");
+    m_b_coeff_param = dynamic_cast<AudioTexture2DParameter *>(find_parameter("b_coeff_texture"));
+    m_coeff_bank_rows_param = find_parameter("coeff_bank_rows");
+    m_block_amplitude_param = dynamic_cast<AudioTexture2DParameter *>(find_parameter("block_amplitude_texture"));
+    m_fft_convolution_param = find_parameter("fft_convolution");
+    m_convolved_audio_param = dynamic_cast<AudioTexture2DParameter *>(find_parameter("convolved_audio_texture"));
+}
+
+unsigned int AudioFrequencyFilterEffectRenderStage::get_tail_blocks() const {
+    if (!m_num_taps_param) {
+        return 0;
+    }
+    const int num_taps = *(int *)m_num_taps_param->get_value();
+    return (std::max(num_taps, 0) + frames_per_buffer - 1) / frames_per_buffer;
+}
+
+void AudioFrequencyFilterEffectRenderStage::set_fft_convolution_enabled(const bool enabled) {
+    if (enabled == m_fft_convolution_enabled) {
+        return;
+    }
+    m_fft_convolution_enabled = enabled;
+    if (m_fft_convolution_param) {
+        m_fft_convolution_param->set_value(enabled ? 1 : 0);
+    }
+
+    // The convolver has no history of the blocks filtered in the shader, and the other path needs the coefficients
+    m_fft_convolver.reset();
+    m_b_coefficients_dirty = true;
+}
+
 void AudioFrequencyFilterEffectRenderStage::render(const unsigned int time) {
-    auto * data = (float *)this->find_parameter("stream_audio_texture")->get_value();
+    // Without its input there is nothing to filter or record
+    if (m_stream_audio_texture == nullptr) {
+        AudioRenderStage::render(time);
+        return;
+    }
+
+    const bool gpu_history = m_history2->is_gpu_ring_enabled();
+    const bool new_block = m_time != time;
 
-    if (m_time != time) {
+    const bool follow_amplitude = m_filter_follower != 0.0f;
+
+    // The input is read back for the tape and the FFT convolution
+    float * data = nullptr;
+    if (!gpu_history || m_fft_convolution_enabled) {
+        AudioStageTimer::Scope readback_scope(m_stage_timer, AudioStageTimer::Phase::READBACK);
+        data = (float *)m_stream_audio_texture->get_value();
+    }
+
+    if (new_block) {
         m_history2->increment_tape_position_by_one();
     }
     m_history2->update_window();
 
     if (m_b_coefficients_dirty) {
-        float current_amplitude = std::accumulate(data, data + frames_per_buffer * num_channels, 0.0f, [](float sum, float value) {
-            return sum + std::fabs(value);
-        }) / (frames_per_buffer * num_channels);
-        update_b_coefficients(current_amplitude);
+        update_b_coefficients();
+    }
+
+    if (m_fft_convolution_enabled) {
+        // The convolver mixes the designs on the CPU, so it takes the amplitude from the block it reads back
+        float block_amplitude = 0.0f;
+        if (follow_amplitude) {
+            block_amplitude = std::accumulate(data, data + frames_per_buffer * num_channels, 0.0f, [](float sum, float value) {
+                return sum + std::fabs(value);
+            }) / (frames_per_buffer * num_channels);
+        }
+
+        // Mix the two designs of the bank around the amplitude, as the shader does for the direct form
+        unsigned int bank_row = 0;
+        float bank_weight = 0.0f;
+        const unsigned int bank_rows = m_fft_convolver.get_num_responses();
+        if (bank_rows > 1) {
+            const float bank_position = std::clamp(block_amplitude, 0.0f, 1.0f) * float(bank_rows - 1);
+            bank_row = std::min((unsigned int)bank_position, bank_rows - 2);
+            bank_weight = bank_position - float(bank_row);
+        }
+
+        // The stream rows are the channels, as the convolver expects
+        m_fft_convolver.process(data, m_convolved_data.data(), new_block, bank_row, bank_weight);
+        if (m_convolved_audio_param) {
+            m_convolved_audio_param->set_value(m_convolved_data.data());
+        }
+    } else if (follow_amplitude) {
+        // The direct form reads the amplitude the GPU rendered, without a round trip through the CPU
+        AudioStageTimer::Scope draw_scope(m_stage_timer, AudioStageTimer::Phase::DRAW);
+        render_block_amplitude();
     }
 
     AudioRenderStage::render(time);
 
+    AudioStageTimer::Scope record_scope(m_stage_timer, AudioStageTimer::Phase::RECORD);
     unsigned int record_position = m_local_time * frames_per_buffer;
-    m_tape->record(data, record_position);
+    if (gpu_history) {
+        m_history2->record_block_to_gpu_ring(m_stream_audio_texture, record_position);
+    } else {
+        m_tape->record(data, record_position);
+    }
+}
+
+AudioFrequencyFilterEffectRenderStage::~AudioFrequencyFilterEffectRenderStage() {
+    if (m_amplitude_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_amplitude_framebuffer);
+        m_amplitude_framebuffer = 0;
+    }
 }
 
-void AudioFrequencyFilterEffectRenderStage::update_b_coefficients(const float current_amplitude) {
-    // Current amplitude is used to follow the filter and adjust the cutoff frequency
-    float low_pass = m_low_pass + m_filter_follower * current_amplitude;
-    float high_pass = m_high_pass + m_filter_follower * current_amplitude;
-    auto b_coeff = calculate_firwin_b_coefficients(low_pass/NYQUIST, high_pass/NYQUIST, *(int *)this->find_parameter("num_taps")->get_value(), m_resonance);
-    b_coeff.resize(MAX_TEXTURE_SIZE, 0.0);
-    this->find_parameter("b_coeff_texture")->set_value(b_coeff.data());
+void AudioFrequencyFilterEffectRenderStage::render_block_amplitude() {
+    if (m_block_amplitude_param == nullptr || m_block_amplitude_param->get_texture() == 0) {
+        return;
+    }
+
+    if (!m_amplitude_program) {
+        bool version_added = false;
+        std::vector<std::string> imports = default_frag_shader_imports;
+        imports.push_back("build/shaders/frequency_filter_amplitude.glsl");
+        auto program = std::make_unique<AudioShaderProgram>(m_vertex_shader_source,
+                                                            ShaderRegistry::combine_imports(imports, version_added));
+        if (!program->initialize()) {
+            std::cerr << "Error: Failed to initialize the block amplitude program of " << name << std::endl;
+            return;
+        }
+        glGenFramebuffers(1, &m_amplitude_framebuffer);
+        m_amplitude_program = std::move(program);
+    }
+
+    glUseProgram(m_amplitude_program->get_program());
+    glUniform1i(m_amplitude_program->get_uniform_location("buffer_size"), frames_per_buffer);
+    glUniform1i(m_amplitude_program->get_uniform_location("num_channels"), num_channels);
+    glUniform1i(m_amplitude_program->get_uniform_location("stream_audio_texture"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_stream_audio_texture->get_texture());
+
+    // The texel is attached on every render, as the parameter may have been replaced
+    const GLenum draw_buffer = GL_COLOR_ATTACHMENT0;
+    glBindFramebuffer(GL_FRAMEBUFFER, m_amplitude_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_block_amplitude_param->get_texture(), 0);
+    glDrawBuffers(1, &draw_buffer);
+    glViewport(0, 0, 1, 1);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glUseProgram(0);
+}
+
+void AudioFrequencyFilterEffectRenderStage::update_b_coefficients() {
     m_b_coefficients_dirty = false;
+    if (!m_num_taps_param) {
+        return;
+    }
+    const int num_taps = *(int *)m_num_taps_param->get_value();
+
+    // With the follower, one design per amplitude step, mixed per block around the amplitude of the
+    // block, so following the amplitude needs no design or upload per block
+    const unsigned int bank_rows = m_filter_follower != 0.0f ? COEFF_BANK_SIZE : 1;
+    std::vector<float> b_coeff_bank(MAX_TEXTURE_SIZE * bank_rows, 0.0f);
+    for (unsigned int row = 0; row < bank_rows; row++) {
+        const float amplitude = float(row) / float(COEFF_BANK_SIZE - 1);
+        float low_pass = m_low_pass + m_filter_follower * amplitude;
+        float high_pass = m_high_pass + m_filter_follower * amplitude;
+        auto b_coeff = calculate_firwin_b_coefficients(low_pass/NYQUIST, high_pass/NYQUIST, num_taps, m_resonance);
+        std::copy(b_coeff.begin(), b_coeff.end(), b_coeff_bank.begin() + row * MAX_TEXTURE_SIZE);
+    }
+
+    // The FFT convolution keeps the spectra of the designs, the shader does not read them
+    if (m_fft_convolution_enabled) {
+        m_fft_convolver.set_impulse_responses(b_coeff_bank.data(), num_taps, bank_rows, MAX_TEXTURE_SIZE);
+        return;
+    }
+
+    if (m_b_coeff_param) {
+        m_b_coeff_param->set_value_rows(b_coeff_bank.data(), 0, bank_rows);
+    }
+    if (m_coeff_bank_rows_param) {
+        m_coeff_bank_rows_param->set_value((int)bank_rows);
+    }
 }
 
 bool AudioFrequencyFilterEffectRenderStage::disconnect_render_stage(AudioRenderStage * render_stage) {
@@ -501,7 +742,9 @@ bool AudioFrequencyFilterEffectRenderStage::disconnect_render_stage(AudioRenderS
     }
 
     m_tape->clear();
+    m_history2->clear_gpu_ring();
     m_history2->set_tape_position(0u);
+    m_fft_convolver.reset();
 
     return true;
 }
\ No newline at end of file
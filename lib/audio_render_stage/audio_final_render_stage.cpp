@@ -2,6 +2,7 @@
 
 #include "audio_render_stage/audio_final_render_stage.h"
 #include "audio_parameter/audio_texture2d_parameter.h"
+#include "audio_parameter/audio_uniform_parameter.h"
 
 const std::vector<std::string> AudioFinalRenderStage::default_frag_shader_imports = {
     "build/shaders/global_settings.glsl",
@@ -24,11 +25,20 @@ AudioFinalRenderStage::AudioFinalRenderStage(const unsigned int frames_per_buffe
                                     m_color_attachment_count++,
                                     GL_NEAREST);
 
+    auto output_samples_per_texel =
+        new AudioIntParameter("output_samples_per_texel",
+                              AudioParameter::ConnectionType::INITIALIZATION);
+    output_samples_per_texel->set_value(1);
+
     m_output_data_channel_seperated.resize(num_channels);
 
     if (!this->add_parameter(output_audio_texture)) {
         std::cerr << "Failed to add output_audio_texture" << std::endl;
     }
+
+    if (!this->add_parameter(output_samples_per_texel)) {
+        std::cerr << "Failed to add output_samples_per_texel" << std::endl;
+    }
 }
 
 AudioFinalRenderStage::AudioFinalRenderStage(const std::string & stage_name,
@@ -48,11 +58,54 @@ AudioFinalRenderStage::AudioFinalRenderStage(const std::string & stage_name,
                                     m_color_attachment_count++,
                                     GL_NEAREST);
 
+    auto output_samples_per_texel =
+        new AudioIntParameter("output_samples_per_texel",
+                              AudioParameter::ConnectionType::INITIALIZATION);
+    output_samples_per_texel->set_value(1);
+
     m_output_data_channel_seperated.resize(num_channels);
 
     if (!this->add_parameter(output_audio_texture)) {
         std::cerr << "Failed to add output_audio_texture" << std::endl;
     }
+
+    if (!this->add_parameter(output_samples_per_texel)) {
+        std::cerr << "Failed to add output_samples_per_texel" << std::endl;
+    }
+}
+
+bool AudioFinalRenderStage::set_readback_latency(const unsigned int blocks) {
+    for (const auto & param_name : {"final_output_audio_texture", "output_audio_texture"}) {
+        auto texture_param = dynamic_cast<AudioTexture2DParameter *>(this->find_parameter(param_name));
+        if (texture_param == nullptr || !texture_param->set_readback_latency(blocks)) {
+            std::cerr << "Failed to set readback latency on " << param_name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AudioFinalRenderStage::set_packed_output(const bool packed) {
+    if (m_initialized) {
+        std::cerr << "Error: The output layout must be set before initialization of " << name << std::endl;
+        return false;
+    }
+
+    // Every output shares the framebuffer, so they all switch layout together
+    for (auto & param : m_parameters) {
+        auto * texture_param = dynamic_cast<AudioTexture2DParameter *>(param.get());
+        if (texture_param == nullptr || param->connection_type != AudioParameter::ConnectionType::OUTPUT) {
+            continue;
+        }
+        if (!texture_param->set_packed_layout(packed)) {
+            std::cerr << "Failed to set the layout of " << param->name << std::endl;
+            return false;
+        }
+    }
+
+    m_samples_per_texel = packed ? AudioTexture2DParameter::PACKED_SAMPLES : 1;
+    find_parameter("output_samples_per_texel")->set_value(static_cast<int>(m_samples_per_texel));
+    return true;
 }
 
 void AudioFinalRenderStage::render(unsigned int time) {
@@ -66,17 +119,29 @@ void AudioFinalRenderStage::render(unsigned int time) {
     //glDrawArrays(GL_TRIANGLES, 0, 6);
     //glUseProgram(0);
 
-    auto output_audio_texture_param = this->find_parameter("final_output_audio_texture");
-    if (output_audio_texture_param) {
-        float * output_buffer_data = (float*)output_audio_texture_param->get_value();
-        m_output_buffer_data.assign(output_buffer_data, output_buffer_data + (frames_per_buffer * num_channels));
+    AudioStageTimer::Scope readback_scope(m_stage_timer, AudioStageTimer::Phase::READBACK);
+
+    // With batching, the blocks of the batch follow each other in the readback.
+    // A packed output reads back in the same order, so it needs no unpacking.
+    const unsigned int block_samples = frames_per_buffer * num_channels;
+
+    if (m_final_output_audio_texture) {
+        float * output_buffer_data = (float*)m_final_output_audio_texture->get_value();
+        m_output_buffer_data.assign(output_buffer_data, output_buffer_data + (block_samples * m_blocks_per_render));
     }
 
-    auto channel_seperated = this->find_parameter("output_audio_texture");
-    if (channel_seperated) {
-        float * output_buffer_data = (float*)channel_seperated->get_value();
+    if (m_output_audio_texture) {
+        float * output_buffer_data = (float*)m_output_audio_texture->get_value();
         for (unsigned int i = 0; i < num_channels; ++i) {
-            m_output_data_channel_seperated[i].assign(output_buffer_data + (i * frames_per_buffer), output_buffer_data + ((i + 1) * frames_per_buffer));
+            m_output_data_channel_seperated[i].clear();
+            for (unsigned int block = 0; block < m_blocks_per_render; ++block) {
+                const float * channel_data = output_buffer_data + block * block_samples + i * frames_per_buffer;
+                m_output_data_channel_seperated[i].insert(m_output_data_channel_seperated[i].end(), channel_data, channel_data + frames_per_buffer);
+            }
         }
     }
-}
\ No newline at end of file
+}
+void AudioFinalRenderStage::resolve_parameters() {
+    AudioRenderStage::resolve_parameters();
+    m_final_output_audio_texture = dynamic_cast<AudioTexture2DParameter *>(find_parameter("final_output_audio_texture"));
+}
@@ -325,9 +325,10 @@ void AudioGeneratorRenderStage::play_note(const std::pair<float, float>& note)
     float tone = note.first;
     float gain = note.second;
 
+    // The note starts with the next render, which begins m_blocks_per_render blocks later
     unsigned int time;
     if (m_time == 0) time = m_time;
-    else time = m_time + 1;
+    else time = m_time + m_blocks_per_render;
 
     unsigned int idx = m_note_state.add_note(time, -1, tone, gain, MAX_NOTES_PLAYED_AT_ONCE); // Shift by one because note doesn't start until next frame
 
@@ -341,9 +342,10 @@ void AudioGeneratorRenderStage::play_note(const std::pair<float, float>& note)
 
 void AudioGeneratorRenderStage::stop_note(const float tone)
 {
+    // The note stops with the next render, which begins m_blocks_per_render blocks later
     unsigned int time;
     if (m_time == 0) time = m_time;
-    else time = m_time + 1;
+    else time = m_time + m_blocks_per_render;
 
     int tone_index = m_note_state.stop_note(tone, time);
 
@@ -351,14 +353,13 @@ void AudioGeneratorRenderStage::stop_note(const float tone)
         return;
     }
 
-    auto stop_positions = find_parameter("stop_positions");
-    if (stop_positions) stop_positions->set_value(m_note_state.m_stop_positions.data());
+    if (m_stop_positions_param) m_stop_positions_param->set_value(m_note_state.m_stop_positions.data());
 
     static float last_release_time = -1.0f;
     static int release_time_buffers = 0;
 
     // TODO: abstract this so that you can apply to other envelopes
-    float release_time = *(float *)find_parameter("release_time")->get_value();
+    float release_time = m_release_time_param ? *(float *)m_release_time_param->get_value() : 0.0f;
     if (release_time != last_release_time) {
         float seconds_per_buffer = (float)frames_per_buffer / (float)sample_rate;
         release_time_buffers = (int)(release_time / seconds_per_buffer) + 1;
@@ -386,12 +387,27 @@ void AudioGeneratorRenderStage::delete_note(const unsigned int index)
 void AudioGeneratorRenderStage::render(const unsigned int time) {
     AudioRenderStage::render(time);
 
-    if (m_delete_at_time.find(time) != m_delete_at_time.end()) {
-        delete_note(m_delete_at_time[time]);
-        m_delete_at_time.erase(time);
+    // A batched render covers several blocks, any of which may end a note
+    for (unsigned int block = 0; block < m_blocks_per_render; ++block) {
+        auto it = m_delete_at_time.find(time + block);
+        if (it != m_delete_at_time.end()) {
+            const int index = it->second;
+            m_delete_at_time.erase(it);
+            delete_note(index);
+        }
     }
 }
 
+void AudioGeneratorRenderStage::resolve_parameters() {
+    AudioRenderStage::resolve_parameters();
+    m_play_positions_param = find_parameter("play_positions");
+    m_stop_positions_param = find_parameter("stop_positions");
+    m_tones_param = find_parameter("tones");
+    m_gains_param = find_parameter("gains");
+    m_active_notes_param = find_parameter("active_notes");
+    m_release_time_param = find_parameter("release_time");
+}
+
 bool AudioGeneratorRenderStage::connect_render_stage(AudioRenderStage * next_stage) {
     if (!AudioRenderStage::connect_render_stage(next_stage)) {
         return false;
@@ -432,16 +448,11 @@ AudioGeneratorRenderStage::NoteState::NoteState(unsigned int max_notes)
 {}
 
 void AudioGeneratorRenderStage::NoteState::set_parameters(AudioGeneratorRenderStage* owner) {
-    auto active_notes = owner->find_parameter("active_notes");
-    auto play_positions = owner->find_parameter("play_positions");
-    auto stop_positions = owner->find_parameter("stop_positions");
-    auto tones = owner->find_parameter("tones");
-    auto gains = owner->find_parameter("gains");
-    if (active_notes) active_notes->set_value(m_active_notes);
-    if (play_positions) play_positions->set_value(m_play_positions.data());
-    if (stop_positions) stop_positions->set_value(m_stop_positions.data());
-    if (tones) tones->set_value(m_tones.data());
-    if (gains) gains->set_value(m_gains.data());
+    if (owner->m_active_notes_param) owner->m_active_notes_param->set_value(m_active_notes);
+    if (owner->m_play_positions_param) owner->m_play_positions_param->set_value(m_play_positions.data());
+    if (owner->m_stop_positions_param) owner->m_stop_positions_param->set_value(m_stop_positions.data());
+    if (owner->m_tones_param) owner->m_tones_param->set_value(m_tones.data());
+    if (owner->m_gains_param) owner->m_gains_param->set_value(m_gains.data());
 }
 
 void AudioGeneratorRenderStage::NoteState::copy_from(const NoteState& other) {
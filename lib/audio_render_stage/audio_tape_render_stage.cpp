@@ -26,10 +26,14 @@ void AudioRecordRenderStage::render(unsigned int time) {
 
     unsigned int current_block = (time - m_record_start_time);
 
-    auto * data = (float *)this->find_parameter("stream_audio_texture")->get_value();
-
+    float * data = nullptr;
+    {
+        AudioStageTimer::Scope readback_scope(m_stage_timer, AudioStageTimer::Phase::READBACK);
+        data = (float *)m_stream_audio_texture->get_value();
+    }
 
     if (m_recording) {
+        AudioStageTimer::Scope record_scope(m_stage_timer, AudioStageTimer::Phase::RECORD);
 
         unsigned int record_time = current_block + m_record_position;
 
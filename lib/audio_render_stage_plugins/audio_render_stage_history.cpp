@@ -101,6 +101,7 @@ AudioRenderStageHistory2::AudioRenderStageHistory2(const unsigned int frames_per
       m_tape_window_offset_samples(nullptr),
       m_tape_stopped(nullptr),
       m_tape_loop(nullptr),
+      m_tape_ring_write_position(nullptr),
       m_tape() {
     
     // Convert seconds to samples
@@ -119,6 +120,13 @@ AudioRenderStageHistory2::AudioRenderStageHistory2(const unsigned int frames_per
     m_window_size_samples = m_texture_width * m_texture_rows_per_channel;
 }
 
+AudioRenderStageHistory2::~AudioRenderStageHistory2() {
+    if (m_ring_read_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_ring_read_framebuffer);
+        m_ring_read_framebuffer = 0;
+    }
+}
+
 std::string AudioRenderStageHistory2::get_plugin_name() const {
     return m_plugin_name;
 }
@@ -140,6 +148,7 @@ void AudioRenderStageHistory2::create_parameters(GLuint& active_texture_count, G
     std::string window_offset_name = make_parameterized_name("tape_window_offset_samples", m_plugin_name);
     std::string stopped_name = make_parameterized_name("tape_stopped", m_plugin_name);
     std::string loop_name = make_parameterized_name("tape_loop", m_plugin_name);
+    std::string ring_write_position_name = make_parameterized_name("tape_ring_write_position", m_plugin_name);
     
     // Create the texture parameter
     auto audio_history_texture = new AudioTexture2DParameter(texture_name,
@@ -156,6 +165,7 @@ void AudioRenderStageHistory2::create_parameters(GLuint& active_texture_count, G
     delete[] temp_buffer;
     
     m_audio_history_texture = audio_history_texture;
+    m_window_uploaded = false;
     
     // Create uniform parameters for tape control
     m_tape_position = new AudioIntParameter(position_name, AudioParameter::ConnectionType::INPUT);
@@ -180,6 +190,10 @@ void AudioRenderStageHistory2::create_parameters(GLuint& active_texture_count, G
     // Create tape loop flag parameter (1 = loop enabled, 0 = loop disabled, default = 0)
     m_tape_loop = new AudioIntParameter(loop_name, AudioParameter::ConnectionType::INPUT);
     static_cast<AudioIntParameter*>(m_tape_loop)->set_value(0); // Default to no loop
+
+    // Create ring write position parameter (nothing held until the first update)
+    m_tape_ring_write_position = new AudioIntParameter(ring_write_position_name, AudioParameter::ConnectionType::INPUT);
+    static_cast<AudioIntParameter*>(m_tape_ring_write_position)->set_value(0);
 }
 
 std::vector<AudioParameter*> AudioRenderStageHistory2::get_parameters() const {
@@ -191,6 +205,7 @@ std::vector<AudioParameter*> AudioRenderStageHistory2::get_parameters() const {
     if (m_tape_window_offset_samples) params.push_back(m_tape_window_offset_samples);
     if (m_tape_stopped) params.push_back(m_tape_stopped);
     if (m_tape_loop) params.push_back(m_tape_loop);
+    if (m_tape_ring_write_position) params.push_back(m_tape_ring_write_position);
     return params;
 }
 
@@ -637,6 +652,10 @@ void AudioRenderStageHistory2::update_window() {
     if (!m_audio_history_texture) {
         return; // Texture not created yet
     }
+
+    if (m_gpu_ring_enabled) {
+        return; // History texture is written on the GPU
+    }
     
     auto tape = m_tape.lock();
     if (!tape) {
@@ -645,19 +664,196 @@ void AudioRenderStageHistory2::update_window() {
     
     // Calculate the window offset (same value used for both data loading and shader uniform)
     const unsigned int window_offset_samples = get_window_offset_samples_for_tape_data();
-    
-    // Get tape data in texture format
-    std::vector<float> texture_data = tape->playback_for_render_stage_history(
-        get_window_size_samples(),
-        window_offset_samples,
-        m_texture_width,
-        m_texture_rows_per_channel);
-    
-    // Update texture
-    static_cast<AudioTexture2DParameter*>(m_audio_history_texture)->set_value(texture_data.data());
-    
-    // Update window offset parameter
+    const unsigned int window_end_samples = window_offset_samples + m_window_size_samples;
+
+    // The texture is addressed as a ring, so samples that stay in the window keep their place
+    // and only the samples that entered the window or changed on the tape need uploading
+    std::vector<std::pair<unsigned int, unsigned int>> changed_ranges;
+    const bool incremental = m_window_uploaded &&
+                             tape->get_modified_ranges_since(m_uploaded_tape_revision, changed_ranges);
+    if (incremental) {
+        const unsigned int uploaded_end = m_uploaded_window_offset + m_window_size_samples;
+        if (window_offset_samples > m_uploaded_window_offset) {
+            changed_ranges.push_back({std::max(uploaded_end, window_offset_samples), window_end_samples});
+        } else if (window_offset_samples < m_uploaded_window_offset) {
+            changed_ranges.push_back({window_offset_samples, std::min(m_uploaded_window_offset, window_end_samples)});
+        }
+    } else {
+        changed_ranges.assign(1, {window_offset_samples, window_end_samples});
+    }
+
+    for (const auto & range : changed_ranges) {
+        // Only samples inside the new window are held in the texture
+        const unsigned int start = std::max(range.first, window_offset_samples);
+        const unsigned int end = std::min(range.second, window_end_samples);
+        if (start < end) {
+            upload_window_range(*tape, start, end);
+        }
+    }
+
+    m_window_uploaded = true;
+    m_uploaded_window_offset = window_offset_samples;
+    m_uploaded_tape_revision = tape->get_revision();
+
+    // Update window parameters
     set_window_offset_samples(window_offset_samples);
+    if (m_tape_ring_write_position) {
+        static_cast<AudioIntParameter*>(m_tape_ring_write_position)->set_value(static_cast<int>(window_end_samples));
+    }
+}
+
+void AudioRenderStageHistory2::upload_window_range(const AudioTape & tape, unsigned int start, unsigned int end) {
+    auto history_texture = static_cast<AudioTexture2DParameter*>(m_audio_history_texture);
+    std::vector<float> samples(m_texture_width);
+
+    // Split the range where it crosses a texture row or the end of the ring
+    unsigned int position = start;
+    while (position < end) {
+        const unsigned int ring_position = position % m_window_size_samples;
+        const unsigned int x_position = ring_position % m_texture_width;
+        const unsigned int row = ring_position / m_texture_width;
+        const unsigned int length = std::min(end - position, m_texture_width - x_position);
+
+        for (unsigned int ch = 0; ch < m_num_channels; ++ch) {
+            // Data rows are interleaved with zero rows: ch0, zeros, ch1, zeros, ...
+            tape.playback_range_for_render_stage_history(ch, position, length, samples.data());
+            history_texture->set_value(samples.data(), x_position, (row * m_num_channels + ch) * 2, length, 1);
+        }
+        position += length;
+    }
+}
+
+void AudioRenderStageHistory2::set_gpu_ring_enabled(bool enabled) {
+    if (m_gpu_ring_enabled == enabled) {
+        return;
+    }
+    m_gpu_ring_enabled = enabled;
+
+    // The texture contents no longer match the tape window
+    m_window_uploaded = false;
+
+    if (m_gpu_ring_enabled) {
+        // Start with an empty ring, stale tape data in the texture is masked out by the uniforms
+        clear_gpu_ring();
+    } else {
+        // Reload the window from the tape, at full precision if the ring followed a half float stream
+        auto history_texture = static_cast<AudioTexture2DParameter*>(m_audio_history_texture);
+        if (history_texture != nullptr && history_texture->is_half_float()) {
+            history_texture->set_half_float(false);
+        }
+        update_window();
+    }
+}
+
+bool AudioRenderStageHistory2::record_block_to_gpu_ring(const AudioTexture2DParameter * source, const unsigned int record_position) {
+    if (!m_gpu_ring_enabled) {
+        std::cerr << "Error: GPU ring history is not enabled" << std::endl;
+        return false;
+    }
+
+    auto history_texture = static_cast<AudioTexture2DParameter*>(m_audio_history_texture);
+    if (history_texture == nullptr || history_texture->get_texture() == 0) {
+        std::cerr << "Error: History texture is not initialized" << std::endl;
+        return false;
+    }
+
+    if (source == nullptr) {
+        std::cerr << "Error: Source texture for GPU ring history is nullptr" << std::endl;
+        return false;
+    }
+
+    // An output parameter renders into the texture of the parameter it is linked to
+    if (source->connection_type == AudioParameter::ConnectionType::OUTPUT) {
+        auto linked_param = dynamic_cast<AudioTexture2DParameter*>(source->get_linked_parameter());
+        if (linked_param != nullptr) {
+            source = linked_param;
+        }
+    }
+    const GLuint source_texture = source->get_texture();
+    if (source_texture == 0) {
+        std::cerr << "Error: Source texture for GPU ring history is not initialized" << std::endl;
+        return false;
+    }
+
+    // Copies need matching component sizes, so the ring takes the precision of the stream it records.
+    // The samples held so far are lost with the old storage.
+    if (history_texture->is_half_float() != source->is_half_float()) {
+        if (!history_texture->set_half_float(source->is_half_float())) {
+            std::cerr << "Error: Could not match the GPU ring history to the precision of its source" << std::endl;
+            return false;
+        }
+        m_ring_start_position = 0;
+        m_ring_write_position = 0;
+    }
+
+    if (m_ring_read_framebuffer == 0) {
+        glGenFramebuffers(1, &m_ring_read_framebuffer);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_ring_read_framebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source_texture, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindTexture(GL_TEXTURE_2D, history_texture->get_texture());
+
+    // Copy the block into the ring, splitting it where it crosses a texture row or the end of the ring
+    const unsigned int ring_size = m_window_size_samples;
+    unsigned int copied = 0;
+    while (copied < m_frames_per_buffer) {
+        const unsigned int ring_position = (record_position + copied) % ring_size;
+        const unsigned int x_position = ring_position % m_texture_width;
+        const unsigned int row = ring_position / m_texture_width;
+        const unsigned int length = std::min(m_frames_per_buffer - copied, m_texture_width - x_position);
+
+        for (unsigned int ch = 0; ch < m_num_channels; ++ch) {
+            // Data rows are interleaved with zero rows: ch0, zeros, ch1, zeros, ...
+            const unsigned int y_position = (row * m_num_channels + ch) * 2;
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x_position, y_position, copied, ch, length, 1);
+        }
+        copied += length;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    GLenum status = glGetError();
+    if (status != GL_NO_ERROR) {
+        std::cerr << "Error: OpenGL error " << status << " recording block to GPU ring history" << std::endl;
+        return false;
+    }
+
+    // Samples are only contiguous if this block continues or re-records the recorded range
+    if (m_ring_write_position == m_ring_start_position ||
+        record_position < m_ring_start_position ||
+        record_position > m_ring_write_position) {
+        m_ring_start_position = record_position;
+    }
+    m_ring_write_position = record_position + m_frames_per_buffer;
+
+    update_gpu_ring_parameters();
+    return true;
+}
+
+void AudioRenderStageHistory2::clear_gpu_ring() {
+    m_ring_start_position = 0;
+    m_ring_write_position = 0;
+    if (m_gpu_ring_enabled) {
+        update_gpu_ring_parameters();
+    }
+}
+
+void AudioRenderStageHistory2::update_gpu_ring_parameters() {
+    // The oldest sample still held in the ring is used as the window offset
+    const unsigned int ring_size = m_window_size_samples;
+    unsigned int oldest_position = m_ring_start_position;
+    if (m_ring_write_position > ring_size && m_ring_write_position - ring_size > oldest_position) {
+        oldest_position = m_ring_write_position - ring_size;
+    }
+
+    set_window_offset_samples(oldest_position);
+    if (m_tape_ring_write_position) {
+        static_cast<AudioIntParameter*>(m_tape_ring_write_position)->set_value(static_cast<int>(m_ring_write_position));
+    }
 }
 
 void AudioRenderStageHistory2::update_audio_history_texture() {
@@ -877,6 +1073,7 @@ const unsigned int AudioRenderStageHistory2::get_window_offset_samples_for_tape_
 
 void AudioRenderStageHistory2::set_tape(std::weak_ptr<AudioTape> tape) {
     m_tape = tape;
+    m_window_uploaded = false;
 }
 
 std::weak_ptr<AudioTape> AudioRenderStageHistory2::get_tape() {
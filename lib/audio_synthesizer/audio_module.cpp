@@ -17,9 +17,12 @@ void AudioModuleManager::add_module(std::shared_ptr<AudioModule> module) {
     m_module_index[module->name()] = m_modules.size();
     m_modules.push_back(module);
 
-    // Add the render stage to the render graph at the root
-    for (auto & render_stage : module->m_render_stages) {
-        m_render_graph.insert_render_stage_infront(m_graph_root, render_stage);
+    // Add the render stage to the render graph at the root, rendered from the same block
+    {
+        AudioRenderGraph::EditScope edit(m_render_graph);
+        for (auto & render_stage : module->m_render_stages) {
+            m_render_graph.insert_render_stage_infront(m_graph_root, render_stage);
+        }
     }
 
     // Add the controls to the control registry
@@ -54,11 +57,15 @@ std::shared_ptr<AudioModule> AudioModuleManager::replace_module(const std::strin
     }
 
     // TODO: Add functionality to replace subgraphs in render graph
-    for (auto & render_stage : old_module->m_render_stages) {
-        m_render_graph.remove_render_stage(render_stage->gid);
-    }
-    for (auto & render_stage : new_module->m_render_stages) {
-        m_render_graph.insert_render_stage_infront(m_graph_root, render_stage);
+    // The render path keeps the old module until the whole swap is published as one plan
+    {
+        AudioRenderGraph::EditScope edit(m_render_graph);
+        for (auto & render_stage : old_module->m_render_stages) {
+            m_render_graph.remove_render_stage(render_stage->gid);
+        }
+        for (auto & render_stage : new_module->m_render_stages) {
+            m_render_graph.insert_render_stage_infront(m_graph_root, render_stage);
+        }
     }
 
     m_modules[index] = new_module;
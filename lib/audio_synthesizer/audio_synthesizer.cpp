@@ -66,6 +66,9 @@ bool AudioSynthesizer::initialize(const unsigned int buffer_size,
     AudioTrack * track = new AudioTrack(m_render_graph, m_audio_join, m_buffer_size, m_sample_rate, m_num_channels);
     add_track(track);
 
+    // Build the modules the track does not use yet while the renderer is idle
+    track->prewarm_modules();
+
     return true;
 }
 
@@ -28,8 +28,9 @@ AudioTrack::AudioTrack(AudioRenderGraph * render_graph, AudioRenderStage * root_
 
     initialize_modules();
 
-    m_current_effect = m_effect_modules["none"];
-    m_current_voice = m_voice_modules["sine"];
+    // Only the default modules are built up front, the others on first selection
+    m_current_effect = get_effect_module("none");
+    m_current_voice = get_voice_module("sine");
 
     // Add default modules to the manager (voice first, then effect)
     m_module_manager.add_module(m_current_effect);
@@ -37,16 +38,14 @@ AudioTrack::AudioTrack(AudioRenderGraph * render_graph, AudioRenderStage * root_
 }
 
 void AudioTrack::initialize_modules() {
-    m_audio_renderer->activate_render_context();
-
-    std::vector<std::string> effect_names = {"gain", "echo", "frequency_filter", "none"};
-    std::vector<std::string> voice_names = {"sine", "saw", "square", "triangle", "file"};
+    m_effect_names = {"gain", "echo", "frequency_filter", "none"};
+    m_voice_names = {"sine", "saw", "square", "triangle", "file"};
 
     // Make selection controls for effect and voice
-    auto effect_control = new AudioSelectionControl<std::string>("effect", effect_names, "none", [this](const std::string& effect_name) {
+    auto effect_control = new AudioSelectionControl<std::string>("effect", m_effect_names, "none", [this](const std::string& effect_name) {
         this->change_effect(effect_name);
     });
-    auto voice_control = new AudioSelectionControl<std::string>("voice", voice_names, "sine", [this](const std::string& voice_name) {
+    auto voice_control = new AudioSelectionControl<std::string>("voice", m_voice_names, "sine", [this](const std::string& voice_name) {
         this->change_voice(voice_name);
     });
     
@@ -56,83 +55,123 @@ void AudioTrack::initialize_modules() {
 
     // TODO: Change this to be data driven
     // Effect modules
-    auto gain_stage = new AudioGainEffectRenderStage("gain", m_buffer_size, m_sample_rate, m_num_channels);
-    gain_stage->initialize(); // FIXME: Initilize should be removed once moved to construction is initialization
-    m_effect_modules["gain"] = std::make_shared<AudioEffectModule>(
-        "gain",
-        std::vector<AudioEffectRenderStage*>{gain_stage}
-    );
-
-    auto echo_stage = new AudioEchoEffectRenderStage("echo", m_buffer_size, m_sample_rate, m_num_channels);
-    echo_stage->initialize();
-    m_effect_modules["echo"] = std::make_shared<AudioEffectModule>(
-        "echo",
-        std::vector<AudioEffectRenderStage*>{echo_stage}
-    );
-
-    auto frequency_filter_stage = new AudioFrequencyFilterEffectRenderStage("frequency_filter", m_buffer_size, m_sample_rate, m_num_channels);
-    frequency_filter_stage->initialize();
-    m_effect_modules["frequency_filter"] = std::make_shared<AudioEffectModule>(
-        "frequency_filter",
-        std::vector<AudioEffectRenderStage*>{frequency_filter_stage}
-    );
-
-    auto none_stage = new AudioEffectRenderStage("none", m_buffer_size, m_sample_rate, m_num_channels);
-    none_stage->initialize();
-    m_effect_modules["none"] = std::make_shared<AudioEffectModule>(
-        "none",
-        std::vector<AudioEffectRenderStage*>{none_stage}
-    );
+    m_effect_factories["gain"] = [this]() {
+        auto gain_stage = new AudioGainEffectRenderStage("gain", m_buffer_size, m_sample_rate, m_num_channels);
+        gain_stage->initialize(); // FIXME: Initilize should be removed once moved to construction is initialization
+        return std::make_shared<AudioEffectModule>("gain", std::vector<AudioEffectRenderStage*>{gain_stage});
+    };
+
+    m_effect_factories["echo"] = [this]() {
+        auto echo_stage = new AudioEchoEffectRenderStage("echo", m_buffer_size, m_sample_rate, m_num_channels);
+        echo_stage->initialize();
+        return std::make_shared<AudioEffectModule>("echo", std::vector<AudioEffectRenderStage*>{echo_stage});
+    };
+
+    m_effect_factories["frequency_filter"] = [this]() {
+        auto frequency_filter_stage = new AudioFrequencyFilterEffectRenderStage("frequency_filter", m_buffer_size, m_sample_rate, m_num_channels);
+        frequency_filter_stage->initialize();
+        return std::make_shared<AudioEffectModule>("frequency_filter", std::vector<AudioEffectRenderStage*>{frequency_filter_stage});
+    };
+
+    m_effect_factories["none"] = [this]() {
+        auto none_stage = new AudioEffectRenderStage("none", m_buffer_size, m_sample_rate, m_num_channels);
+        none_stage->initialize();
+        return std::make_shared<AudioEffectModule>("none", std::vector<AudioEffectRenderStage*>{none_stage});
+    };
 
     // Voice modules
-    auto sine_stage = new AudioGeneratorRenderStage("sine", m_buffer_size, m_sample_rate, m_num_channels, "build/shaders/multinote_sine_generator_render_stage.glsl");
-    sine_stage->initialize();
-    m_voice_modules["sine"] = std::make_shared<AudioVoiceModule>(
-        "sine",
-        sine_stage
-    );
-
-    auto saw_stage = new AudioGeneratorRenderStage("saw", m_buffer_size, m_sample_rate, m_num_channels, "build/shaders/multinote_sawtooth_generator_render_stage.glsl");
-    saw_stage->initialize();
-    m_voice_modules["saw"] = std::make_shared<AudioVoiceModule>(
-        "saw",
-        saw_stage
-    );
-
-    auto square_stage = new AudioGeneratorRenderStage("square", m_buffer_size, m_sample_rate, m_num_channels, "build/shaders/multinote_square_generator_render_stage.glsl");
-    square_stage->initialize();
-    m_voice_modules["square"] = std::make_shared<AudioVoiceModule>(
-        "square",
-        square_stage
-    );
-
-    auto triangle_stage = new AudioGeneratorRenderStage("triangle", m_buffer_size, m_sample_rate, m_num_channels, "build/shaders/multinote_triangle_generator_render_stage.glsl");
-    triangle_stage->initialize();
-    m_voice_modules["triangle"] = std::make_shared<AudioVoiceModule>(
-        "triangle",
-        triangle_stage
-    );
-
-    auto file_stage = new AudioFileGeneratorRenderStage("file", m_buffer_size, m_sample_rate, m_num_channels, "media/test.wav");
-    file_stage->initialize();
-    m_voice_modules["file"] = std::make_shared<AudioVoiceModule>(
-        "file",
-        file_stage
-    );
+    auto generator_factory = [this](const std::string name, const std::string shader_path) {
+        return [this, name, shader_path]() {
+            auto stage = new AudioGeneratorRenderStage(name, m_buffer_size, m_sample_rate, m_num_channels, shader_path);
+            stage->initialize();
+            return std::make_shared<AudioVoiceModule>(name, stage);
+        };
+    };
+    m_voice_factories["sine"] = generator_factory("sine", "build/shaders/multinote_sine_generator_render_stage.glsl");
+    m_voice_factories["saw"] = generator_factory("saw", "build/shaders/multinote_sawtooth_generator_render_stage.glsl");
+    m_voice_factories["square"] = generator_factory("square", "build/shaders/multinote_square_generator_render_stage.glsl");
+    m_voice_factories["triangle"] = generator_factory("triangle", "build/shaders/multinote_triangle_generator_render_stage.glsl");
+
+    // The file voice loads its file into a tape, so it is the most expensive to build
+    m_voice_factories["file"] = [this]() {
+        auto file_stage = new AudioFileGeneratorRenderStage("file", m_buffer_size, m_sample_rate, m_num_channels, "media/test.wav");
+        file_stage->initialize();
+        return std::make_shared<AudioVoiceModule>("file", file_stage);
+    };
+}
+
+std::shared_ptr<AudioEffectModule> AudioTrack::get_effect_module(const std::string & effect_name) {
+    if (auto it = m_effect_modules.find(effect_name); it != m_effect_modules.end()) {
+        return it->second;
+    }
+
+    auto factory = m_effect_factories.find(effect_name);
+    if (factory == m_effect_factories.end()) {
+        return nullptr;
+    }
+
+    m_audio_renderer->activate_render_context();
+    auto module = factory->second();
+    m_audio_renderer->unactivate_render_context();
+
+    m_effect_modules[effect_name] = module;
+    return module;
+}
+
+std::shared_ptr<AudioVoiceModule> AudioTrack::get_voice_module(const std::string & voice_name) {
+    if (auto it = m_voice_modules.find(voice_name); it != m_voice_modules.end()) {
+        return it->second;
+    }
+
+    auto factory = m_voice_factories.find(voice_name);
+    if (factory == m_voice_factories.end()) {
+        return nullptr;
+    }
 
+    m_audio_renderer->activate_render_context();
+    auto module = factory->second();
     m_audio_renderer->unactivate_render_context();
+
+    m_voice_modules[voice_name] = module;
+    return module;
+}
+
+void AudioTrack::prewarm_modules() {
+    std::weak_ptr<bool> alive = m_alive;
+
+    for (const auto & effect_name : m_effect_names) {
+        if (m_effect_modules.find(effect_name) == m_effect_modules.end()) {
+            m_audio_renderer->add_idle_task([this, alive, effect_name]() {
+                if (!alive.expired()) {
+                    get_effect_module(effect_name);
+                }
+            }, "effect module");
+        }
+    }
+
+    for (const auto & voice_name : m_voice_names) {
+        if (m_voice_modules.find(voice_name) == m_voice_modules.end()) {
+            m_audio_renderer->add_idle_task([this, alive, voice_name]() {
+                if (!alive.expired()) {
+                    get_voice_module(voice_name);
+                }
+            }, "voice module");
+        }
+    }
 }
 
 void AudioTrack::change_effect(const std::string & effect_name) {
+    auto effect_module = get_effect_module(effect_name);
+
     m_audio_renderer->activate_render_context();
 
-    if (m_effect_modules.find(effect_name) != m_effect_modules.end()) {
+    if (effect_module != nullptr) {
         // If m_current_effect is null (during initialization), just set it without replacing
         if (m_current_effect == nullptr) {
-            m_current_effect = m_effect_modules[effect_name];
+            m_current_effect = effect_module;
         } else {
-            m_module_manager.replace_module(m_current_effect->name(), m_effect_modules[effect_name]);
-            m_current_effect = m_effect_modules[effect_name];
+            m_module_manager.replace_module(m_current_effect->name(), effect_module);
+            m_current_effect = effect_module;
 
             std::cout << "Switched effect to " << effect_name << std::endl;
         }
@@ -146,15 +185,17 @@ void AudioTrack::change_effect(const std::string & effect_name) {
 }
 
 void AudioTrack::change_voice(const std::string & voice_name) {
+    auto voice_module = get_voice_module(voice_name);
+
     m_audio_renderer->activate_render_context();
 
-    if (m_voice_modules.find(voice_name) != m_voice_modules.end()) {
+    if (voice_module != nullptr) {
         // If m_current_voice is null (during initialization), just set it without replacing
         if (m_current_voice == nullptr) {
-            m_current_voice = m_voice_modules[voice_name];
+            m_current_voice = voice_module;
         } else {
-            m_module_manager.replace_module(m_current_voice->name(), m_voice_modules[voice_name]);
-            m_current_voice = m_voice_modules[voice_name];
+            m_module_manager.replace_module(m_current_voice->name(), voice_module);
+            m_current_voice = voice_module;
 
             std::cout << "Switched voice to " << voice_name << std::endl;
         }
@@ -172,22 +213,14 @@ AudioTrack::~AudioTrack() {
 }
 
 const std::vector<std::string> AudioTrack::get_effect_names() const {
-    std::vector<std::string> effect_names;
-    for (const auto & effect : m_effect_modules) {
-        effect_names.push_back(effect.first);
-    }
-    return effect_names;
+    return m_effect_names;
 }
 const std::unordered_map<std::string, std::shared_ptr<AudioEffectModule>> & AudioTrack::get_effects() const {
     return m_effect_modules;
 }
 
 const std::vector<std::string> AudioTrack::get_generator_names() const {
-    std::vector<std::string> generator_names;
-    for (const auto & generator : m_voice_modules) {
-        generator_names.push_back(generator.first);
-    }
-    return generator_names;
+    return m_voice_names;
 }
 const std::unordered_map<std::string, std::shared_ptr<AudioVoiceModule>> & AudioTrack::get_voices() const {
     return m_voice_modules;
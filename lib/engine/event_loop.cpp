@@ -4,6 +4,7 @@
 #include "engine/event_loop.h"
 #include "engine/renderable_entity.h"
 #include "engine/event_handler.h"
+#include "utilities/audio_tracer.h"
 
 // Define static instance pointer
 EventLoop* EventLoop::s_instance = nullptr;
@@ -42,6 +43,8 @@ void EventLoop::run_loop() {
         std::abort();
     }
 
+    AudioTracer::set_thread_name("main");
+
     Uint32 last_time = SDL_GetTicks();
     Uint32 frame_count = 0;
 
@@ -52,6 +55,8 @@ void EventLoop::run_loop() {
     }
 
     while (true) {
+        AUDIO_TRACE_SCOPE("EventLoop::iteration", "ui");
+
         SDL_Event event;
         bool event_occurred = false;
         while (SDL_PollEvent(&event)) {
@@ -7,6 +7,7 @@
 #include "graphics_core/graphics_view.h"
 #include "engine/event_loop.h"
 #include "graphics_core/graphics_component.h"
+#include "utilities/audio_tracer.h"
 
 GLuint m_shaderProgram;
 
@@ -76,6 +77,8 @@ bool GraphicsDisplay::is_ready() {
 
 void GraphicsDisplay::render() {
     IRenderableEntity::render(); // Call the base class render to update FPS
+    AUDIO_TRACE_SCOPE("GraphicsDisplay::render", "ui");
+
     if (m_current_view) {
         m_current_view->render();
     }
@@ -0,0 +1,55 @@
+#include <stdexcept>
+
+#include "utilities/audio_command_queue.h"
+
+AudioCommandQueue::AudioCommandQueue(const unsigned int capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("AudioCommandQueue needs room for at least one command");
+    }
+    m_commands.resize(capacity);
+}
+
+bool AudioCommandQueue::push(Command command) {
+    release_executed();
+
+    const size_t write_index = m_write_index.load(std::memory_order_relaxed);
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    if (write_index - read_index >= m_commands.size()) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_commands[write_index % m_commands.size()] = std::move(command);
+    m_write_index.store(write_index + 1, std::memory_order_release);
+    return true;
+}
+
+unsigned int AudioCommandQueue::execute_all() {
+    size_t read_index = m_read_index.load(std::memory_order_relaxed);
+    const size_t write_index = m_write_index.load(std::memory_order_acquire);
+
+    unsigned int executed = 0;
+    while (read_index != write_index) {
+        // The producer destroys the command once it sees the read index past it
+        auto & command = m_commands[read_index % m_commands.size()];
+        if (command) {
+            command();
+        }
+        m_read_index.store(++read_index, std::memory_order_release);
+        executed++;
+    }
+    return executed;
+}
+
+void AudioCommandQueue::release_executed() {
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    while (m_release_index != read_index) {
+        m_commands[m_release_index % m_commands.size()] = nullptr;
+        m_release_index++;
+    }
+}
+
+unsigned int AudioCommandQueue::size() const {
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    const size_t write_index = m_write_index.load(std::memory_order_acquire);
+    return static_cast<unsigned int>(write_index - read_index);
+}
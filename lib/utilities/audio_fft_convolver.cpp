@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "utilities/audio_fft_convolver.h"
+
+AudioFFTConvolver::AudioFFTConvolver(const unsigned int block_size, const unsigned int num_channels)
+    : m_block_size(block_size),
+      m_num_channels(num_channels) {
+    if (block_size == 0 || num_channels == 0) {
+        throw std::invalid_argument("AudioFFTConvolver needs at least one channel of at least one sample");
+    }
+
+    // Overlap-save needs room for a block and a partition
+    m_fft_size = 2;
+    while (m_fft_size < 2 * block_size) {
+        m_fft_size *= 2;
+    }
+    m_num_bins = m_fft_size / 2 + 1;
+
+    m_twiddles.resize(m_fft_size / 2);
+    for (unsigned int k = 0; k < m_fft_size / 2; ++k) {
+        const double angle = -2.0 * M_PI * k / m_fft_size;
+        m_twiddles[k] = std::complex<float>(std::cos(angle), std::sin(angle));
+    }
+
+    unsigned int num_bits = 0;
+    while ((1u << num_bits) < m_fft_size) {
+        num_bits++;
+    }
+    m_bit_reversed.resize(m_fft_size);
+    for (unsigned int i = 0; i < m_fft_size; ++i) {
+        unsigned int reversed = 0;
+        for (unsigned int bit = 0; bit < num_bits; ++bit) {
+            reversed |= ((i >> bit) & 1u) << (num_bits - 1 - bit);
+        }
+        m_bit_reversed[i] = reversed;
+    }
+
+    m_input_history.assign(num_channels, std::vector<float>(m_fft_size, 0.0f));
+    m_input_spectra.resize(num_channels);
+    m_fft_buffer.resize(m_fft_size);
+    m_accumulator.resize(m_fft_size);
+}
+
+void AudioFFTConvolver::set_impulse_response(const float * coefficients, const unsigned int num_taps) {
+    set_impulse_responses(coefficients, num_taps, 1, num_taps);
+}
+
+void AudioFFTConvolver::set_impulse_responses(const float * coefficients, const unsigned int num_taps,
+                                              const unsigned int num_responses, const unsigned int stride) {
+    const unsigned int num_partitions = (num_taps + m_block_size - 1) / m_block_size;
+
+    m_partition_spectra.resize(num_responses);
+    for (unsigned int response = 0; response < num_responses; ++response) {
+        const float * response_coefficients = coefficients + response * stride;
+        auto & response_spectra = m_partition_spectra[response];
+        response_spectra.resize(num_partitions);
+        for (unsigned int partition = 0; partition < num_partitions; ++partition) {
+            const unsigned int first_tap = partition * m_block_size;
+            const unsigned int length = std::min(m_block_size, num_taps - first_tap);
+
+            std::fill(m_fft_buffer.begin(), m_fft_buffer.end(), std::complex<float>(0.0f, 0.0f));
+            for (unsigned int i = 0; i < length; ++i) {
+                m_fft_buffer[i] = response_coefficients[first_tap + i];
+            }
+            transform(m_fft_buffer, false);
+            response_spectra[partition].assign(m_fft_buffer.begin(), m_fft_buffer.begin() + m_num_bins);
+        }
+    }
+
+    if (num_partitions != m_num_partitions) {
+        // Keep the most recent input spectra, newest first in the resized delay line
+        for (auto & spectra : m_input_spectra) {
+            std::vector<std::vector<std::complex<float>>> resized(num_partitions, std::vector<std::complex<float>>(m_num_bins));
+            const unsigned int kept = std::min(num_partitions, m_num_partitions);
+            for (unsigned int age = 0; age < kept; ++age) {
+                const unsigned int old_index = (m_newest_spectrum + m_num_partitions - age) % m_num_partitions;
+                resized[(num_partitions - age) % num_partitions] = std::move(spectra[old_index]);
+            }
+            spectra = std::move(resized);
+        }
+        m_newest_spectrum = 0;
+        m_num_partitions = num_partitions;
+    }
+}
+
+void AudioFFTConvolver::process(const float * input, float * output, const bool new_block,
+                                const unsigned int response, const float weight) {
+    if (new_block && m_num_partitions > 0) {
+        m_newest_spectrum = (m_newest_spectrum + 1) % m_num_partitions;
+    }
+
+    // The response and the next one, which is only read with a weight
+    const unsigned int num_responses = get_num_responses();
+    const unsigned int first_response = num_responses > 0 ? std::min(response, num_responses - 1) : 0;
+    const unsigned int next_response = std::min(first_response + 1, num_responses > 0 ? num_responses - 1 : 0);
+    const bool mixed = weight > 0.0f && next_response != first_response;
+
+    for (unsigned int channel = 0; channel < m_num_channels; ++channel) {
+        const float * channel_input = input + channel * m_block_size;
+        float * channel_output = output + channel * m_block_size;
+
+        // The last fft size samples of the input, this block at the end
+        auto & history = m_input_history[channel];
+        if (new_block) {
+            std::memmove(history.data(), history.data() + m_block_size, (m_fft_size - m_block_size) * sizeof(float));
+        }
+        std::memcpy(history.data() + m_fft_size - m_block_size, channel_input, m_block_size * sizeof(float));
+
+        if (m_num_partitions == 0) {
+            std::fill(channel_output, channel_output + m_block_size, 0.0f);
+            continue;
+        }
+
+        for (unsigned int i = 0; i < m_fft_size; ++i) {
+            m_fft_buffer[i] = history[i];
+        }
+        transform(m_fft_buffer, false);
+        auto & spectra = m_input_spectra[channel];
+        spectra[m_newest_spectrum].assign(m_fft_buffer.begin(), m_fft_buffer.begin() + m_num_bins);
+
+        // Partition p applies to the input spectrum of p blocks ago
+        std::fill(m_accumulator.begin(), m_accumulator.end(), std::complex<float>(0.0f, 0.0f));
+        for (unsigned int partition = 0; partition < m_num_partitions; ++partition) {
+            const auto & input_spectrum = spectra[(m_newest_spectrum + m_num_partitions - partition) % m_num_partitions];
+            const auto & partition_spectrum = m_partition_spectra[first_response][partition];
+            if (!mixed) {
+                for (unsigned int bin = 0; bin < m_num_bins; ++bin) {
+                    m_accumulator[bin] += input_spectrum[bin] * partition_spectrum[bin];
+                }
+                continue;
+            }
+            const auto & next_spectrum = m_partition_spectra[next_response][partition];
+            for (unsigned int bin = 0; bin < m_num_bins; ++bin) {
+                m_accumulator[bin] += input_spectrum[bin] * (partition_spectrum[bin] + weight * (next_spectrum[bin] - partition_spectrum[bin]));
+            }
+        }
+        for (unsigned int bin = m_num_bins; bin < m_fft_size; ++bin) {
+            m_accumulator[bin] = std::conj(m_accumulator[m_fft_size - bin]);
+        }
+        transform(m_accumulator, true);
+
+        // The start of the circular convolution wraps around, only the last block is linear
+        for (unsigned int i = 0; i < m_block_size; ++i) {
+            channel_output[i] = m_accumulator[m_fft_size - m_block_size + i].real();
+        }
+    }
+}
+
+void AudioFFTConvolver::reset() {
+    for (auto & history : m_input_history) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    for (auto & spectra : m_input_spectra) {
+        for (auto & spectrum : spectra) {
+            std::fill(spectrum.begin(), spectrum.end(), std::complex<float>(0.0f, 0.0f));
+        }
+    }
+    m_newest_spectrum = 0;
+}
+
+void AudioFFTConvolver::transform(std::vector<std::complex<float>> & data, const bool inverse) const {
+    for (unsigned int i = 0; i < m_fft_size; ++i) {
+        if (i < m_bit_reversed[i]) {
+            std::swap(data[i], data[m_bit_reversed[i]]);
+        }
+    }
+
+    for (unsigned int length = 2; length <= m_fft_size; length *= 2) {
+        const unsigned int half = length / 2;
+        const unsigned int twiddle_step = m_fft_size / length;
+        for (unsigned int start = 0; start < m_fft_size; start += length) {
+            for (unsigned int k = 0; k < half; ++k) {
+                const auto twiddle = inverse ? std::conj(m_twiddles[k * twiddle_step]) : m_twiddles[k * twiddle_step];
+                const auto odd = data[start + k + half] * twiddle;
+                data[start + k + half] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+
+    if (inverse) {
+        const float scale = 1.0f / m_fft_size;
+        for (auto & value : data) {
+            value *= scale;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "utilities/audio_ring_buffer.h"
+
+AudioRingBuffer::AudioRingBuffer(const unsigned int num_blocks, const unsigned int block_size)
+    : m_num_blocks(num_blocks),
+      m_block_size(block_size) {
+    if (num_blocks == 0 || block_size == 0) {
+        throw std::invalid_argument("AudioRingBuffer needs at least one block of at least one sample");
+    }
+    m_data.resize(static_cast<size_t>(num_blocks) * block_size, 0.0f);
+}
+
+float * AudioRingBuffer::acquire_write() {
+    const size_t write_index = m_write_index.load(std::memory_order_relaxed);
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    if (write_index - read_index >= m_num_blocks) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return block_at(write_index);
+}
+
+void AudioRingBuffer::commit() {
+    const size_t write_index = m_write_index.load(std::memory_order_relaxed);
+    m_write_index.store(write_index + 1, std::memory_order_release);
+}
+
+bool AudioRingBuffer::push(const float * block) {
+    float * destination = acquire_write();
+    if (destination == nullptr) {
+        return false;
+    }
+    std::memcpy(destination, block, m_block_size * sizeof(float));
+    commit();
+    return true;
+}
+
+const float * AudioRingBuffer::acquire_read() {
+    const size_t read_index = m_read_index.load(std::memory_order_relaxed);
+    const size_t write_index = m_write_index.load(std::memory_order_acquire);
+    if (read_index == write_index) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return block_at(read_index);
+}
+
+void AudioRingBuffer::release() {
+    const size_t read_index = m_read_index.load(std::memory_order_relaxed);
+    m_read_index.store(read_index + 1, std::memory_order_release);
+}
+
+bool AudioRingBuffer::pop(float * block) {
+    const float * source = acquire_read();
+    if (source == nullptr) {
+        return false;
+    }
+    std::memcpy(block, source, m_block_size * sizeof(float));
+    release();
+    return true;
+}
+
+void AudioRingBuffer::clear() {
+    m_read_index.store(m_write_index.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+unsigned int AudioRingBuffer::read_available() const {
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    const size_t write_index = m_write_index.load(std::memory_order_acquire);
+    // The other side may move between the two loads, so clamp to the ring size
+    return static_cast<unsigned int>(std::min<size_t>(write_index - read_index, m_num_blocks));
+}
+
+unsigned int AudioRingBuffer::write_available() const {
+    return m_num_blocks - read_available();
+}
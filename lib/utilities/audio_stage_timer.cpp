@@ -0,0 +1,160 @@
+#include "utilities/audio_stage_timer.h"
+
+#if AUDIO_STAGE_TIMING
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+
+// Entry points of GL_EXT_disjoint_timer_query, loaded once
+struct TimerQueryFunctions {
+    PFNGLGENQUERIESEXTPROC gen_queries = nullptr;
+    PFNGLDELETEQUERIESEXTPROC delete_queries = nullptr;
+    PFNGLBEGINQUERYEXTPROC begin_query = nullptr;
+    PFNGLENDQUERYEXTPROC end_query = nullptr;
+    PFNGLGETQUERYOBJECTUIVEXTPROC get_query_uiv = nullptr;
+    PFNGLGETQUERYOBJECTUI64VEXTPROC get_query_ui64v = nullptr;
+
+    bool loaded() const {
+        return gen_queries && delete_queries && begin_query && end_query && get_query_uiv && get_query_ui64v;
+    }
+};
+
+static const TimerQueryFunctions & timer_query_functions() {
+    static const TimerQueryFunctions functions = []() {
+        TimerQueryFunctions loaded;
+        loaded.gen_queries = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueriesEXT"));
+        loaded.delete_queries = reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueriesEXT"));
+        loaded.begin_query = reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQueryEXT"));
+        loaded.end_query = reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQueryEXT"));
+        loaded.get_query_uiv = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuivEXT"));
+        loaded.get_query_ui64v = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(eglGetProcAddress("glGetQueryObjectui64vEXT"));
+        return loaded;
+    }();
+    return functions;
+}
+
+AudioStageTimer::~AudioStageTimer() {
+    if (m_gpu_queries[0] != 0) {
+        timer_query_functions().delete_queries(NUM_GPU_QUERIES, m_gpu_queries.data());
+    }
+}
+
+void AudioStageTimer::end_block() {
+    collect_gpu_results();
+    m_current[static_cast<std::size_t>(Phase::GPU)] = m_gpu_latest;
+
+    const std::size_t write_index = m_write_index.load(std::memory_order_relaxed);
+    auto & sample = m_samples[write_index % RING_SIZE];
+    for (std::size_t phase = 0; phase < NUM_PHASES; phase++) {
+        sample[phase].store(m_current[phase], std::memory_order_relaxed);
+    }
+    m_write_index.store(write_index + 1, std::memory_order_release);
+}
+
+bool AudioStageTimer::gpu_timing_supported() {
+    const char * extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    return extensions != nullptr &&
+           std::strstr(extensions, "GL_EXT_disjoint_timer_query") != nullptr &&
+           timer_query_functions().loaded();
+}
+
+void AudioStageTimer::begin_gpu() {
+    if (!m_gpu_initialized) {
+        m_gpu_initialized = true;
+        if (gpu_timing_supported()) {
+            timer_query_functions().gen_queries(NUM_GPU_QUERIES, m_gpu_queries.data());
+        }
+    }
+    if (m_gpu_queries[0] == 0) {
+        return;
+    }
+
+    // Never wait on the GPU: skip this draw if every query is still in flight
+    collect_gpu_results();
+    if (m_gpu_issued - m_gpu_collected == NUM_GPU_QUERIES) {
+        return;
+    }
+
+    timer_query_functions().begin_query(GL_TIME_ELAPSED_EXT, m_gpu_queries[m_gpu_issued % NUM_GPU_QUERIES]);
+    m_gpu_active = true;
+}
+
+void AudioStageTimer::end_gpu() {
+    if (!m_gpu_active) {
+        return;
+    }
+    timer_query_functions().end_query(GL_TIME_ELAPSED_EXT);
+    m_gpu_active = false;
+    m_gpu_issued++;
+}
+
+void AudioStageTimer::collect_gpu_results() {
+    if (m_gpu_collected == m_gpu_issued) {
+        return;
+    }
+    const auto & functions = timer_query_functions();
+
+    // A disjoint event (e.g. a frequency change) invalidates every query in flight
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    while (m_gpu_collected < m_gpu_issued) {
+        const GLuint query = m_gpu_queries[m_gpu_collected % NUM_GPU_QUERIES];
+        GLuint available = GL_FALSE;
+        functions.get_query_uiv(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint64 elapsed_ns = 0;
+        functions.get_query_ui64v(query, GL_QUERY_RESULT_EXT, &elapsed_ns);
+        if (!disjoint) {
+            m_gpu_latest = static_cast<float>(elapsed_ns) / 1000.0f;
+        }
+        m_gpu_collected++;
+    }
+}
+
+static AudioStageTimer::PhaseStats phase_stats(std::vector<float> & values) {
+    AudioStageTimer::PhaseStats stats;
+    if (values.empty()) {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (const float value : values) {
+        sum += value;
+    }
+
+    stats.min = values.front();
+    stats.mean = static_cast<float>(sum / values.size());
+    stats.p99 = values[std::min(values.size() - 1, (values.size() * 99) / 100)];
+    return stats;
+}
+
+AudioStageTimer::Stats AudioStageTimer::get_stats() const {
+    Stats stats;
+    const std::size_t write_index = m_write_index.load(std::memory_order_acquire);
+    const std::size_t num_samples = std::min(write_index, RING_SIZE);
+    stats.num_samples = static_cast<unsigned int>(num_samples);
+
+    std::vector<float> values(num_samples);
+    std::vector<float> totals(num_samples, 0.0f);
+    for (std::size_t phase = 0; phase < NUM_PHASES; phase++) {
+        for (std::size_t i = 0; i < num_samples; i++) {
+            values[i] = m_samples[(write_index - 1 - i) % RING_SIZE][phase].load(std::memory_order_relaxed);
+            if (phase != static_cast<std::size_t>(Phase::GPU)) {
+                totals[i] += values[i];
+            }
+        }
+        stats.phases[phase] = phase_stats(values);
+    }
+    stats.cpu_total = phase_stats(totals);
+    return stats;
+}
+
+#endif // AUDIO_STAGE_TIMING
@@ -0,0 +1,268 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+#include "utilities/audio_tracer.h"
+
+std::atomic<bool> AudioTracer::s_enabled{false};
+std::atomic<unsigned int> AudioTracer::s_block{0};
+
+namespace {
+
+constexpr size_t MAX_NAME_LENGTH = 64;
+constexpr size_t EVENTS_PER_THREAD = 16384;
+constexpr auto WRITE_PERIOD = std::chrono::milliseconds(50);
+
+struct TraceEvent {
+    char name[MAX_NAME_LENGTH];
+    const char * category;
+    int64_t start_ns;
+    int64_t duration_ns;
+    unsigned int block;
+    char phase;
+};
+
+// Single-producer/single-consumer ring: the traced thread writes, the writer thread reads
+struct ThreadBuffer {
+    unsigned int tid = 0;
+    std::string thread_name;
+    std::vector<TraceEvent> events = std::vector<TraceEvent>(EVENTS_PER_THREAD);
+    std::atomic<size_t> write_index{0};
+    std::atomic<size_t> read_index{0};
+};
+
+// Buffers outlive their threads so late events are still written
+std::mutex s_buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+unsigned int s_next_tid = 1;
+
+std::atomic<unsigned int> s_dropped{0};
+std::atomic<int64_t> s_origin_ns{0};
+
+// Writer state; the file is only written by whoever holds s_writer_mutex
+std::mutex s_control_mutex;
+std::mutex s_writer_mutex;
+std::condition_variable s_writer_wakeup;
+std::thread s_writer_thread;
+std::ofstream s_trace_file;
+bool s_writer_running = false;
+bool s_first_event = true;
+
+int64_t to_ns(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+ThreadBuffer & thread_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto created = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(s_buffers_mutex);
+        created->tid = s_next_tid++;
+        s_buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void record(const char * name, const char * category, int64_t start_ns, int64_t duration_ns,
+            unsigned int block, char phase) {
+    ThreadBuffer & buffer = thread_buffer();
+    const size_t write_index = buffer.write_index.load(std::memory_order_relaxed);
+    if (write_index - buffer.read_index.load(std::memory_order_acquire) >= buffer.events.size()) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent & event = buffer.events[write_index % buffer.events.size()];
+    std::strncpy(event.name, name, MAX_NAME_LENGTH - 1);
+    event.name[MAX_NAME_LENGTH - 1] = '\0';
+    event.category = category;
+    event.start_ns = start_ns - s_origin_ns.load(std::memory_order_relaxed);
+    event.duration_ns = duration_ns;
+    event.block = block;
+    event.phase = phase;
+    buffer.write_index.store(write_index + 1, std::memory_order_release);
+}
+
+void write_json_string(std::ostream & out, const std::string & value) {
+    out << '"';
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void begin_event(std::ostream & out) {
+    out << (s_first_event ? "\n" : ",\n");
+    s_first_event = false;
+}
+
+// Microseconds with nanosecond precision, the unit of the trace format
+void write_us(std::ostream & out, int64_t ns) {
+    char value[32];
+    std::snprintf(value, sizeof(value), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    out << value;
+}
+
+void write_event(std::ostream & out, const ThreadBuffer & buffer, const TraceEvent & event) {
+    begin_event(out);
+    out << "{\"name\":";
+    write_json_string(out, event.name);
+    out << ",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase << "\",\"ts\":";
+    write_us(out, event.start_ns);
+    if (event.phase == 'X') {
+        out << ",\"dur\":";
+        write_us(out, event.duration_ns);
+    } else {
+        out << ",\"s\":\"t\"";
+    }
+    out << ",\"pid\":1,\"tid\":" << buffer.tid << ",\"args\":{\"block\":" << event.block << "}}";
+}
+
+// Writes every event recorded so far. Needs s_writer_mutex.
+void drain_buffers() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(s_buffers_mutex);
+        buffers = s_buffers;
+    }
+
+    for (auto & buffer : buffers) {
+        size_t read_index = buffer->read_index.load(std::memory_order_relaxed);
+        const size_t write_index = buffer->write_index.load(std::memory_order_acquire);
+        while (read_index != write_index) {
+            write_event(s_trace_file, *buffer, buffer->events[read_index % buffer->events.size()]);
+            buffer->read_index.store(++read_index, std::memory_order_release);
+        }
+    }
+    s_trace_file.flush();
+}
+
+void writer_main() {
+    std::unique_lock<std::mutex> lock(s_writer_mutex);
+    while (s_writer_running) {
+        s_writer_wakeup.wait_for(lock, WRITE_PERIOD);
+        drain_buffers();
+    }
+}
+
+} // namespace
+
+bool AudioTracer::start(const std::string & path) {
+    std::lock_guard<std::mutex> control_lock(s_control_mutex);
+    if (is_enabled()) {
+        std::cerr << "Error: Tracing already started." << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_writer_mutex);
+        s_trace_file.open(path, std::ios::trunc);
+        if (!s_trace_file) {
+            std::cerr << "Error: Failed to open trace file " << path << std::endl;
+            return false;
+        }
+        s_trace_file << "{\"traceEvents\":[";
+        s_first_event = true;
+
+        // Forget events left over from a previous trace
+        std::lock_guard<std::mutex> buffers_lock(s_buffers_mutex);
+        for (auto & buffer : s_buffers) {
+            buffer->read_index.store(buffer->write_index.load(std::memory_order_acquire), std::memory_order_release);
+        }
+        s_writer_running = true;
+    }
+
+    s_dropped = 0;
+    s_origin_ns = to_ns(std::chrono::steady_clock::now());
+    s_writer_thread = std::thread(writer_main);
+    s_enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+bool AudioTracer::start_from_environment() {
+    const char * path = std::getenv("SHADER_DSP_TRACE");
+    if (path == nullptr || path[0] == '\0') {
+        return false;
+    }
+    return start(path);
+}
+
+void AudioTracer::stop() {
+    std::lock_guard<std::mutex> control_lock(s_control_mutex);
+    if (!is_enabled()) {
+        return;
+    }
+    s_enabled.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(s_writer_mutex);
+        s_writer_running = false;
+    }
+    s_writer_wakeup.notify_all();
+    s_writer_thread.join();
+
+    std::lock_guard<std::mutex> lock(s_writer_mutex);
+    drain_buffers();
+
+    // Thread names are metadata events, valid anywhere in the trace
+    {
+        std::lock_guard<std::mutex> buffers_lock(s_buffers_mutex);
+        for (auto & buffer : s_buffers) {
+            if (buffer->thread_name.empty()) {
+                continue;
+            }
+            begin_event(s_trace_file);
+            s_trace_file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            write_json_string(s_trace_file, buffer->thread_name);
+            s_trace_file << "}}";
+        }
+    }
+
+    s_trace_file << "\n]}\n";
+    s_trace_file.close();
+
+    if (s_dropped > 0) {
+        std::cerr << "Warning: " << s_dropped << " trace events were dropped." << std::endl;
+    }
+}
+
+void AudioTracer::set_thread_name(const std::string & name) {
+    ThreadBuffer & buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(s_buffers_mutex);
+    buffer.thread_name = name;
+}
+
+void AudioTracer::complete(const char * name, const char * category,
+                           std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    if (!is_enabled()) {
+        return;
+    }
+    record(name, category, to_ns(start), to_ns(end) - to_ns(start), s_block.load(std::memory_order_relaxed), 'X');
+}
+
+void AudioTracer::instant(const std::string & name, const char * category) {
+    if (!is_enabled()) {
+        return;
+    }
+    record(name.c_str(), category, to_ns(std::chrono::steady_clock::now()), 0, s_block.load(std::memory_order_relaxed), 'i');
+}
+
+unsigned int AudioTracer::get_dropped_count() {
+    return s_dropped.load();
+}
@@ -15,6 +15,9 @@ static bool s_deviceDisplayActive = false; // true if we are currently using a p
 std::unordered_map<SDL_Window*, EGLSurface> EGLCompatibility::s_surfaces;
 std::unordered_map<SDL_Window*, EGLContext> EGLCompatibility::s_contexts;
 std::unordered_map<SDL_Window*, int> EGLCompatibility::s_surfaceIntervals;
+EGLDisplay EGLCompatibility::s_headlessDisplay = EGL_NO_DISPLAY;
+std::unordered_map<EGLContext, EGLSurface> EGLCompatibility::s_headlessSurfaces;
+std::mutex EGLCompatibility::s_headlessMutex;
 
 // Helper to check for extension support in a space separated list
 static bool contains_extension(const char* ext_list, const char* ext) {
@@ -141,6 +144,163 @@ void EGLCompatibility::cleanup_egl_context(SDL_Window* window) {
     }
 }
 
+bool EGLCompatibility::initialize_headless_display() {
+    if (!eglBindAPI(EGL_OPENGL_ES_API)) {
+        std::cerr << "EGL: Failed to bind OpenGL ES API, falling back to default" << std::endl;
+    }
+
+    // A GPU device display needs no window system
+    EGLDisplay display = choose_hardware_display();
+    const char * platform = "device";
+
+    // Mesa (including llvmpipe) can render without any window system on the surfaceless platform
+#ifdef EGL_MESA_platform_surfaceless
+    if (display == EGL_NO_DISPLAY) {
+        const char * client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto eglGetPlatformDisplayEXT = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (eglGetPlatformDisplayEXT && contains_extension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+            display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            platform = "surfaceless";
+        }
+    }
+#endif
+
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        platform = "default";
+    }
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        std::cerr << "EGL: Failed to initialize headless display" << std::endl;
+        return false;
+    }
+
+    s_headlessDisplay = display;
+    std::cout << "EGL: Using " << platform << " display for headless contexts" << std::endl;
+    return true;
+}
+
+bool EGLCompatibility::initialize_headless_context(EGLContext& out_context) {
+    out_context = EGL_NO_CONTEXT;
+
+    std::lock_guard<std::mutex> lock(s_headlessMutex);
+
+    // The pbuffer config is chosen separately from the window config, and the
+    // display may not be the windowed one, so no window system is needed.
+    if (s_headlessDisplay == EGL_NO_DISPLAY) {
+        if (!initialize_headless_display()) {
+            return false;
+        }
+    }
+
+    const bool surfaceless = contains_extension(eglQueryString(s_headlessDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+    const struct VersionTry {
+        EGLint renderable_bit;
+        int     client_version;
+    } tries[] = {
+        {EGL_OPENGL_ES3_BIT, 3},
+        {EGL_OPENGL_ES2_BIT, 2},
+    };
+
+    for (const auto & t : tries) {
+        // Audio stages render into their own framebuffers, so a pbuffer is only
+        // needed for eglMakeCurrent when surfaceless contexts are not supported.
+        // Prefer the pbuffer anyway, so the default framebuffer stays complete.
+        const EGLint pbufferConfigAttribs[] = {
+            EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, t.renderable_bit,
+            EGL_NONE
+        };
+        const EGLint surfacelessConfigAttribs[] = {
+            EGL_RENDERABLE_TYPE, t.renderable_bit,
+            EGL_NONE
+        };
+
+        EGLConfig config = nullptr;
+        EGLint numConfigs = 0;
+        bool use_pbuffer = true;
+        if (!eglChooseConfig(s_headlessDisplay, pbufferConfigAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+            if (!surfaceless ||
+                !eglChooseConfig(s_headlessDisplay, surfacelessConfigAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+                continue;
+            }
+            use_pbuffer = false;
+        }
+
+        EGLSurface surface = EGL_NO_SURFACE;
+        if (use_pbuffer) {
+            const EGLint pbufferAttribs[] = {
+                EGL_WIDTH,  1,
+                EGL_HEIGHT, 1,
+                EGL_NONE
+            };
+            surface = eglCreatePbufferSurface(s_headlessDisplay, config, pbufferAttribs);
+            if (surface == EGL_NO_SURFACE) {
+                std::cerr << "EGL: Failed to create pbuffer surface (error: 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+                continue;
+            }
+        }
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_CLIENT_VERSION, t.client_version,
+            EGL_NONE
+        };
+        EGLContext context = eglCreateContext(s_headlessDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+        if (context == EGL_NO_CONTEXT) {
+            if (surface != EGL_NO_SURFACE) {
+                eglDestroySurface(s_headlessDisplay, surface);
+            }
+            continue;
+        }
+
+        if (!eglMakeCurrent(s_headlessDisplay, surface, surface, context)) {
+            std::cerr << "EGL: Failed to make headless context current" << std::endl;
+            eglDestroyContext(s_headlessDisplay, context);
+            if (surface != EGL_NO_SURFACE) {
+                eglDestroySurface(s_headlessDisplay, surface);
+            }
+            return false;
+        }
+
+        s_headlessSurfaces[context] = surface;
+        out_context = context;
+
+        std::cout << "EGL: Headless OpenGL ES " << t.client_version << " context initialized successfully ("
+                  << (use_pbuffer ? "pbuffer" : "surfaceless") << ")" << std::endl;
+        return true;
+    }
+
+    std::cerr << "EGL: Failed to find a pbuffer or surfaceless capable ES2/ES3 config" << std::endl;
+    return false;
+}
+
+void EGLCompatibility::cleanup_headless_context(EGLContext context) {
+    std::lock_guard<std::mutex> lock(s_headlessMutex);
+    if (context == EGL_NO_CONTEXT || s_headlessDisplay == EGL_NO_DISPLAY) return;
+
+    if (eglGetCurrentContext() == context) {
+        eglMakeCurrent(s_headlessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    if (auto it = s_headlessSurfaces.find(context); it != s_headlessSurfaces.end()) {
+        if (it->second != EGL_NO_SURFACE) {
+            eglDestroySurface(s_headlessDisplay, it->second);
+        }
+        s_headlessSurfaces.erase(it);
+    }
+    eglDestroyContext(s_headlessDisplay, context);
+}
+
+void EGLCompatibility::make_headless_current(EGLContext context) {
+    std::lock_guard<std::mutex> lock(s_headlessMutex);
+    if (s_headlessDisplay == EGL_NO_DISPLAY) return;
+    auto it = s_headlessSurfaces.find(context);
+    if (it != s_headlessSurfaces.end()) {
+        eglMakeCurrent(s_headlessDisplay, it->second, it->second, context);
+    }
+}
+
 void EGLCompatibility::global_cleanup() {
     // Destroy any remaining surfaces
     for (auto& pair : s_surfaces) {
@@ -148,6 +308,24 @@ void EGLCompatibility::global_cleanup() {
     }
     s_surfaces.clear();
 
+    // Destroy any remaining headless contexts and their pbuffers
+    {
+        std::lock_guard<std::mutex> lock(s_headlessMutex);
+        for (auto& pair : s_headlessSurfaces) {
+            if (pair.second != EGL_NO_SURFACE) {
+                eglDestroySurface(s_headlessDisplay, pair.second);
+            }
+            eglDestroyContext(s_headlessDisplay, pair.first);
+        }
+        s_headlessSurfaces.clear();
+
+        // The headless display may be the same as the windowed one
+        if (s_headlessDisplay != EGL_NO_DISPLAY && s_headlessDisplay != s_eglDisplay) {
+            eglTerminate(s_headlessDisplay);
+        }
+        s_headlessDisplay = EGL_NO_DISPLAY;
+    }
+
     // Destroy any remaining contexts
     for (auto& pair : s_contexts) {
         eglDestroyContext(s_eglDisplay, pair.second);
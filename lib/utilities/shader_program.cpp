@@ -1,48 +1,264 @@
 #include <iostream>
+#include <cstdio>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <filesystem>
 
 #include "utilities/shader_program.h"
 
-AudioShaderProgram::AudioShaderProgram(const std::string& vertex_shader_source, const std::string& fragment_shader_source)
-    : m_vertex_shader_source(vertex_shader_source), m_fragment_shader_source(fragment_shader_source),
-      m_vertex_shader(0), m_fragment_shader(0), m_shader_program(0) {}
+// Linked programs per EGL context, keyed by their combined sources
+std::unordered_map<void*, std::unordered_map<std::string, std::weak_ptr<AudioShaderProgram::LinkedProgram>>>
+    AudioShaderProgram::s_program_cache;
+static std::mutex s_program_cache_mutex;
 
-AudioShaderProgram::~AudioShaderProgram() {
-    if (m_shader_program) {
-        glDeleteProgram(m_shader_program);
+static std::string s_binary_cache_directory;
+static std::atomic<unsigned int> s_compile_count{0};
+static std::atomic<unsigned int> s_binary_load_count{0};
+
+// 64-bit FNV-1a, stable across runs so it can name cache files
+static uint64_t fnv1a_64(const std::string& data, uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (const unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
     }
-    if (m_vertex_shader) {
-        glDeleteShader(m_vertex_shader);
+    return hash;
+}
+
+static std::string combined_source(const std::string& vertex_source, const std::string& fragment_source) {
+    return vertex_source + '\0' + fragment_source;
+}
+
+AudioShaderProgram::LinkedProgram::~LinkedProgram() {
+    if (program) {
+        glDeleteProgram(program);
     }
-    if (m_fragment_shader) {
-        glDeleteShader(m_fragment_shader);
+}
+
+AudioShaderProgram::AudioShaderProgram(const std::string& vertex_shader_source, const std::string& fragment_shader_source)
+    : m_vertex_shader_source(vertex_shader_source), m_fragment_shader_source(fragment_shader_source) {}
+
+AudioShaderProgram::~AudioShaderProgram() {
+    std::lock_guard<std::mutex> lock(s_program_cache_mutex);
+    if (m_linked && m_linked->state_owner == this) {
+        m_linked->state_owner = nullptr;
     }
+    m_linked.reset();
 }
 
 bool AudioShaderProgram::initialize() {
-    m_vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    m_fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+    const std::string key = combined_source(m_vertex_shader_source, m_fragment_shader_source);
+    void * context = static_cast<void*>(eglGetCurrentContext());
 
-    if (!compile_shader(m_vertex_shader, m_vertex_shader_source)) {
-        return false;
+    std::lock_guard<std::mutex> lock(s_program_cache_mutex);
+    m_linked.reset();
+
+    // Share the program another instance already linked from the same sources
+    auto & cache = s_program_cache[context];
+    if (auto it = cache.find(key); it != cache.end()) {
+        if (auto shared = it->second.lock()) {
+            m_linked = shared;
+            return true;
+        }
+        cache.erase(it);
     }
 
-    if (!compile_shader(m_fragment_shader, m_fragment_shader_source)) {
+    auto linked = std::make_shared<LinkedProgram>();
+    if (!build_program(*linked)) {
         return false;
     }
 
-    m_shader_program = glCreateProgram();
-    glAttachShader(m_shader_program, m_vertex_shader);
-    glAttachShader(m_shader_program, m_fragment_shader);
+    m_linked = linked;
+    cache[key] = linked;
+    return true;
+}
+
+bool AudioShaderProgram::build_program(LinkedProgram& linked) {
+    linked.program = glCreateProgram();
+
+    const std::string path = binary_cache_path();
+    if (!path.empty() && load_program_binary(linked.program, path)) {
+        s_binary_load_count++;
+        return true;
+    }
+
+    GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+    GLuint fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+
+    bool success = compile_shader(vertex_shader, m_vertex_shader_source) &&
+                   compile_shader(fragment_shader, m_fragment_shader_source);
 
-    return link_program();
+    if (success) {
+        glAttachShader(linked.program, vertex_shader);
+        glAttachShader(linked.program, fragment_shader);
+        if (!path.empty()) {
+            glProgramParameteri(linked.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        success = link_program(linked.program);
+        glDetachShader(linked.program, vertex_shader);
+        glDetachShader(linked.program, fragment_shader);
+    }
+
+    // The linked program does not need the shader objects anymore
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    if (!success) {
+        return false;
+    }
+    s_compile_count++;
+
+    if (!path.empty()) {
+        save_program_binary(linked.program, path);
+    }
+    return true;
 }
 
 GLuint AudioShaderProgram::get_program() const {
-    return m_shader_program;
+    return m_linked ? m_linked->program : 0;
 }
 
 void AudioShaderProgram::use_program() const {
-    glUseProgram(m_shader_program);
+    glUseProgram(get_program());
+}
+
+GLint AudioShaderProgram::get_uniform_location(const std::string& name) {
+    if (!m_linked) {
+        return -1;
+    }
+
+    auto & locations = m_linked->uniform_locations;
+    auto it = locations.find(name);
+    if (it != locations.end()) {
+        return it->second;
+    }
+
+    GLint location = glGetUniformLocation(m_linked->program, name.c_str());
+    locations[name] = location;
+    return location;
+}
+
+bool AudioShaderProgram::claim_program_state() {
+    if (!m_linked || m_linked->state_owner == this) {
+        return false;
+    }
+    const bool taken = m_linked->state_owner != nullptr;
+    m_linked->state_owner = this;
+    return taken;
+}
+
+void AudioShaderProgram::set_binary_cache_directory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(s_program_cache_mutex);
+    s_binary_cache_directory.clear();
+    if (directory.empty()) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Warning: Cannot create program cache directory " << directory << ": " << error.message() << std::endl;
+        return;
+    }
+    s_binary_cache_directory = directory;
+}
+
+const std::string& AudioShaderProgram::get_binary_cache_directory() {
+    return s_binary_cache_directory;
+}
+
+unsigned int AudioShaderProgram::get_compile_count() {
+    return s_compile_count.load();
+}
+
+unsigned int AudioShaderProgram::get_binary_load_count() {
+    return s_binary_load_count.load();
+}
+
+std::string AudioShaderProgram::binary_cache_path() const {
+    if (s_binary_cache_directory.empty()) {
+        return "";
+    }
+
+    // Binaries are only valid for the driver that produced them
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    if (num_formats <= 0) {
+        return "";
+    }
+
+    auto gl_string = [](GLenum name) {
+        const char * value = reinterpret_cast<const char*>(glGetString(name));
+        return std::string(value ? value : "");
+    };
+    const std::string driver = gl_string(GL_VENDOR) + '\0' + gl_string(GL_RENDERER) + '\0' + gl_string(GL_VERSION);
+
+    const uint64_t hash = fnv1a_64(driver, fnv1a_64(combined_source(m_vertex_shader_source, m_fragment_shader_source)));
+
+    std::ostringstream path;
+    path << s_binary_cache_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return path.str();
+}
+
+bool AudioShaderProgram::load_program_binary(GLuint program, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    GLenum format = 0;
+    if (!file.read(reinterpret_cast<char*>(&format), sizeof(format))) {
+        return false;
+    }
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty()) {
+        return false;
+    }
+
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // The driver may reject a binary, e.g. after an update; fall back to compiling from source
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        std::cerr << "Warning: Program binary " << path << " rejected, compiling from source." << std::endl;
+        while (glGetError() != GL_NO_ERROR) {}
+        return false;
+    }
+    return true;
+}
+
+void AudioShaderProgram::save_program_binary(GLuint program, const std::string& path) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+    if (glGetError() != GL_NO_ERROR) {
+        std::cerr << "Warning: Failed to retrieve program binary." << std::endl;
+        return;
+    }
+
+    // Write to a temporary file first so a concurrent reader never sees a partial binary
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Warning: Failed to write program binary " << path << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        file.write(binary.data(), binary.size());
+    }
+    std::rename(temp_path.c_str(), path.c_str());
 }
 
 bool AudioShaderProgram::compile_shader(GLuint shader, const std::string& source) {
@@ -62,16 +278,16 @@ bool AudioShaderProgram::compile_shader(GLuint shader, const std::string& source
     return true;
 }
 
-bool AudioShaderProgram::link_program() {
-    glLinkProgram(m_shader_program);
+bool AudioShaderProgram::link_program(GLuint program) {
+    glLinkProgram(program);
 
     GLint success;
-    glGetProgramiv(m_shader_program, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         GLchar info_log[512];
-        glGetProgramInfoLog(m_shader_program, 512, NULL, info_log);
+        glGetProgramInfoLog(program, 512, NULL, info_log);
         std::cerr << "Error linking shader program: " << info_log << std::endl;
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
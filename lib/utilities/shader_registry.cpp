@@ -0,0 +1,116 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <atomic>
+#include <string_view>
+#include <unordered_map>
+
+#include "utilities/shader_registry.h"
+
+static std::atomic<unsigned int> s_disk_read_count{0};
+
+// Build settings seen by every shader
+static const std::string BUILD_DEFINES = "#define AUDIO_DEBUG_OUTPUTS " + std::to_string(AUDIO_DEBUG_OUTPUTS) + "\n";
+
+// Memoized import prefixes, keyed by their import lists
+static std::unordered_map<std::string, std::pair<std::string, bool>> s_import_prefixes;
+static std::mutex s_import_prefixes_mutex;
+
+static const std::unordered_map<std::string_view, std::string_view>& embedded_shaders() {
+    static const std::unordered_map<std::string_view, std::string_view> shaders = []() {
+        std::unordered_map<std::string_view, std::string_view> table;
+        for (std::size_t i = 0; i < SHADER_REGISTRY_ENTRY_COUNT; i++) {
+            table.emplace(SHADER_REGISTRY_ENTRIES[i].path, SHADER_REGISTRY_ENTRIES[i].source);
+        }
+        return table;
+    }();
+    return shaders;
+}
+
+std::string ShaderRegistry::get_source(const std::string & path) {
+    const auto & shaders = embedded_shaders();
+    if (auto it = shaders.find(path); it != shaders.end()) {
+        return std::string(it->second);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Failed to open file " << path << std::endl;
+        return "";
+    }
+    s_disk_read_count++;
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+bool ShaderRegistry::is_embedded(const std::string & path) {
+    return embedded_shaders().count(path) > 0;
+}
+
+std::string ShaderRegistry::combine_imports(const std::vector<std::string> & import_paths, bool & version_added) {
+    // Files on disk may change between stages, so only prefixes made of bundled shaders are kept
+    bool memoizable = true;
+    std::string key;
+    for (const auto & import_path : import_paths) {
+        memoizable = memoizable && is_embedded(import_path);
+        key += import_path;
+        key += '\n';
+    }
+
+    if (memoizable) {
+        std::lock_guard<std::mutex> lock(s_import_prefixes_mutex);
+        if (auto it = s_import_prefixes.find(key); it != s_import_prefixes.end()) {
+            version_added = it->second.second;
+            return it->second.first;
+        }
+    }
+
+    std::string combined_source = "";
+    version_added = false;
+    for (const auto & import_path : import_paths) {
+        append_source(combined_source, version_added, get_source(import_path));
+        combined_source += "\n";
+    }
+
+    if (memoizable) {
+        std::lock_guard<std::mutex> lock(s_import_prefixes_mutex);
+        s_import_prefixes.emplace(key, std::make_pair(combined_source, version_added));
+    }
+    return combined_source;
+}
+
+void ShaderRegistry::append_source(std::string & combined_source, bool & version_added, const std::string & source) {
+    const size_t version_pos = source.find("#version");
+    if (version_pos == std::string::npos) {
+        combined_source += source;
+        return;
+    }
+
+    if (!version_added) {
+        // Keep the first #version directive, which must come before the defines
+        const size_t newline_pos = source.find('\n', version_pos);
+        if (newline_pos == std::string::npos) {
+            combined_source += source + "\n" + BUILD_DEFINES;
+        } else {
+            combined_source += source.substr(0, newline_pos + 1) + BUILD_DEFINES + source.substr(newline_pos + 1);
+        }
+        version_added = true;
+        return;
+    }
+
+    // Remove the #version line from every later source
+    const size_t newline_pos = source.find('\n', version_pos);
+    if (newline_pos != std::string::npos) {
+        combined_source += source.substr(newline_pos + 1);
+    } else {
+        combined_source += source;
+    }
+}
+
+std::size_t ShaderRegistry::get_embedded_count() {
+    return embedded_shaders().size();
+}
+
+unsigned int ShaderRegistry::get_disk_read_count() {
+    return s_disk_read_count.load();
+}
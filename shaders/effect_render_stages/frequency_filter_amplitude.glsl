@@ -0,0 +1,11 @@
+// Mean absolute value of the stream block over every channel, rendered into a single texel
+// once per block, so the frequency filter can follow it without reading the block back
+void main() {
+    float sum = 0.0;
+    for (int channel = 0; channel < num_channels; channel++) {
+        for (int i = 0; i < buffer_size; i++) {
+            sum += abs(texelFetch(stream_audio_texture, ivec2(i, channel), 0).r);
+        }
+    }
+    output_audio_texture = vec4(sum / float(buffer_size * num_channels));
+}
@@ -1,12 +1,21 @@
 uniform int num_taps;
 
+// Bank of designs, one per row, for block amplitudes evenly spaced from 0 to 1.
+// Only the first coeff_bank_rows rows are set, a single row when the filter does not follow.
 uniform sampler2D b_coeff_texture;
+uniform int coeff_bank_rows;
 
-// Treat the coefficient textures as an array by mapping tex coords
-float get_tex_value(sampler2D tex, int index) {
-    ivec2 index_real = ivec2(index % buffer_size, index / buffer_size);
-    ivec2 texture_size = textureSize(tex, 0);
-    return texture(tex, (vec2(index_real) + 0.5) / vec2(texture_size)).r;
+// Mean absolute value of the block over every channel, rendered once per block while the filter follows it
+uniform sampler2D block_amplitude_texture;
+
+// With FFT convolution the block is filtered on the CPU and only passed through
+uniform int fft_convolution;
+uniform sampler2D convolved_audio_texture;
+
+// Coefficient of a tap in one design of the bank
+float get_coeff(int tap, int row) {
+    ivec2 texture_size = textureSize(b_coeff_texture, 0);
+    return texture(b_coeff_texture, (vec2(tap, row) + 0.5) / vec2(texture_size)).r;
 }
 
 // function for joining the history and the current audio stream into one index to pull from
@@ -28,16 +37,35 @@ float get_data(int index) {
 }
 
 void main() {
+    if (fft_convolution != 0) {
+        output_audio_texture = vec4(texture(convolved_audio_texture, TexCoord).r, 0.0, 0.0, 0.0);
+        debug_audio_texture = texture(stream_audio_texture, TexCoord);
+        return;
+    }
+
     // Map the horizontal coordinate to an output index.
     int outputIndex = int(TexCoord.x * float(buffer_size));
 
     float y = 0.0;
     int history_size = num_taps - 1;
 
+    // Pick the two designs around the amplitude of the block and the weight between them
+    int bank_row = 0;
+    float bank_weight = 0.0;
+    if (coeff_bank_rows > 1) {
+        float block_amplitude = texelFetch(block_amplitude_texture, ivec2(0, 0), 0).r;
+        float bank_position = clamp(block_amplitude, 0.0, 1.0) * float(coeff_bank_rows - 1);
+        bank_row = min(int(bank_position), coeff_bank_rows - 2);
+        bank_weight = bank_position - float(bank_row);
+    }
+
     // Loop over the FIR taps. Note: many GLSL compilers require the loop bound to be constant.
     for (int i = 0; i < num_taps; i++) {
-        // Retrieve the FIR coefficient from the b_coeff_texture.
-        float b_val = get_tex_value(b_coeff_texture, i);
+        // Retrieve the FIR coefficient from the b_coeff_texture, between the designs around the amplitude.
+        float b_val = get_coeff(i, bank_row);
+        if (bank_weight > 0.0) {
+            b_val = mix(b_val, get_coeff(i, bank_row + 1), bank_weight);
+        }
         // Get the corresponding sample from the extended input:
         // We want sample at current_index - tap_index (convolution)
         // In our get_data coordinate system:
@@ -2,9 +2,8 @@ uniform float gains[8]; // Array of gains, one per channel (max 8 channels)
 
 void main() {
     // Calculate which channel we're in based on Y coordinate
-    // Each channel occupies 1/num_channels of the texture height
-    float channel_height = 1.0 / float(num_channels);
-    int channel_index = int(TexCoord.y / channel_height);
+    // Each block occupies num_channels rows of the texture height
+    int channel_index = audio_channel();
     
     // Clamp channel index to valid range
     channel_index = clamp(channel_index, 0, num_channels - 1);
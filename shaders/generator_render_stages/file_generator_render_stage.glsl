@@ -9,7 +9,7 @@ void main() {
 
     float start_time = calculateTime(play_position, vec2(0.0, 0.0));
     float end_time = calculateTime(stop_position, vec2(0.0, 0.0));
-    float time = calculateTime(global_time_val, TexCoord);
+    float time = calculateTime(block_time(), TexCoord);
 
     // Calculate speed in samples per buffer from tone
     float speed_ratio = tone / MIDDLE_C;
@@ -22,7 +22,7 @@ void main() {
     }
     
     // Calculate tape position based on play position and speed
-    int tape_position_samples = calculate_tape_position(global_time_val, play_position, speed_in_samples_per_buffer);
+    int tape_position_samples = calculate_tape_position(block_time(), play_position, speed_in_samples_per_buffer);
 
     // Get the tape sample using get_tape_history_samples
     vec4 tape_sample = vec4(0.0, 0.0, 0.0, 0.0);
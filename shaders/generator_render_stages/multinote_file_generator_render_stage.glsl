@@ -12,14 +12,14 @@ void main() {
     for (int i = 0; i < active_notes; i++) {
         float start_time = calculateTime(play_positions[i], vec2(0.0, 0.0));
         float end_time = calculateTime(stop_positions[i], vec2(0.0, 0.0));
-        float time = calculateTime(global_time_val, TexCoord);
+        float time = calculateTime(block_time(), TexCoord);
 
         // Calculate speed in samples per buffer from tone
         float speed_ratio = tones[i] / MIDDLE_C;
         int speed_in_samples_per_buffer = int(float(buffer_size) * speed_ratio);
         
         // Calculate tape position based on play position and speed
-        int tape_position_samples = calculate_tape_position(global_time_val, play_positions[i], speed_in_samples_per_buffer);
+        int tape_position_samples = calculate_tape_position(block_time(), play_positions[i], speed_in_samples_per_buffer);
 
         // Get the tape sample using get_tape_history_samples
         vec4 tape_sample = vec4(0.0, 0.0, 0.0, 0.0);
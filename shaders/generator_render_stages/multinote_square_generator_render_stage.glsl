@@ -1,5 +1,5 @@
 float generateSquare(float tone) {
-    float phase = calculatePhase(global_time_val, TexCoord, tone);
+    float phase = calculatePhase(block_time(), TexCoord, tone);
 
     return sign(sin(TWO_PI * tone * phase));
 }
@@ -10,7 +10,7 @@ void main() {
     for (int i = 0; i < active_notes; i++) {
         float start_time = calculateTimeSimple(play_positions[i]);
         float end_time = calculateTimeSimple(stop_positions[i]);
-        float time = calculateTime(global_time_val, TexCoord);
+        float time = calculateTime(block_time(), TexCoord);
         float square_out = generateSquare(tones[i]) * adsr_envelope(start_time, end_time, time);
 
         output_audio_texture += vec4(square_out * gains[i], 0.0, 0.0, 0.0);
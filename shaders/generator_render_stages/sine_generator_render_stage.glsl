@@ -1,5 +1,5 @@
 float generateSine(float tone) {
-    float phase = calculatePhase(global_time_val, TexCoord, tone);
+    float phase = calculatePhase(block_time(), TexCoord, tone);
 
     return sin(TWO_PI * tone * phase);
 }
@@ -7,7 +7,7 @@ float generateSine(float tone) {
 void main() {
     float start_time = calculateTime(play_position, vec2(0.0, 0.0));
     float end_time = calculateTime(stop_position, vec2(0.0, 0.0));
-    float time = calculateTime(global_time_val, TexCoord);
+    float time = calculateTime(block_time(), TexCoord);
     float sine_out = generateSine(tone) * adsr_envelope(start_time, end_time, time);
 
     output_audio_texture = texture(stream_audio_texture, TexCoord) + vec4(sine_out * gain, 0.0, 0.0, 0.0);
@@ -1,20 +1,26 @@
 layout(location = 2) out vec4 final_output_audio_texture;
 
+// Samples held by each texel of the outputs, PACKED_SAMPLES when the output is packed
+uniform int output_samples_per_texel;
+
 void main(){
     // Convert from interpolated coordinates to non-interpolated coordinates.
-    int x_int = int(TexCoord.x * float(buffer_size));
-    int y_int = int(TexCoord.y * float(num_channels));
+    // Each block of a batch is interleaved on its own num_channels rows.
+    int block = audio_block();
+    int y_int = audio_channel();
+
+    vec4 output_samples = vec4(0.0);
+    for (int lane = 0; lane < output_samples_per_texel; lane++) {
+        int position = y_int * buffer_size + audio_column(lane, output_samples_per_texel);
 
-    int position = y_int * buffer_size + x_int;
+        // Calculate the sample and channel from the position.
+        int channel = position % num_channels;
+        int smpl = position / num_channels;
 
-    // Calculate the sample and channel from the position.
-    int channel = position % num_channels;
-    int smpl = position / num_channels;
+        output_samples[lane] = fetch_audio_sample(stream_audio_texture, smpl, block * num_channels + channel);
+    }
 
-    vec2 inTexCoord = vec2(float(smpl) / float(buffer_size), float(channel) / float(num_channels));
-    
-    // Finally, sample the input texture at the rotated coordinate.
-    output_audio_texture = texture(stream_audio_texture, inTexCoord);
-    final_output_audio_texture = texture(stream_audio_texture, inTexCoord);
-    debug_audio_texture = texture(stream_audio_texture, inTexCoord);
+    output_audio_texture = output_samples;
+    final_output_audio_texture = output_samples;
+    debug_audio_texture = output_samples;
 }
@@ -11,4 +11,53 @@ layout(std140) uniform global_time {
 };
 
 layout(location = 0) out vec4 output_audio_texture;
-layout(location = 1) out vec4 debug_audio_texture;
\ No newline at end of file
+#if AUDIO_DEBUG_OUTPUTS
+layout(location = 1) out vec4 debug_audio_texture;
+#else
+// Without the debug attachment the writes land in a global the compiler drops
+vec4 debug_audio_texture;
+#endif
+
+// Number of consecutive blocks rendered by one draw. The audio textures are
+// stacked along y as num_blocks groups of num_channels rows.
+uniform int num_blocks;
+
+// Row of the fragment in the stacked audio texture
+int audio_row() {
+    return int(TexCoord.y * float(num_channels * num_blocks));
+}
+
+// Block of the batch the fragment belongs to
+int audio_block() {
+    return audio_row() / num_channels;
+}
+
+// Channel of the fragment within its block
+int audio_channel() {
+    return audio_row() - audio_block() * num_channels;
+}
+
+// Global time (in blocks) of the block the fragment belongs to
+int block_time() {
+    return global_time_val + audio_block();
+}
+
+// Packed audio textures hold PACKED_SAMPLES consecutive samples of a row in
+// each RGBA texel, so a draw into them runs a quarter of the fragments.
+const int PACKED_SAMPLES = 4;
+
+// Column of the samples of a row written by a lane of the texel at the fragment,
+// for an output holding samples_per_texel (1 or PACKED_SAMPLES) samples per texel
+int audio_column(int lane, int samples_per_texel) {
+    return int(TexCoord.x * float(buffer_size / samples_per_texel)) * samples_per_texel + lane;
+}
+
+// Sample at a column and row of an audio texture with one sample per texel
+float fetch_audio_sample(sampler2D audio_texture, int column, int row) {
+    return texelFetch(audio_texture, ivec2(column, row), 0).r;
+}
+
+// Sample at a column and row of a packed audio texture
+float fetch_packed_audio_sample(sampler2D audio_texture, int column, int row) {
+    return texelFetch(audio_texture, ivec2(column / PACKED_SAMPLES, row), 0)[column % PACKED_SAMPLES];
+}
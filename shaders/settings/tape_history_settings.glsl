@@ -4,6 +4,7 @@ uniform int speed_in_samples_per_buffer{PLUGIN_SUFFIX};
 uniform int tape_window_size_samples{PLUGIN_SUFFIX};
 uniform int tape_window_offset_samples{PLUGIN_SUFFIX};
 uniform int tape_stopped{PLUGIN_SUFFIX}; // 1 = stopped, 0 = playing
+uniform int tape_ring_write_position{PLUGIN_SUFFIX}; // End of the samples held in the history texture (exclusive)
 
 // Get the size of the audio history texture in samples per channel
 int get_tape_history_size{PLUGIN_SUFFIX}() {
@@ -11,6 +12,42 @@ int get_tape_history_size{PLUGIN_SUFFIX}() {
     return audio_size.x * audio_size.y / num_channels;
 }
 
+// Get the sample at a global tape index (in samples) for a given channel
+// The texture is a ring of tape_window_size_samples samples indexed modulo its size, so sliding
+// the window only needs the new samples. It holds the samples from tape_window_offset_samples
+// up to tape_ring_write_position.
+// Returns zeros if the index is not held in the texture
+vec4 get_tape_history_texel{PLUGIN_SUFFIX}(int index, int channel) {
+    int position_in_window = index - tape_window_offset_samples{PLUGIN_SUFFIX};
+    if (position_in_window < 0 || position_in_window >= tape_window_size_samples{PLUGIN_SUFFIX}) {
+        return vec4(0.0);
+    }
+    if (index >= tape_ring_write_position{PLUGIN_SUFFIX}) {
+        return vec4(0.0);
+    }
+    int ring_position = index % tape_window_size_samples{PLUGIN_SUFFIX};
+
+    // Get texture dimensions
+    ivec2 audio_size = textureSize(tape_history_texture{PLUGIN_SUFFIX}, 0);
+    int audio_width = audio_size.x;
+
+    // Calculate the x and y position in the texture
+    int x_position = ring_position % audio_width;
+    int y_row_position = ring_position / audio_width;
+
+    // Calculate y_position for the channel (multiply by 2 because of zeros, then add channel offset)
+    int y_position = (y_row_position * num_channels + channel) * 2;
+
+    // Convert the x y into texture coordinates
+    // We add 0.5001 to the position to sample the center of the texel.
+    // This is important because we use linear filtering to smooth out the pixels,
+    // and sampling at the edge would cause bleeding from neighboring pixels.
+    vec2 texture_coord = vec2((float(x_position) + 0.5001) / float(audio_size.x),
+                              (float(y_position) + 0.5001) / float(audio_size.y));
+
+    return texture(tape_history_texture{PLUGIN_SUFFIX}, texture_coord);
+}
+
 // Get the audio section corresponding to the tape section in the tape history from the tape position (in samples)
 // Returns the audio sample (vec4) from the tape_history_texture at the specified tape position
 // TexCoord: texture coordinates from the current shader (channel is encoded in TexCoord.y)
@@ -22,53 +59,19 @@ vec4 get_tape_history_samples{PLUGIN_SUFFIX}(vec2 TexCoord, int sample_frame_siz
         return vec4(0.0);
     }
     
-    // Get texture dimensions to calculate position bar
-    ivec2 audio_size = textureSize(tape_history_texture{PLUGIN_SUFFIX}, 0);
-
     // Get channel as int
     int channel = int(TexCoord.y * float(num_channels));
 
-    // Calculate the position of the current position in the audio output texture
+    // Calculate the global index of the sample for this fragment
     int window_offset = int(TexCoord.x * float(sample_frame_size));
-    // Special case: when tape_position = 0 and tape_window_offset_samples = 0, we need to add 1
-    // to compensate for the -1 in the formula, so that window_offset = 0 maps to position_in_window = 0
-    int position_in_window = tape_position_param - tape_window_offset_samples{PLUGIN_SUFFIX} + window_offset;
+    int index = tape_position_param + window_offset;
     if (sample_frame_size < 0) {
-        position_in_window -= 1;
+        index -= 1;
     }
 
-    // Calculate the position of the current position in the audio output texture
-    int audio_width = audio_size.x;
-    int audio_height = audio_size.y / num_channels / 2; // 2 because we need to store both the audio data and the zeros
-
-    // Return zeros for out-of-range positions
-    // This ensures that positions before the window start or after the window end return zeros
+    // Positions before the window start or after the window end return zeros
     // This matches the behavior of the tape's playback_for_render_stage_history method
-    if (position_in_window < 0) {
-        // Before window start - position is out of range, return zero
-        return vec4(0.0);
-    }
-    if (position_in_window >= tape_window_size_samples{PLUGIN_SUFFIX}) {
-        // After window end - position is out of range, return zero
-        return vec4(0.0);
-    }
-
-    // Calculate the x and y position of the current position in the audio output texture
-    int x_position = position_in_window % audio_width;
-    int y_row_position = position_in_window / audio_width;
-
-    // Calculate y_position for each channel and check if we're on the correct one
-    // Only highlight channel 0 to avoid duplicate lines
-    int y_position = ( y_row_position * num_channels + channel) * 2;
-
-    // Convert the x y into texture coordinates
-    // We add 0.5001 to the position to sample the center of the texel.
-    // This is important because we use linear filtering to smooth out the pixels,
-    // and sampling at the edge would cause bleeding from neighboring pixels.
-    vec2 texture_coord = vec2((float(x_position) + 0.5001) / float(audio_size.x),
-                              (float(y_position) + 0.5001) / float(audio_size.y)); // Offset for max data
-    
-    return texture(tape_history_texture{PLUGIN_SUFFIX}, texture_coord);
+    return get_tape_history_texel{PLUGIN_SUFFIX}(index, channel);
 }
 
 // Overload for backward compatibility - uses global uniforms
@@ -106,35 +109,12 @@ float get_tape_window_size_seconds{PLUGIN_SUFFIX}() {
 // The index is relative to the start of the tape (global index)
 // Returns 0.0 if index is out of range or outside the visible window
 float get_tape_history_sample_at_index{PLUGIN_SUFFIX}(int index, int channel) {
-    // Get texture dimensions
-    ivec2 audio_size = textureSize(tape_history_texture{PLUGIN_SUFFIX}, 0);
-    int audio_width = audio_size.x;
-    
-    // Calculate position relative to window offset (convert global index to window-relative index)
-    int position_in_window = index - tape_window_offset_samples{PLUGIN_SUFFIX};
-    
-    // Check if position is within the visible window
-    if (position_in_window < 0 || position_in_window >= tape_window_size_samples{PLUGIN_SUFFIX}) {
-        return 0.0; // Out of visible window
-    }
-    
     // Check channel bounds
     if (channel < 0 || channel >= num_channels) {
         return 0.0; // Invalid channel
     }
-    
-    // Calculate the x and y position in the texture
-    int x_position = position_in_window % audio_width;
-    int y_row_position = position_in_window / audio_width;
-    
-    // Calculate y_position for the channel (multiply by 2 because of zeros, then add channel offset)
-    int y_position = (y_row_position * num_channels + channel) * 2;
-    
-    // Convert to texture coordinates
-    vec2 texture_coord = vec2((float(x_position) + 0.5001) / float(audio_size.x),
-                              (float(y_position) + 0.5001) / float(audio_size.y));
-    
-    return texture(tape_history_texture{PLUGIN_SUFFIX}, texture_coord).r;
+
+    return get_tape_history_texel{PLUGIN_SUFFIX}(index, channel).r;
 }
 
 // Get audio sample counting from the back (index_from_back = 0 is the current tape position)
@@ -144,36 +124,5 @@ float get_tape_history_sample_from_back{PLUGIN_SUFFIX}(int index_from_back, int
     // Calculate the global index from the current tape position
     // index_from_back = 0 means the current tape position (most recent)
     // index_from_back = 1 means one sample back from current position, etc.
-    int index = tape_position{PLUGIN_SUFFIX} - index_from_back;
-    
-    // Get texture dimensions
-    ivec2 audio_size = textureSize(tape_history_texture{PLUGIN_SUFFIX}, 0);
-    int audio_width = audio_size.x;
-    
-    // Calculate position relative to window offset (convert global index to window-relative index)
-    int position_in_window = index - tape_window_offset_samples{PLUGIN_SUFFIX};
-    
-    // Check if position is within the visible window
-    if (position_in_window < 0 || position_in_window >= tape_window_size_samples{PLUGIN_SUFFIX}) {
-        return 0.0; // Out of visible window
-    }
-    
-    // Check channel bounds
-    if (channel < 0 || channel >= num_channels) {
-        return 0.0; // Invalid channel
-    }
-    
-    // Calculate the x and y position in the texture
-    int x_position = position_in_window % audio_width;
-    int y_row_position = position_in_window / audio_width;
-    
-    // Calculate y_position for the channel (multiply by 2 because of zeros, then add channel offset)
-    int y_position = (y_row_position * num_channels + channel) * 2;
-    
-    // Convert to texture coordinates
-    vec2 texture_coord = vec2((float(x_position) + 0.5001) / float(audio_size.x),
-                              (float(y_position) + 0.5001) / float(audio_size.y));
-    
-    return texture(tape_history_texture{PLUGIN_SUFFIX}, texture_coord).r;
+    return get_tape_history_sample_at_index{PLUGIN_SUFFIX}(tape_position{PLUGIN_SUFFIX} - index_from_back, channel);
 }
-
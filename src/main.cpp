@@ -1,6 +1,7 @@
 #include <iostream>
 #include <unordered_map>
 #include <cmath>
+#include <cstdlib>
 #include "audio_synthesizer/audio_synthesizer.h"
 #include "engine/event_loop.h"
 #include "engine/event_handler.h"
@@ -8,6 +9,8 @@
 #include "graphics_views/debug_view.h"
 #include "graphics_views/mock_interface_view.h"
 #include "graphics_views/menu_view.h"
+#include "utilities/shader_program.h"
+#include "utilities/audio_tracer.h"
 
 #define MIDDLE_C 261.63f
 #define SEMI_TONE 1.059463f
@@ -72,6 +75,14 @@ int main() {
 
     EventLoop& event_loop = EventLoop::get_instance();
 
+    // Reuse linked shader programs across runs when a cache directory is given
+    if (const char * cache_directory = std::getenv("SHADER_DSP_PROGRAM_CACHE")) {
+        AudioShaderProgram::set_binary_cache_directory(cache_directory);
+    }
+
+    // SHADER_DSP_TRACE=<file.json> records a Chrome trace of the audio and UI threads
+    AudioTracer::start_from_environment();
+
     auto & synthesizer = AudioSynthesizer::get_instance();
     if (!synthesizer.initialize(1024, 44100, 2)) {
         std::cerr << "Failed to initialize AudioSynthesizer." << std::endl;
@@ -136,6 +147,7 @@ int main() {
     std::cout << "Press 'o' to toggle component outlines for debugging layout." << std::endl;
 
     event_loop.run_loop();
+    AudioTracer::stop();
     SDL_Quit();
     return 0;
 }
@@ -0,0 +1,111 @@
+#include "catch2/catch_all.hpp"
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <memory>
+
+#include "utilities/audio_command_queue.h"
+
+TEST_CASE("AudioCommandQueue_execute_in_order") {
+    AudioCommandQueue queue(8);
+    std::vector<int> executed;
+
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(queue.push([&executed, i]() { executed.push_back(i); }));
+    }
+    REQUIRE(queue.size() == 5);
+
+    // Nothing runs before execute_all
+    REQUIRE(executed.empty());
+    REQUIRE(queue.execute_all() == 5);
+    REQUIRE(queue.size() == 0);
+    REQUIRE(executed == std::vector<int>{0, 1, 2, 3, 4});
+
+    // An empty queue runs nothing
+    REQUIRE(queue.execute_all() == 0);
+}
+
+TEST_CASE("AudioCommandQueue_full") {
+    AudioCommandQueue queue(2);
+    int counter = 0;
+
+    REQUIRE(queue.push([&counter]() { counter += 1; }));
+    REQUIRE(queue.push([&counter]() { counter += 10; }));
+
+    // A full queue drops the command and counts it
+    REQUIRE_FALSE(queue.push([&counter]() { counter += 100; }));
+    REQUIRE(queue.get_dropped_count() == 1);
+
+    REQUIRE(queue.execute_all() == 2);
+    REQUIRE(counter == 11);
+
+    // Room is made again once the commands ran
+    REQUIRE(queue.push([&counter]() { counter += 100; }));
+    REQUIRE(queue.execute_all() == 1);
+    REQUIRE(counter == 111);
+}
+
+TEST_CASE("AudioCommandQueue_release_on_producer") {
+    AudioCommandQueue queue(4);
+    auto state = std::make_shared<int>(0);
+
+    REQUIRE(queue.push([state]() { (*state)++; }));
+    REQUIRE(state.use_count() == 2);
+
+    // Running the command does not destroy it on the consumer side
+    REQUIRE(queue.execute_all() == 1);
+    REQUIRE(*state == 1);
+    REQUIRE(state.use_count() == 2);
+
+    // The producer releases it, explicitly or on the next push
+    queue.release_executed();
+    REQUIRE(state.use_count() == 1);
+
+    REQUIRE(queue.push([state]() { (*state)++; }));
+    REQUIRE(queue.execute_all() == 1);
+    REQUIRE(queue.push([]() {}));
+    REQUIRE(state.use_count() == 1);
+    REQUIRE(*state == 2);
+}
+
+TEST_CASE("AudioCommandQueue_invalid_size") {
+    REQUIRE_THROWS_AS(AudioCommandQueue(0), std::invalid_argument);
+}
+
+TEST_CASE("AudioCommandQueue_threaded") {
+    constexpr int NUM_COMMANDS = 20000;
+    AudioCommandQueue queue(16);
+
+    // Only the consumer thread touches these
+    int next_expected = 0;
+    int mismatches = 0;
+
+    // The producer retries when the queue is full, so every command runs
+    std::thread producer([&]() {
+        for (int i = 0; i < NUM_COMMANDS; i++) {
+            while (!queue.push([&, i]() {
+                if (i != next_expected) {
+                    mismatches++;
+                }
+                next_expected = i + 1;
+            })) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread consumer([&]() {
+        int executed = 0;
+        while (executed < NUM_COMMANDS) {
+            executed += queue.execute_all();
+            std::this_thread::yield();
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(next_expected == NUM_COMMANDS);
+    REQUIRE(queue.size() == 0);
+}
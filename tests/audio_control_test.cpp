@@ -58,6 +58,34 @@ TEST_CASE("AudioControl constructor without initial value does not invoke setter
     REQUIRE(control->get<int>() == 5);
 }
 
+TEST_CASE("AudioControl keeps its value when the setter is rejected", "[AudioControl]") {
+    int test_value = 0;
+    AudioControl<int> control("rejected", 1, [&](const int& v) { test_value = v; });
+
+    // A dispatcher that queues the setter, and rejects it once the queue is full
+    std::vector<std::function<void()>> queued;
+    AudioControlBase::set_setter_dispatcher([&](std::function<void()>& setter) {
+        if (queued.size() >= 1) {
+            return false;
+        }
+        queued.push_back(std::move(setter));
+        return true;
+    });
+
+    AudioControlBase& base = control;
+    REQUIRE(base.set<int>(2));
+    REQUIRE(control.get<int>() == 2);
+    REQUIRE_FALSE(base.set<int>(3));
+    REQUIRE(control.get<int>() == 2);
+
+    AudioControlBase::set_setter_dispatcher(nullptr);
+    REQUIRE(test_value == 1);
+    for (auto& setter : queued) {
+        setter();
+    }
+    REQUIRE(test_value == 2);
+}
+
 TEST_CASE("AudioControl with different types", "[AudioControl]") {
     // Test int control
     int int_value = 0;
@@ -465,6 +465,197 @@ void main() {
 
 }
 
+TEMPLATE_TEST_CASE("AudioEchoEffectRenderStage - GPU Ring History Matches Tape History", 
+                   "[audio_effect_render_stage][gl_test][gpu_history][template]", 
+                   TestParam1, TestParam3) {
+
+    constexpr auto params = get_test_params(TestType::value);
+    constexpr int BUFFER_SIZE = params.buffer_size;
+    constexpr int NUM_CHANNELS = params.num_channels;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr float ECHO_DELAY = 0.05f;
+    constexpr int NUM_FRAMES = 60;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Impulse train so echoes land in every part of the history
+    std::string impulse_shader = R"(
+void main() {
+    int sample_index = int(TexCoord.x * float(buffer_size));
+    int frame_sample = int(global_time_val) * buffer_size + sample_index;
+    float impulse_value = (frame_sample % 3001 == 100) ? 1.0 : 0.0;
+    output_audio_texture = vec4(impulse_value) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time_param->set_value(0);
+    global_time_param->initialize();
+
+    // Two identical chains, one keeping the echo history on the CPU tape and one on the GPU
+    AudioRenderStage tape_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioEchoEffectRenderStage tape_echo(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage tape_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    AudioRenderStage gpu_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioEchoEffectRenderStage gpu_echo(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage gpu_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    gpu_echo.set_gpu_history_enabled(true);
+    REQUIRE(gpu_echo.is_gpu_history_enabled());
+    REQUIRE_FALSE(tape_echo.is_gpu_history_enabled());
+
+    REQUIRE(tape_generator.connect_render_stage(&tape_echo));
+    REQUIRE(tape_echo.connect_render_stage(&tape_final));
+    REQUIRE(gpu_generator.connect_render_stage(&gpu_echo));
+    REQUIRE(gpu_echo.connect_render_stage(&gpu_final));
+
+    REQUIRE(tape_generator.add_parameter(global_time_param));
+
+    for (auto * echo : {&tape_echo, &gpu_echo}) {
+        echo->find_parameter("delay")->set_value(ECHO_DELAY);
+        echo->find_parameter("decay")->set_value(0.5f);
+        echo->find_parameter("num_echos")->set_value(3);
+    }
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&tape_generator, &tape_echo, &tape_final,
+                                                        &gpu_generator, &gpu_echo, &gpu_final}) {
+        REQUIRE(stage->initialize());
+    }
+
+    context.prepare_draw();
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&tape_generator, &tape_echo, &tape_final,
+                                                        &gpu_generator, &gpu_echo, &gpu_final}) {
+        REQUIRE(stage->bind());
+    }
+
+    float max_output = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        global_time_param->set_value(frame);
+
+        tape_generator.render(frame);
+        tape_echo.render(frame);
+        tape_final.render(frame);
+
+        gpu_generator.render(frame);
+        gpu_echo.render(frame);
+        gpu_final.render(frame);
+
+        const auto & tape_output = tape_final.get_output_buffer_data();
+        const auto & gpu_output = gpu_final.get_output_buffer_data();
+        REQUIRE(tape_output.size() == gpu_output.size());
+
+        for (size_t i = 0; i < tape_output.size(); i++) {
+            INFO("Frame " << frame << ", sample " << i);
+            REQUIRE(gpu_output[i] == Catch::Approx(tape_output[i]).margin(1e-5f));
+            max_output = std::max(max_output, std::fabs(tape_output[i]));
+        }
+    }
+
+    // Make sure the comparison was not between two silent outputs
+    REQUIRE(max_output > 0.9f);
+}
+
+TEMPLATE_TEST_CASE("AudioFrequencyFilterEffectRenderStage - GPU Ring History Matches Tape History", 
+                   "[audio_effect_render_stage][gl_test][gpu_history][template]", 
+                   TestParam1, TestParam3) {
+
+    constexpr auto params = get_test_params(TestType::value);
+    constexpr int BUFFER_SIZE = params.buffer_size;
+    constexpr int NUM_CHANNELS = params.num_channels;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_TAPS = 2 * BUFFER_SIZE + 7; // Taps reach two blocks back into the history
+    constexpr int NUM_FRAMES = 60;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Impulse train with a ramp so every tap of the filter reads the history
+    std::string impulse_shader = R"(
+void main() {
+    int sample_index = int(TexCoord.x * float(buffer_size));
+    int frame_sample = int(global_time_val) * buffer_size + sample_index;
+    float impulse_value = (frame_sample % 1237 == 50) ? 1.0 : 0.0;
+    float ramp_value = float(frame_sample % 97) / 97.0 - 0.5;
+    output_audio_texture = vec4(impulse_value + 0.25 * ramp_value) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time_param->set_value(0);
+    global_time_param->initialize();
+
+    // Two identical chains, one keeping the filter history on the CPU tape and one on the GPU
+    AudioRenderStage tape_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioFrequencyFilterEffectRenderStage tape_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage tape_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    AudioRenderStage gpu_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioFrequencyFilterEffectRenderStage gpu_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage gpu_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    gpu_filter.set_gpu_history_enabled(true);
+    REQUIRE(gpu_filter.is_gpu_history_enabled());
+    REQUIRE_FALSE(tape_filter.is_gpu_history_enabled());
+
+    REQUIRE(tape_generator.connect_render_stage(&tape_filter));
+    REQUIRE(tape_filter.connect_render_stage(&tape_final));
+    REQUIRE(gpu_generator.connect_render_stage(&gpu_filter));
+    REQUIRE(gpu_filter.connect_render_stage(&gpu_final));
+
+    REQUIRE(tape_generator.add_parameter(global_time_param));
+
+    for (auto * filter : {&tape_filter, &gpu_filter}) {
+        filter->find_parameter("num_taps")->set_value(NUM_TAPS);
+        filter->set_low_pass(400.0f);
+        filter->set_high_pass(4000.0f);
+    }
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&tape_generator, &tape_filter, &tape_final,
+                                                        &gpu_generator, &gpu_filter, &gpu_final}) {
+        REQUIRE(stage->initialize());
+    }
+
+    context.prepare_draw();
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&tape_generator, &tape_filter, &tape_final,
+                                                        &gpu_generator, &gpu_filter, &gpu_final}) {
+        REQUIRE(stage->bind());
+    }
+
+    float max_output = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        global_time_param->set_value(frame);
+
+        tape_generator.render(frame);
+        tape_filter.render(frame);
+        tape_final.render(frame);
+
+        gpu_generator.render(frame);
+        gpu_filter.render(frame);
+        gpu_final.render(frame);
+
+        const auto & tape_output = tape_final.get_output_buffer_data();
+        const auto & gpu_output = gpu_final.get_output_buffer_data();
+        REQUIRE(tape_output.size() == gpu_output.size());
+
+        for (size_t i = 0; i < tape_output.size(); i++) {
+            INFO("Frame " << frame << ", sample " << i);
+            // The tape and the ring address the linearly filtered history texture at different
+            // coordinates, which the sampler may round about 1e-3 apart
+            REQUIRE(gpu_output[i] == Catch::Approx(tape_output[i]).epsilon(2e-3f).margin(1e-4f));
+            max_output = std::max(max_output, std::fabs(tape_output[i]));
+        }
+    }
+
+    // Make sure the comparison was not between two silent outputs
+    REQUIRE(max_output > 0.1f);
+}
+
 TEMPLATE_TEST_CASE("AudioEchoEffectRenderStage - Audio Output Test", 
                    "[audio_effect_render_stage][gl_test][audio_output][csv_output][template]", 
                    TestParam3, TestParam4, TestParam5) {
@@ -2237,4 +2428,305 @@ TEMPLATE_TEST_CASE("AudioFrequencyFilterEffectRenderStage - Multiple Renders Per
     filter_effect.unbind();
     generator.unbind();
     // Note: global_time_param is owned by generator and will be deleted automatically
-}
\ No newline at end of file
+}
+TEMPLATE_TEST_CASE("AudioFrequencyFilterEffectRenderStage - FFT Convolution Matches Direct Form", 
+                   "[audio_effect_render_stage][gl_test][fft_convolution][template]", 
+                   TestParam1, TestParam3) {
+
+    constexpr auto params = get_test_params(TestType::value);
+    constexpr int BUFFER_SIZE = params.buffer_size;
+    constexpr int NUM_CHANNELS = params.num_channels;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_TAPS = 3 * BUFFER_SIZE + 7; // Several partitions, the last one partial
+    constexpr int NUM_FRAMES = 6; // Within the first history window of the direct form
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Impulse train with a ramp so every tap of the filter shows in the output
+    std::string impulse_shader = R"(
+void main() {
+    int sample_index = int(TexCoord.x * float(buffer_size));
+    int frame_sample = int(global_time_val) * buffer_size + sample_index;
+    float impulse_value = (frame_sample % 1237 == 50) ? 1.0 : 0.0;
+    float ramp_value = float(frame_sample % 97) / 97.0 - 0.5;
+    output_audio_texture = vec4(impulse_value + 0.25 * ramp_value) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time_param->set_value(0);
+    global_time_param->initialize();
+
+    // Two identical chains, one filtering in the shader and one with the FFT convolution
+    AudioRenderStage direct_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioFrequencyFilterEffectRenderStage direct_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage direct_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    AudioRenderStage fft_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, impulse_shader, true);
+    AudioFrequencyFilterEffectRenderStage fft_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage fft_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    fft_filter.set_fft_convolution_enabled(true);
+    REQUIRE(fft_filter.is_fft_convolution_enabled());
+    REQUIRE_FALSE(direct_filter.is_fft_convolution_enabled());
+
+    REQUIRE(direct_generator.connect_render_stage(&direct_filter));
+    REQUIRE(direct_filter.connect_render_stage(&direct_final));
+    REQUIRE(fft_generator.connect_render_stage(&fft_filter));
+    REQUIRE(fft_filter.connect_render_stage(&fft_final));
+
+    REQUIRE(direct_generator.add_parameter(global_time_param));
+
+    for (auto * filter : {&direct_filter, &fft_filter}) {
+        filter->find_parameter("num_taps")->set_value(NUM_TAPS);
+        filter->set_low_pass(400.0f);
+        filter->set_high_pass(4000.0f);
+    }
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&direct_generator, &direct_filter, &direct_final,
+                                                        &fft_generator, &fft_filter, &fft_final}) {
+        REQUIRE(stage->initialize());
+    }
+
+    context.prepare_draw();
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&direct_generator, &direct_filter, &direct_final,
+                                                        &fft_generator, &fft_filter, &fft_final}) {
+        REQUIRE(stage->bind());
+    }
+
+    float max_output = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        global_time_param->set_value(frame);
+
+        direct_generator.render(frame);
+        direct_filter.render(frame);
+        direct_final.render(frame);
+
+        fft_generator.render(frame);
+        fft_filter.render(frame);
+        fft_final.render(frame);
+
+        const auto & direct_output = direct_final.get_output_buffer_data();
+        const auto & fft_output = fft_final.get_output_buffer_data();
+        REQUIRE(direct_output.size() == fft_output.size());
+
+        for (size_t i = 0; i < direct_output.size(); i++) {
+            INFO("Frame " << frame << ", sample " << i);
+            // The shader sums the taps at the precision of the GPU, which is off by a few 1e-4 over all taps
+            REQUIRE(fft_output[i] == Catch::Approx(direct_output[i]).epsilon(2e-3f).margin(1e-3f));
+            max_output = std::max(max_output, std::fabs(direct_output[i]));
+        }
+    }
+
+    // Make sure the comparison was not between two silent outputs
+    REQUIRE(max_output > 0.1f);
+}
+
+TEMPLATE_TEST_CASE("AudioFrequencyFilterEffectRenderStage - Filter Follower Uses The Coefficient Bank", 
+                   "[audio_effect_render_stage][gl_test][filter_follower][template]", 
+                   TestParam1, TestParam3) {
+
+    constexpr auto params = get_test_params(TestType::value);
+    constexpr int BUFFER_SIZE = params.buffer_size;
+    constexpr int NUM_CHANNELS = params.num_channels;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_FRAMES = 6;
+    constexpr float LOW_PASS = 400.0f;
+    constexpr float HIGH_PASS = 4000.0f;
+    constexpr float FOLLOWER = 1000.0f;
+    constexpr float AMPLITUDE = 0.4f; // A design of the bank, 6 / (COEFF_BANK_SIZE - 1)
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Square wave, every sample has the same amplitude
+    std::string square_shader = R"(
+void main() {
+    int sample_index = int(TexCoord.x * float(buffer_size));
+    int frame_sample = int(global_time_val) * buffer_size + sample_index;
+    float square_value = (frame_sample % 20 < 10) ? 0.4 : -0.4;
+    output_audio_texture = vec4(square_value) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time_param->set_value(0);
+    global_time_param->initialize();
+
+    // The follower moves the cutoffs by FOLLOWER * AMPLITUDE, which the fixed filter has from the start
+    AudioRenderStage follower_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, square_shader, true);
+    AudioFrequencyFilterEffectRenderStage follower_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage follower_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    AudioRenderStage fixed_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, square_shader, true);
+    AudioFrequencyFilterEffectRenderStage fixed_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage fixed_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    follower_filter.set_low_pass(LOW_PASS);
+    follower_filter.set_high_pass(HIGH_PASS);
+    follower_filter.set_filter_follower(FOLLOWER);
+    fixed_filter.set_low_pass(LOW_PASS + FOLLOWER * AMPLITUDE);
+    fixed_filter.set_high_pass(HIGH_PASS + FOLLOWER * AMPLITUDE);
+    fixed_filter.set_filter_follower(0.0f);
+
+    REQUIRE(follower_generator.connect_render_stage(&follower_filter));
+    REQUIRE(follower_filter.connect_render_stage(&follower_final));
+    REQUIRE(fixed_generator.connect_render_stage(&fixed_filter));
+    REQUIRE(fixed_filter.connect_render_stage(&fixed_final));
+
+    REQUIRE(follower_generator.add_parameter(global_time_param));
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&follower_generator, &follower_filter, &follower_final,
+                                                        &fixed_generator, &fixed_filter, &fixed_final}) {
+        REQUIRE(stage->initialize());
+    }
+
+    context.prepare_draw();
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&follower_generator, &follower_filter, &follower_final,
+                                                        &fixed_generator, &fixed_filter, &fixed_final}) {
+        REQUIRE(stage->bind());
+    }
+
+    float max_output = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        global_time_param->set_value(frame);
+
+        follower_generator.render(frame);
+        follower_filter.render(frame);
+        follower_final.render(frame);
+
+        fixed_generator.render(frame);
+        fixed_filter.render(frame);
+        fixed_final.render(frame);
+
+        // The bank is designed once, following the amplitude does not change the coefficients
+        REQUIRE(*(int *)follower_filter.find_parameter("coeff_bank_rows")->get_value() ==
+                (int)AudioFrequencyFilterEffectRenderStage::COEFF_BANK_SIZE);
+        REQUIRE(*(int *)fixed_filter.find_parameter("coeff_bank_rows")->get_value() == 1);
+
+        const auto & follower_output = follower_final.get_output_buffer_data();
+        const auto & fixed_output = fixed_final.get_output_buffer_data();
+        REQUIRE(follower_output.size() == fixed_output.size());
+
+        for (size_t i = 0; i < fixed_output.size(); i++) {
+            INFO("Frame " << frame << ", sample " << i);
+            REQUIRE(follower_output[i] == Catch::Approx(fixed_output[i]).epsilon(2e-3f).margin(1e-4f));
+            max_output = std::max(max_output, std::fabs(fixed_output[i]));
+        }
+    }
+
+    // Make sure the comparison was not between two silent outputs
+    REQUIRE(max_output > 0.1f);
+}
+
+TEMPLATE_TEST_CASE("AudioFrequencyFilterEffectRenderStage - FFT Convolution Follows The Amplitude Every Block", 
+                   "[audio_effect_render_stage][gl_test][filter_follower][fft_convolution][template]", 
+                   TestParam1, TestParam3) {
+
+    constexpr auto params = get_test_params(TestType::value);
+    constexpr int BUFFER_SIZE = params.buffer_size;
+    constexpr int NUM_CHANNELS = params.num_channels;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_FRAMES = 6;
+    constexpr float FOLLOWER = 1000.0f;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Square wave whose amplitude drops every two blocks, between and on the designs of the bank
+    std::string square_shader = R"(
+void main() {
+    int sample_index = int(TexCoord.x * float(buffer_size));
+    int frame = int(global_time_val);
+    int frame_sample = frame * buffer_size + sample_index;
+    float amplitude = frame < 2 ? 0.4 : (frame < 4 ? 0.3 : 0.2);
+    float square_value = (frame_sample % 20 < 10) ? amplitude : -amplitude;
+    output_audio_texture = vec4(square_value) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+    global_time_param->set_value(0);
+    global_time_param->initialize();
+
+    // Two identical following chains, one filtering in the shader and one with the FFT convolution
+    AudioRenderStage direct_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, square_shader, true);
+    AudioFrequencyFilterEffectRenderStage direct_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage direct_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    AudioRenderStage fft_generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, square_shader, true);
+    AudioFrequencyFilterEffectRenderStage fft_filter(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    AudioFinalRenderStage fft_final(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    // The direct form follows without reading its input back
+    direct_filter.set_gpu_history_enabled(true);
+    fft_filter.set_fft_convolution_enabled(true);
+    for (auto * filter : {&direct_filter, &fft_filter}) {
+        filter->set_low_pass(400.0f);
+        filter->set_high_pass(4000.0f);
+        filter->set_filter_follower(FOLLOWER);
+    }
+
+    REQUIRE(direct_generator.connect_render_stage(&direct_filter));
+    REQUIRE(direct_filter.connect_render_stage(&direct_final));
+    REQUIRE(fft_generator.connect_render_stage(&fft_filter));
+    REQUIRE(fft_filter.connect_render_stage(&fft_final));
+
+    REQUIRE(direct_generator.add_parameter(global_time_param));
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&direct_generator, &direct_filter, &direct_final,
+                                                        &fft_generator, &fft_filter, &fft_final}) {
+        REQUIRE(stage->initialize());
+    }
+
+    context.prepare_draw();
+
+    for (auto * stage : std::vector<AudioRenderStage *>{&direct_generator, &direct_filter, &direct_final,
+                                                        &fft_generator, &fft_filter, &fft_final}) {
+        REQUIRE(stage->bind());
+    }
+
+    float max_output = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        global_time_param->set_value(frame);
+
+        direct_generator.render(frame);
+        direct_filter.render(frame);
+        direct_final.render(frame);
+
+        fft_generator.render(frame);
+        fft_filter.render(frame);
+        fft_final.render(frame);
+
+        // Both follow the amplitude of the block, with the whole bank designed once
+        REQUIRE(fft_filter.m_fft_convolver.get_num_responses() == AudioFrequencyFilterEffectRenderStage::COEFF_BANK_SIZE);
+
+        // The direct form rendered the mean absolute value of the square wave on the GPU, within the
+        // medium precision the wave is generated at
+        float block_amplitude = 0.0f;
+        glBindFramebuffer(GL_FRAMEBUFFER, direct_filter.m_amplitude_framebuffer);
+        glReadPixels(0, 0, 1, 1, GL_RED, GL_FLOAT, &block_amplitude);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        REQUIRE(block_amplitude == Catch::Approx(frame < 2 ? 0.4f : (frame < 4 ? 0.3f : 0.2f)).margin(1e-3f));
+
+        const auto & direct_output = direct_final.get_output_buffer_data();
+        const auto & fft_output = fft_final.get_output_buffer_data();
+        REQUIRE(direct_output.size() == fft_output.size());
+
+        for (size_t i = 0; i < direct_output.size(); i++) {
+            INFO("Frame " << frame << ", sample " << i);
+            // The shader sums the taps at the precision of the GPU, which is off by a few 1e-4 over all taps
+            REQUIRE(fft_output[i] == Catch::Approx(direct_output[i]).epsilon(2e-3f).margin(1e-3f));
+            max_output = std::max(max_output, std::fabs(direct_output[i]));
+        }
+    }
+
+    // Make sure the comparison was not between two silent outputs
+    REQUIRE(max_output > 0.1f);
+}
@@ -0,0 +1,192 @@
+#include "catch2/catch_all.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "utilities/audio_fft_convolver.h"
+
+// Direct form convolution of a whole channel, the reference for the partitioned convolution
+static std::vector<float> convolve_direct(const std::vector<float> & input, const std::vector<float> & taps) {
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t n = 0; n < input.size(); n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < taps.size() && k <= n; k++) {
+            sum += double(taps[k]) * input[n - k];
+        }
+        output[n] = float(sum);
+    }
+    return output;
+}
+
+static std::vector<float> make_signal(const size_t length, const float frequency) {
+    std::vector<float> signal(length);
+    for (size_t i = 0; i < length; i++) {
+        signal[i] = 0.5f * std::sin(frequency * i) + 0.25f * std::sin(0.37f * frequency * i * i / length);
+    }
+    return signal;
+}
+
+static std::vector<float> make_taps(const unsigned int num_taps) {
+    std::vector<float> taps(num_taps);
+    for (unsigned int i = 0; i < num_taps; i++) {
+        taps[i] = std::exp(-float(i) / (num_taps / 4.0f + 1.0f)) * std::cos(0.3f * i) / (num_taps / 8.0f + 1.0f);
+    }
+    return taps;
+}
+
+// Convolves two channels block by block and compares them with the direct form
+static void check_against_direct(const unsigned int block_size, const unsigned int num_taps) {
+    constexpr unsigned int NUM_CHANNELS = 2;
+    constexpr unsigned int NUM_BLOCKS = 12;
+
+    const auto taps = make_taps(num_taps);
+    std::vector<std::vector<float>> signals = {
+        make_signal(block_size * NUM_BLOCKS, 0.05f),
+        make_signal(block_size * NUM_BLOCKS, 0.21f)
+    };
+
+    AudioFFTConvolver convolver(block_size, NUM_CHANNELS);
+    convolver.set_impulse_response(taps.data(), num_taps);
+    REQUIRE(convolver.get_num_partitions() == (num_taps + block_size - 1) / block_size);
+
+    std::vector<float> input(block_size * NUM_CHANNELS);
+    std::vector<float> output(block_size * NUM_CHANNELS);
+    for (unsigned int block = 0; block < NUM_BLOCKS; block++) {
+        for (unsigned int channel = 0; channel < NUM_CHANNELS; channel++) {
+            std::copy_n(signals[channel].begin() + block * block_size, block_size, input.begin() + channel * block_size);
+        }
+        convolver.process(input.data(), output.data());
+
+        for (unsigned int channel = 0; channel < NUM_CHANNELS; channel++) {
+            const auto expected = convolve_direct(signals[channel], taps);
+            for (unsigned int i = 0; i < block_size; i++) {
+                REQUIRE(output[channel * block_size + i] == Catch::Approx(expected[block * block_size + i]).margin(1e-4));
+            }
+        }
+    }
+}
+
+TEST_CASE("AudioFFTConvolver_matches_direct_form") {
+    SECTION("Taps within one block") {
+        check_against_direct(64, 1);
+        check_against_direct(64, 63);
+    }
+    SECTION("Taps over several partitions") {
+        check_against_direct(64, 64);
+        check_against_direct(64, 4 * 64 + 5);
+        check_against_direct(32, 1024);
+    }
+    SECTION("Block size that is not a power of two") {
+        check_against_direct(100, 250);
+    }
+}
+
+TEST_CASE("AudioFFTConvolver_render_same_block_again") {
+    constexpr unsigned int BLOCK_SIZE = 32;
+    const auto taps = make_taps(3 * BLOCK_SIZE);
+
+    AudioFFTConvolver convolver(BLOCK_SIZE, 1);
+    convolver.set_impulse_response(taps.data(), taps.size());
+
+    std::vector<float> first(BLOCK_SIZE, 0.5f);
+    std::vector<float> second(BLOCK_SIZE, -0.25f);
+    std::vector<float> output(BLOCK_SIZE);
+    std::vector<float> expected(BLOCK_SIZE);
+
+    convolver.process(first.data(), output.data());
+    convolver.process(second.data(), expected.data());
+
+    // Rendering the second block again with another input and then the real one replaces it
+    AudioFFTConvolver rerendered(BLOCK_SIZE, 1);
+    rerendered.set_impulse_response(taps.data(), taps.size());
+    rerendered.process(first.data(), output.data());
+    rerendered.process(first.data(), output.data());
+    rerendered.process(second.data(), output.data(), false);
+    for (unsigned int i = 0; i < BLOCK_SIZE; i++) {
+        REQUIRE(output[i] == Catch::Approx(expected[i]).margin(1e-5));
+    }
+}
+
+TEST_CASE("AudioFFTConvolver_mixes_a_bank_per_block") {
+    constexpr unsigned int BLOCK_SIZE = 32;
+    constexpr unsigned int NUM_TAPS = 2 * BLOCK_SIZE + 7;
+    constexpr unsigned int STRIDE = 128;
+    constexpr unsigned int NUM_RESPONSES = 3;
+    constexpr unsigned int NUM_BLOCKS = 8;
+
+    // Responses that differ in every partition
+    std::vector<float> bank(STRIDE * NUM_RESPONSES, 0.0f);
+    for (unsigned int response = 0; response < NUM_RESPONSES; response++) {
+        const auto taps = make_taps(NUM_TAPS + 9 * response);
+        std::copy_n(taps.begin(), NUM_TAPS, bank.begin() + response * STRIDE);
+    }
+    const auto signal = make_signal(BLOCK_SIZE * NUM_BLOCKS, 0.13f);
+
+    AudioFFTConvolver convolver(BLOCK_SIZE, 1);
+    convolver.set_impulse_responses(bank.data(), NUM_TAPS, NUM_RESPONSES, STRIDE);
+    REQUIRE(convolver.get_num_responses() == NUM_RESPONSES);
+
+    std::vector<float> output(BLOCK_SIZE);
+    for (unsigned int block = 0; block < NUM_BLOCKS; block++) {
+        const unsigned int response = block % NUM_RESPONSES;
+        const float weight = float(block % 4) / 4.0f;
+        convolver.process(signal.data() + block * BLOCK_SIZE, output.data(), true, response, weight);
+
+        // Every tap of the block uses the mixed coefficients, as the direct form in the shader does
+        const unsigned int next_response = std::min(response + 1, NUM_RESPONSES - 1);
+        std::vector<float> mixed(NUM_TAPS);
+        for (unsigned int tap = 0; tap < NUM_TAPS; tap++) {
+            const float first = bank[response * STRIDE + tap];
+            mixed[tap] = first + weight * (bank[next_response * STRIDE + tap] - first);
+        }
+        const auto expected = convolve_direct(std::vector<float>(signal.begin(), signal.begin() + (block + 1) * BLOCK_SIZE), mixed);
+        for (unsigned int i = 0; i < BLOCK_SIZE; i++) {
+            REQUIRE(output[i] == Catch::Approx(expected[block * BLOCK_SIZE + i]).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("AudioFFTConvolver_impulse_response_change_and_reset") {
+    constexpr unsigned int BLOCK_SIZE = 16;
+    constexpr unsigned int DELAY = 4;
+    std::vector<float> ones(BLOCK_SIZE, 1.0f);
+    std::vector<float> silence(BLOCK_SIZE, 0.0f);
+    std::vector<float> output(BLOCK_SIZE);
+
+    // Without an impulse response the output is silent
+    AudioFFTConvolver convolver(BLOCK_SIZE, 1);
+    convolver.process(ones.data(), output.data());
+    for (float sample : output) {
+        REQUIRE(sample == 0.0f);
+    }
+
+    const std::vector<float> identity = {1.0f};
+    convolver.set_impulse_response(identity.data(), identity.size());
+    convolver.process(ones.data(), output.data());
+    for (float sample : output) {
+        REQUIRE(sample == Catch::Approx(1.0f).margin(1e-5));
+    }
+
+    // A new response still convolves the input of the previous block
+    std::vector<float> delay(DELAY + 1, 0.0f);
+    delay[DELAY] = 1.0f;
+    convolver.set_impulse_response(delay.data(), delay.size());
+    convolver.process(silence.data(), output.data());
+    for (unsigned int i = 0; i < BLOCK_SIZE; i++) {
+        REQUIRE(output[i] == Catch::Approx(i < DELAY ? 1.0f : 0.0f).margin(1e-5));
+    }
+
+    // Without history the delayed samples are gone
+    convolver.process(ones.data(), output.data());
+    convolver.reset();
+    convolver.process(silence.data(), output.data());
+    for (float sample : output) {
+        REQUIRE(sample == Catch::Approx(0.0f).margin(1e-5));
+    }
+}
+
+TEST_CASE("AudioFFTConvolver_invalid_size") {
+    REQUIRE_THROWS_AS(AudioFFTConvolver(0, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(AudioFFTConvolver(64, 0), std::invalid_argument);
+}
@@ -0,0 +1,98 @@
+#include "catch2/catch_all.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "audio_core/audio_fused_render_pass.h"
+
+static const std::string SCALE_SHADER = R"(
+// Scales the stream
+uniform float gain;
+const float OFFSET = 0.1;
+
+float scale(float x) {
+    return x * gain + OFFSET;
+}
+
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    output_audio_texture = vec4(scale(stream_audio.r));
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+TEST_CASE("AudioFusedRenderPass_is_point_wise_source") {
+    REQUIRE(AudioFusedRenderPass::is_point_wise_source(SCALE_SHADER));
+
+    SECTION("Sampling the stream away from TexCoord") {
+        const std::string body = R"(
+void main() {
+    output_audio_texture = texture(stream_audio_texture, TexCoord + vec2(0.01, 0.0));
+}
+)";
+        REQUIRE_FALSE(AudioFusedRenderPass::is_point_wise_source(body));
+    }
+
+    SECTION("Sampling another texture") {
+        const std::string body = R"(
+uniform sampler2D history_texture;
+void main() {
+    output_audio_texture = texture(stream_audio_texture, TexCoord) + texture(history_texture, TexCoord);
+}
+)";
+        REQUIRE_FALSE(AudioFusedRenderPass::is_point_wise_source(body));
+    }
+
+    SECTION("Discarding fragments") {
+        const std::string body = R"(
+void main() {
+    if (TexCoord.x > 0.5) {
+        discard;
+    }
+    output_audio_texture = texture(stream_audio_texture, TexCoord);
+}
+)";
+        REQUIRE_FALSE(AudioFusedRenderPass::is_point_wise_source(body));
+    }
+
+    SECTION("Declaring several globals in one statement") {
+        const std::string body = R"(
+uniform float left_gain, right_gain;
+void main() {
+    output_audio_texture = texture(stream_audio_texture, TexCoord) * left_gain * right_gain;
+}
+)";
+        REQUIRE_FALSE(AudioFusedRenderPass::is_point_wise_source(body));
+    }
+}
+
+TEST_CASE("AudioFusedRenderPass_namespace_source") {
+    std::string namespaced_body;
+    std::vector<std::string> global_names;
+
+    SECTION("First stage keeps sampling the stream") {
+        REQUIRE(AudioFusedRenderPass::namespace_source(SCALE_SHADER, "_stage0", true, namespaced_body, global_names));
+        REQUIRE(global_names.size() == 4);
+        for (const auto & name : {"gain", "OFFSET", "scale", "main"}) {
+            REQUIRE(std::find(global_names.begin(), global_names.end(), name) != global_names.end());
+        }
+
+        REQUIRE(namespaced_body.find("uniform float gain_stage0;") != std::string::npos);
+        REQUIRE(namespaced_body.find("x * gain_stage0 + OFFSET_stage0") != std::string::npos);
+        REQUIRE(namespaced_body.find("void main_stage0()") != std::string::npos);
+        REQUIRE(namespaced_body.find("scale_stage0(stream_audio.r)") != std::string::npos);
+        REQUIRE(namespaced_body.find("texture(stream_audio_texture, TexCoord)") != std::string::npos);
+
+        // Names that only contain a global are left alone
+        REQUIRE(namespaced_body.find("stream_audio_stage0") == std::string::npos);
+        REQUIRE(namespaced_body.find("Scales the stream") == std::string::npos);
+    }
+
+    SECTION("Later stages read the output of the previous stage") {
+        REQUIRE(AudioFusedRenderPass::namespace_source(SCALE_SHADER, "_stage2", false, namespaced_body, global_names));
+        REQUIRE(namespaced_body.find("stream_audio_texture") == std::string::npos);
+        REQUIRE(namespaced_body.find("vec4 stream_audio = fused_stream_audio;") != std::string::npos);
+        REQUIRE(namespaced_body.find("void main_stage2()") != std::string::npos);
+    }
+}
@@ -6,6 +6,7 @@
 #include "audio_render_stage/audio_generator_render_stage.h"
 #include "audio_render_stage/audio_file_generator_render_stage.h"
 #include "audio_render_stage/audio_final_render_stage.h"
+#include "audio_parameter/audio_uniform_parameter.h"
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
 #include "audio_output/audio_player_output.h"
 #include "audio_output/audio_wav.h"
@@ -1903,4 +1904,33 @@ TEST_CASE("AudioGeneratorRenderStage - Note State Transfer on Connect/Disconnect
     generator3.unbind();
     final_render_stage.unbind();
     delete global_time_param;
-}
\ No newline at end of file
+}
+
+TEST_CASE("AudioGeneratorRenderStage - Note parameter handles follow replacement and removal", "[audio_generator_render_stage][gl_test][parameters]") {
+    constexpr int BUFFER_SIZE = 512;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    AudioGeneratorRenderStage generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+                                        "build/shaders/multinote_sine_generator_render_stage.glsl");
+    REQUIRE(generator.m_release_time_param == generator.find_parameter("release_time"));
+
+    // A replaced parameter is the one the note updates read
+    auto * release_time = new AudioFloatParameter("release_time", AudioParameter::ConnectionType::INPUT);
+    release_time->set_value(0.25f);
+    REQUIRE(generator.add_parameter(release_time));
+    REQUIRE(generator.m_release_time_param == release_time);
+
+    // Removed parameters leave no dangling handle, and the notes still play and stop
+    REQUIRE(generator.remove_parameter("stop_positions"));
+    REQUIRE(generator.remove_parameter("release_time"));
+    REQUIRE(generator.m_stop_positions_param == nullptr);
+    REQUIRE(generator.m_release_time_param == nullptr);
+
+    generator.play_note({440.0f, 0.5f});
+    generator.stop_note(440.0f);
+    generator.play_note({440.0f, 0.5f});
+}
@@ -0,0 +1,153 @@
+#include "catch2/catch_all.hpp"
+#include "framework/test_main.h"
+
+#include "audio_core/audio_offline_renderer.h"
+#include "audio_core/audio_render_graph.h"
+#include "audio_core/audio_render_stage.h"
+#include "audio_core/audio_tape.h"
+#include "audio_render_stage/audio_final_render_stage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Outputs the block index (global time) on every sample, so ordering, latency and batching can be checked
+static const std::string BLOCK_INDEX_SHADER = R"(
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    output_audio_texture = vec4(float(block_time())) + stream_audio;
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+// Outputs a distinct value for every sample of every block, so the order of the samples can be checked.
+// The values stay below 2048 so they are exact even at half precision.
+static const std::string SAMPLE_INDEX_SHADER = R"(
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    float index = float(audio_column(0, 1) + buffer_size * (audio_channel() + num_channels * block_time()));
+    output_audio_texture = vec4(index) + stream_audio;
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+static AudioRenderGraph * make_block_index_graph(const int buffer_size, const int sample_rate, const int num_channels) {
+    auto * generator = new AudioRenderStage(buffer_size, sample_rate, num_channels, BLOCK_INDEX_SHADER, true);
+    auto * final_stage = new AudioFinalRenderStage(buffer_size, sample_rate, num_channels);
+    generator->connect_render_stage(final_stage);
+    return new AudioRenderGraph(final_stage);
+}
+
+TEST_CASE("AudioOfflineRenderer - headless bounce to tape", "[audio_offline_renderer][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_BLOCKS = 32;
+
+    // No SDL window or EventLoop: the renderer creates its own headless context
+    AudioOfflineRenderer renderer(make_block_index_graph(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS),
+                                  BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    unsigned int latency = 0;
+    unsigned int blocks_per_render = 1;
+    SECTION("Synchronous readback") {
+        latency = 0;
+    }
+    SECTION("Pipelined readback") {
+        latency = 3;
+    }
+    SECTION("Batched rendering") {
+        blocks_per_render = 4;
+    }
+    SECTION("Batched rendering with pipelined readback") {
+        latency = 2;
+        blocks_per_render = 8;
+    }
+
+    REQUIRE(renderer.get_render_graph()->set_blocks_per_render(blocks_per_render));
+    REQUIRE(renderer.set_readback_latency(latency));
+    REQUIRE(renderer.initialize());
+
+    auto tape = std::make_shared<AudioTape>(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(renderer.set_output_tape(tape));
+
+    REQUIRE(renderer.render_blocks(NUM_BLOCKS / 2));
+    REQUIRE(renderer.render_blocks(NUM_BLOCKS / 2));
+    REQUIRE(renderer.get_rendered_blocks() == NUM_BLOCKS);
+    REQUIRE(tape->size() == NUM_BLOCKS * BUFFER_SIZE);
+
+    // Every block lands on the tape in order, regardless of the readback latency and batch size
+    for (int block = 0; block < NUM_BLOCKS; ++block) {
+        auto samples = tape->playback(static_cast<unsigned int>(block * BUFFER_SIZE));
+        for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+            for (int i = 0; i < BUFFER_SIZE; ++i) {
+                REQUIRE(samples[ch * BUFFER_SIZE + i] == Catch::Approx(static_cast<float>(block)));
+            }
+        }
+    }
+
+    // Latency can no longer change once rendering has started
+    REQUIRE_FALSE(renderer.set_readback_latency(latency + 1));
+}
+
+TEST_CASE("AudioOfflineRenderer - render_seconds rounds up to whole blocks", "[audio_offline_renderer][gl_test]") {
+    constexpr int BUFFER_SIZE = 512;
+    constexpr int NUM_CHANNELS = 1;
+    constexpr int SAMPLE_RATE = 44100;
+
+    AudioOfflineRenderer renderer(make_block_index_graph(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS),
+                                  BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(renderer.initialize());
+
+    REQUIRE(renderer.render_seconds(1.0f));
+    REQUIRE(renderer.get_rendered_blocks() == (SAMPLE_RATE + BUFFER_SIZE - 1) / BUFFER_SIZE);
+    REQUIRE(renderer.get_realtime_factor() > 0.0f);
+
+    REQUIRE_FALSE(renderer.render_seconds(-1.0f));
+}
+
+TEST_CASE("AudioOfflineRenderer - packed output keeps the sample order", "[audio_offline_renderer][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_BLOCKS = 4;
+
+    auto * generator = new AudioRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, SAMPLE_INDEX_SHADER, true);
+    auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(generator->connect_render_stage(final_stage));
+    AudioOfflineRenderer renderer(new AudioRenderGraph(final_stage), BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    bool packed = false;
+    unsigned int blocks_per_render = 1;
+    SECTION("One sample per texel") {
+        packed = false;
+    }
+    SECTION("Packed output") {
+        packed = true;
+    }
+    SECTION("Batched packed output") {
+        packed = true;
+        blocks_per_render = 2;
+    }
+
+    REQUIRE(final_stage->set_packed_output(packed));
+    REQUIRE(final_stage->is_output_packed() == packed);
+    REQUIRE(renderer.get_render_graph()->set_blocks_per_render(blocks_per_render));
+    REQUIRE(renderer.initialize());
+    REQUIRE_FALSE(final_stage->set_packed_output(!packed));
+
+    // The interleaved output of every batch is in sample order, whatever the texel layout
+    for (int first_block = 0; first_block < NUM_BLOCKS; first_block += blocks_per_render) {
+        REQUIRE(renderer.render_blocks(blocks_per_render));
+        const auto & output = final_stage->get_output_buffer_data();
+        REQUIRE(output.size() == blocks_per_render * BUFFER_SIZE * NUM_CHANNELS);
+        for (unsigned int block = 0; block < blocks_per_render; ++block) {
+            for (int i = 0; i < BUFFER_SIZE; ++i) {
+                for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+                    const float expected = static_cast<float>(i + BUFFER_SIZE * (ch + NUM_CHANNELS * (first_block + block)));
+                    REQUIRE(output[(block * BUFFER_SIZE + i) * NUM_CHANNELS + ch] == expected);
+                }
+            }
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include "audio_core/audio_parameter.h"
 #include "audio_parameter/audio_texture2d_parameter.h"
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "audio_parameter/audio_uniform_parameter.h"
 #include <functional>
 #include <cmath>
 /**
@@ -226,6 +227,136 @@ TEST_CASE("AudioTexture2DParameter Input Test", "[audio_parameter][gl_test][inpu
     }
 }
 
+TEST_CASE("AudioTexture2DParameter sub-rectangle set_value uploads only dirty regions", "[audio_parameter][gl_test][input][dirty_region]") {
+    const char* vert_src = R"(
+        #version 300 es
+        precision mediump float;
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        void main()
+        {
+            gl_Position = vec4(aPos, 0.0, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+    const char* frag_src_io = R"(
+        #version 300 es
+        precision mediump float;
+        in vec2 TexCoord;
+        uniform sampler2D input_tex;
+        out vec4 color;
+        void main() {
+            color = texture(input_tex, TexCoord);
+        }
+    )";
+
+    constexpr int WIDTH = 32;
+    constexpr int HEIGHT = 4;
+
+    SDLWindow window(WIDTH, HEIGHT);
+    GLContext context;
+    AudioShaderProgram shader_prog(vert_src, frag_src_io);
+    REQUIRE(shader_prog.initialize());
+    GLFramebuffer framebuffer;
+
+    AudioTexture2DParameter input_param(
+        "input_tex",
+        AudioParameter::ConnectionType::INPUT,
+        WIDTH, HEIGHT,
+        1, // active_texture
+        0, // color_attachment (not used for input)
+        GL_NEAREST,
+        GL_FLOAT,
+        GL_RED,
+        GL_R32F
+    );
+    AudioTexture2DParameter output_param(
+        "color",
+        AudioParameter::ConnectionType::OUTPUT,
+        WIDTH, HEIGHT,
+        0, // active_texture
+        0, // color_attachment
+        GL_NEAREST,
+        GL_FLOAT,
+        GL_RGBA,
+        GL_RGBA32F
+    );
+
+    std::vector<float> expected(WIDTH * HEIGHT, 1.0f);
+    REQUIRE(input_param.set_value(expected.data()));
+    REQUIRE(input_param.initialize(0, &shader_prog));
+    REQUIRE(output_param.initialize(framebuffer.fbo, &shader_prog));
+
+    framebuffer.bind();
+    REQUIRE(input_param.bind());
+    REQUIRE(output_param.bind());
+    shader_prog.use_program();
+    context.prepare_draw();
+    std::vector<GLenum> drawBuffers = {GL_COLOR_ATTACHMENT0 + output_param.get_color_attachment()};
+    context.set_draw_buffers(drawBuffers);
+
+    auto render_and_check = [&]() {
+        input_param.render();
+        output_param.render();
+        // The readback and draw() leave the framebuffer and vertex array unbound
+        framebuffer.bind();
+        context.prepare_draw();
+        context.draw();
+
+        const float* pixels = static_cast<const float*>(output_param.get_value());
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            INFO("Texel " << i);
+            REQUIRE(pixels[i * 4] == Catch::Approx(expected[i]));
+        }
+    };
+
+    render_and_check();
+
+    SECTION("Sub-rectangle") {
+        std::vector<float> region = {2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+        REQUIRE(input_param.set_value(region.data(), 5, 1, 3, 2));
+        REQUIRE(input_param.m_dirty_regions.size() == 1);
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 3; ++x) {
+                expected[(1 + y) * WIDTH + 5 + x] = region[y * 3 + x];
+            }
+        }
+        render_and_check();
+        REQUIRE(input_param.m_dirty_regions.empty());
+    }
+
+    SECTION("Rows") {
+        std::vector<float> rows(WIDTH * 2);
+        for (int i = 0; i < WIDTH * 2; ++i) {
+            rows[i] = static_cast<float>(i);
+        }
+        REQUIRE(input_param.set_value_rows(rows.data(), 2, 2));
+        std::copy(rows.begin(), rows.end(), expected.begin() + 2 * WIDTH);
+        render_and_check();
+    }
+
+    SECTION("Multiple regions in one block") {
+        float a = 8.0f;
+        float b = 9.0f;
+        REQUIRE(input_param.set_value(&a, 0, 0, 1, 1));
+        REQUIRE(input_param.set_value(&b, WIDTH - 1, HEIGHT - 1, 1, 1));
+        expected[0] = a;
+        expected[WIDTH * HEIGHT - 1] = b;
+        render_and_check();
+    }
+
+    SECTION("Out of bounds region is rejected") {
+        float a = 8.0f;
+        REQUIRE_FALSE(input_param.set_value(&a, WIDTH, 0, 1, 1));
+        REQUIRE_FALSE(output_param.set_value(&a, 0, 0, 1, 1));
+    }
+
+    input_param.unbind();
+    output_param.unbind();
+    framebuffer.unbind();
+}
+
 // Multi I/O test parameter structure
 struct MultiIOTestParams {
     int width;
@@ -1584,6 +1715,215 @@ TEST_CASE("Unconnected PASSTHROUGH get_value returns 0 values", "[audio_paramete
 
 }
 
+TEST_CASE("Half float PASSTHROUGH keeps a renderable storage", "[audio_parameter][gl_test][passthrough][half_float]") {
+    const char* vert_src = R"(
+        #version 300 es
+        precision mediump float;
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        void main() {
+            gl_Position = vec4(aPos, 0.0, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    const char* frag_src = R"(
+        #version 300 es
+        precision mediump float;
+        in vec2 TexCoord;
+        uniform sampler2D shared_tex;
+        out vec4 color;
+        void main() {
+            float r = texture(shared_tex, TexCoord).r;
+            color = vec4(r, 0.0, 0.0, 1.0);
+        }
+    )";
+
+    SDLWindow window(8, 1);
+    GLContext context;
+    AudioShaderProgram shader_prog(vert_src, frag_src);
+    REQUIRE(shader_prog.initialize());
+    GLFramebuffer framebuffer;
+
+    AudioTexture2DParameter passthrough_param("shared_tex", AudioParameter::ConnectionType::PASSTHROUGH, 8, 1);
+    REQUIRE(passthrough_param.set_half_float(true));
+    REQUIRE(passthrough_param.initialize(framebuffer.fbo, &shader_prog));
+
+    // Without the color buffer extensions the texture falls back to 32-bit storage
+    REQUIRE(passthrough_param.is_half_float() == AudioTexture2DParameter::half_float_renderable());
+
+    // Either way the stage before can render into it
+    framebuffer.bind();
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, passthrough_param.get_texture(), 0);
+    REQUIRE(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    framebuffer.unbind();
+}
+
+TEST_CASE("AudioTexture2DParameter asynchronous readback latency", "[audio_parameter][gl_test][output][readback]") {
+    const char* vert_src = R"(
+        #version 300 es
+        precision mediump float;
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        void main() {
+            gl_Position = vec4(aPos, 0.0, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    const char* frag_src = R"(
+        #version 300 es
+        precision mediump float;
+        in vec2 TexCoord;
+        uniform float block_value;
+        out vec4 color;
+        void main() {
+            color = vec4(block_value, 0.0, 0.0, 1.0);
+        }
+    )";
+
+    constexpr int WIDTH = 64;
+    constexpr int HEIGHT = 2;
+    constexpr unsigned int LATENCY = 2;
+    constexpr int NUM_BLOCKS = 6;
+
+    SDLWindow window(WIDTH, HEIGHT);
+    GLContext context;
+    AudioShaderProgram shader_prog(vert_src, frag_src);
+    REQUIRE(shader_prog.initialize());
+    GLFramebuffer framebuffer;
+
+    AudioTexture2DParameter output_param(
+        "color",
+        AudioParameter::ConnectionType::OUTPUT,
+        WIDTH, HEIGHT,
+        0, // active_texture
+        0, // color_attachment
+        GL_NEAREST,
+        GL_FLOAT,
+        GL_RGBA,
+        GL_RGBA32F
+    );
+    REQUIRE(output_param.set_readback_latency(LATENCY));
+    REQUIRE(output_param.get_readback_latency() == LATENCY);
+    REQUIRE(output_param.initialize(framebuffer.fbo, &shader_prog));
+
+    framebuffer.bind();
+    REQUIRE(output_param.bind());
+    shader_prog.use_program();
+    context.prepare_draw();
+    std::vector<GLenum> drawBuffers = {GL_COLOR_ATTACHMENT0 + output_param.get_color_attachment()};
+    context.set_draw_buffers(drawBuffers);
+
+    // The readback and draw() leave the framebuffer and vertex array unbound
+    auto draw_block = [&](const float value) {
+        glUniform1f(glGetUniformLocation(shader_prog.get_program(), "block_value"), value);
+        framebuffer.bind();
+        context.prepare_draw();
+        context.draw();
+    };
+
+    SECTION("Output is delayed by the configured number of blocks") {
+        for (int block = 0; block < NUM_BLOCKS; ++block) {
+            draw_block(static_cast<float>(block + 1));
+
+            const float* pixels = static_cast<const float*>(output_param.get_value());
+            // Zeros until the ring is primed, then the block rendered LATENCY calls earlier
+            float expected = block < static_cast<int>(LATENCY) ? 0.0f : static_cast<float>(block + 1 - LATENCY);
+            for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+                REQUIRE(pixels[i * 4] == Catch::Approx(expected));
+            }
+        }
+    }
+
+    SECTION("Readback becomes ready once the GPU has finished") {
+        for (int block = 0; block < static_cast<int>(LATENCY) + 1; ++block) {
+            draw_block(static_cast<float>(block + 1));
+            output_param.get_value();
+        }
+        glFinish();
+        REQUIRE(output_param.is_readback_ready());
+    }
+
+    SECTION("Resetting latency to zero restores synchronous readback") {
+        REQUIRE(output_param.set_readback_latency(0));
+        draw_block(0.5f);
+
+        const float* pixels = static_cast<const float*>(output_param.get_value());
+        REQUIRE(pixels[0] == Catch::Approx(0.5f));
+    }
+
+    output_param.unbind();
+    framebuffer.unbind();
+}
+
+TEST_CASE("Half float output is read back asynchronously", "[audio_parameter][gl_test][output][readback][half_float]") {
+    const char* vert_src = R"(
+        #version 300 es
+        precision mediump float;
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        void main() {
+            gl_Position = vec4(aPos, 0.0, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    const char* frag_src = R"(
+        #version 300 es
+        precision mediump float;
+        in vec2 TexCoord;
+        uniform float block_value;
+        out vec4 color;
+        void main() {
+            color = vec4(block_value, 0.0, 0.0, 1.0);
+        }
+    )";
+
+    constexpr int WIDTH = 64;
+    constexpr int HEIGHT = 2;
+    constexpr unsigned int LATENCY = 2;
+    constexpr int NUM_BLOCKS = 6;
+
+    SDLWindow window(WIDTH, HEIGHT);
+    GLContext context;
+    AudioShaderProgram shader_prog(vert_src, frag_src);
+    REQUIRE(shader_prog.initialize());
+    GLFramebuffer framebuffer;
+
+    // A single channel stream, which a 16-bit float attachment only reads back as RGBA
+    AudioTexture2DParameter output_param("color", AudioParameter::ConnectionType::OUTPUT, WIDTH, HEIGHT);
+    REQUIRE(output_param.set_half_float(true));
+    REQUIRE(output_param.set_readback_latency(LATENCY));
+    REQUIRE(output_param.initialize(framebuffer.fbo, &shader_prog));
+
+    framebuffer.bind();
+    REQUIRE(output_param.bind());
+    shader_prog.use_program();
+    std::vector<GLenum> drawBuffers = {GL_COLOR_ATTACHMENT0 + output_param.get_color_attachment()};
+    context.set_draw_buffers(drawBuffers);
+
+    for (int block = 0; block < NUM_BLOCKS; ++block) {
+        glUniform1f(glGetUniformLocation(shader_prog.get_program(), "block_value"), 0.25f * (block + 1));
+        framebuffer.bind();
+        context.prepare_draw();
+        context.draw();
+
+        // Every sample holds the red channel of its texel, LATENCY blocks late
+        const float* samples = static_cast<const float*>(output_param.get_value());
+        float expected = block < static_cast<int>(LATENCY) ? 0.0f : 0.25f * (block + 1 - LATENCY);
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            REQUIRE(samples[i] == Catch::Approx(expected));
+        }
+    }
+
+    output_param.unbind();
+    framebuffer.unbind();
+}
+
 /**
  * @brief Comprehensive test for framebuffer attachment behavior
  * 
@@ -2025,4 +2365,109 @@ TEST_CASE("Draw buffers mapping to shader layout locations", "[audio_parameter][
     REQUIRE(debug_pixels[1] == Catch::Approx(1.0f).margin(0.01f));
 
     framebuffer.unbind();
-}
\ No newline at end of file
+}
+
+TEST_CASE("AudioUniformParameter uses cached locations and uploads only changed values", "[audio_parameter][gl_test][uniform]") {
+    constexpr int WIDTH = 64;
+    constexpr int HEIGHT = 1;
+
+    const char* vert_src = R"(
+        #version 300 es
+        precision mediump float;
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        void main() {
+            gl_Position = vec4(aPos, 0.0, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    const char* frag_src = R"(
+        #version 300 es
+        precision mediump float;
+        in vec2 TexCoord;
+        uniform float gain;
+        uniform sampler2D input_tex;
+        layout(location = 0) out vec4 output_audio_texture;
+        void main() {
+            output_audio_texture = texture(input_tex, TexCoord) * gain;
+        }
+    )";
+
+    SDLWindow window(WIDTH, HEIGHT);
+    GLContext context;
+    AudioShaderProgram shader_prog(vert_src, frag_src);
+    REQUIRE(shader_prog.initialize());
+    GLFramebuffer framebuffer;
+
+    // The location table resolves each name once and remembers misses
+    const GLint gain_location = shader_prog.get_uniform_location("gain");
+    REQUIRE(gain_location != -1);
+    REQUIRE(shader_prog.get_uniform_location("gain") == gain_location);
+    REQUIRE(shader_prog.get_uniform_location("not_a_uniform") == -1);
+    REQUIRE(shader_prog.get_uniform_location("not_a_uniform") == -1);
+
+    std::vector<float> input_data(WIDTH * HEIGHT * 4, 1.0f);
+    AudioTexture2DParameter input_param(
+        "input_tex",
+        AudioParameter::ConnectionType::INPUT,
+        WIDTH, HEIGHT,
+        1, // active_texture
+        0, // color_attachment
+        GL_NEAREST,
+        GL_FLOAT,
+        GL_RGBA,
+        GL_RGBA32F
+    );
+    AudioTexture2DParameter output_param(
+        "output_audio_texture",
+        AudioParameter::ConnectionType::OUTPUT,
+        WIDTH, HEIGHT,
+        0, // active_texture
+        0, // color_attachment
+        GL_NEAREST,
+        GL_FLOAT,
+        GL_RGBA,
+        GL_RGBA32F
+    );
+    AudioFloatParameter gain_param("gain", AudioParameter::ConnectionType::INPUT);
+    AudioFloatParameter missing_param("not_a_uniform", AudioParameter::ConnectionType::INPUT);
+
+    REQUIRE(input_param.initialize(0, &shader_prog));
+    REQUIRE(input_param.set_value(input_data.data()));
+    REQUIRE(output_param.initialize(framebuffer.fbo, &shader_prog));
+    REQUIRE(gain_param.initialize(0, &shader_prog));
+    REQUIRE(gain_param.set_value(0.5f));
+    // Parameters without a matching uniform are skipped without error
+    REQUIRE(missing_param.initialize(0, &shader_prog));
+    REQUIRE(missing_param.set_value(2.0f));
+
+    auto draw = [&]() {
+        framebuffer.bind();
+        REQUIRE(input_param.bind());
+        REQUIRE(output_param.bind());
+        context.set_draw_buffers({GL_COLOR_ATTACHMENT0 + output_param.get_color_attachment()});
+        shader_prog.use_program();
+        context.prepare_draw();
+        input_param.render();
+        output_param.render();
+        gain_param.render();
+        missing_param.render();
+        context.draw();
+        return static_cast<const float*>(output_param.get_value())[0];
+    };
+
+    REQUIRE(draw() == Catch::Approx(0.5f).margin(0.01f));
+
+    // Unchanged values are not uploaded again, so a value written behind the parameter's back survives
+    shader_prog.use_program();
+    glUniform1f(gain_location, 0.25f);
+    REQUIRE(draw() == Catch::Approx(0.25f).margin(0.01f));
+
+    // A new value is uploaded on the next render
+    REQUIRE(gain_param.set_value(0.75f));
+    REQUIRE(draw() == Catch::Approx(0.75f).margin(0.01f));
+
+    framebuffer.unbind();
+}
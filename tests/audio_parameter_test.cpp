@@ -341,6 +341,51 @@ TEST_CASE("Texture2D Parameter basic tests", "[audio_parameter]") {
             )
         );
     }
+
+    SECTION("Packed layout") {
+        AudioTexture2DParameter param("packedTexture", AudioParameter::ConnectionType::OUTPUT, 512, 2);
+        REQUIRE_FALSE(param.is_packed_layout());
+        REQUIRE(param.get_samples_per_texel() == 1);
+
+        // Four samples per texel, the same number of floats in the data
+        REQUIRE(param.set_packed_layout(true));
+        REQUIRE(param.is_packed_layout());
+        REQUIRE(param.get_width() == 512 / AudioTexture2DParameter::PACKED_SAMPLES);
+        REQUIRE(param.get_height() == 2);
+        REQUIRE(param.get_samples_per_texel() == AudioTexture2DParameter::PACKED_SAMPLES);
+
+        REQUIRE(param.set_packed_layout(false));
+        REQUIRE(param.get_width() == 512);
+
+        // Rows must split into whole texels
+        AudioTexture2DParameter odd("oddTexture", AudioParameter::ConnectionType::OUTPUT, 6, 2);
+        REQUIRE_FALSE(odd.set_packed_layout(true));
+        REQUIRE(odd.get_width() == 6);
+    }
+
+    SECTION("Half float storage") {
+        AudioTexture2DParameter param("halfTexture", AudioParameter::ConnectionType::PASSTHROUGH, 512, 2);
+        REQUIRE_FALSE(param.is_half_float());
+
+        REQUIRE(param.set_half_float(true));
+        REQUIRE(param.is_half_float());
+        REQUIRE(param.get_width() == 512);
+
+        // The packed layout keeps the storage
+        REQUIRE(param.set_packed_layout(true));
+        REQUIRE(param.is_packed_layout());
+        REQUIRE(param.is_half_float());
+
+        REQUIRE(param.set_half_float(false));
+        REQUIRE_FALSE(param.is_half_float());
+        REQUIRE(param.is_packed_layout());
+
+        // Only float samples have a 16-bit storage
+        AudioTexture2DParameter bytes("byteTexture", AudioParameter::ConnectionType::INPUT, 16, 1,
+                                      0, 0, GL_NEAREST, GL_UNSIGNED_BYTE, GL_RED, GL_R8);
+        REQUIRE_FALSE(bytes.set_half_float(true));
+        REQUIRE_FALSE(bytes.is_half_float());
+    }
 }
 
 // Extended tests that verify all functionality works in an integrated manner
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <mutex>
 #include <atomic>
+#include <cstdlib>
+#include <string>
 
 #include <SDL2/SDL.h>
 #include "audio_output/audio_player_output.h"
@@ -427,4 +429,80 @@ TEMPLATE_TEST_CASE("AudioPlayerOutput buffer management", "[audio_player_output]
             REQUIRE(player.is_ready() == false); // Should be false if not started
         }
     }
-} 
\ No newline at end of file
+}
+
+TEST_CASE("AudioPlayerOutput callback mode", "[audio_player_output][callback]") {
+    constexpr unsigned frames_per_buffer = 256;
+    constexpr unsigned sample_rate = 48000;
+    constexpr unsigned channels = 2;
+    constexpr unsigned queue_depth = 2;
+
+    SECTION("Mode and queue depth are fixed once the device is open") {
+        AudioPlayerOutput player(frames_per_buffer, sample_rate, channels);
+        REQUIRE(player.get_mode() == AudioPlayerOutput::Mode::QUEUE);
+        REQUIRE(player.set_mode(AudioPlayerOutput::Mode::CALLBACK));
+        REQUIRE_FALSE(player.set_queue_depth(0));
+        REQUIRE(player.set_queue_depth(queue_depth));
+        REQUIRE(player.get_queue_depth() == queue_depth);
+
+        // Nothing was measured yet
+        REQUIRE(player.get_xrun_count() == 0);
+        REQUIRE(player.get_output_latency() == 0.0f);
+    }
+
+    SECTION("The audio thread pulls blocks from the ring") {
+        // The dummy driver runs the audio thread without any hardware
+        const char * previous_driver = std::getenv("SDL_AUDIODRIVER");
+        const std::string saved_driver = previous_driver ? previous_driver : "";
+        setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+        AudioPlayerOutput player(frames_per_buffer, sample_rate, channels);
+        REQUIRE(player.set_mode(AudioPlayerOutput::Mode::CALLBACK));
+        REQUIRE(player.set_queue_depth(queue_depth));
+        REQUIRE(player.open());
+        REQUIRE_FALSE(player.set_queue_depth(queue_depth + 1));
+        REQUIRE(player.start());
+
+        // Keep the ring at its target depth for a while, like the renderer does
+        auto buffer = generate_sine_wave(440.0f, 0.2f, sample_rate, frames_per_buffer, channels);
+        const unsigned num_blocks = sample_rate / frames_per_buffer / 4;
+        unsigned pushed = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (pushed < num_blocks && std::chrono::steady_clock::now() < deadline) {
+            if (!player.is_ready()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+                continue;
+            }
+            player.push(buffer.data());
+            pushed++;
+            // The ring never holds more than the queue depth
+            REQUIRE(player.queued_bytes() <= queue_depth * frames_per_buffer * channels * sizeof(float));
+        }
+        REQUIRE(pushed == num_blocks);
+        REQUIRE(player.get_overrun_count() == 0);
+
+        // The latency is bounded by the queue depth plus the device buffer
+        const float block_seconds = static_cast<float>(frames_per_buffer) / sample_rate;
+        REQUIRE(player.get_output_latency() > 0.0f);
+        REQUIRE(player.get_output_latency() <= (queue_depth + 1) * block_seconds + block_seconds);
+
+        // Pushing while the ring is full drops blocks and counts overruns
+        for (unsigned i = 0; i < queue_depth + 4; ++i) {
+            player.push(buffer.data());
+        }
+        REQUIRE(player.get_overrun_count() > 0);
+        REQUIRE(player.get_xrun_count() >= player.get_overrun_count());
+
+        player.clear_queue();
+        REQUIRE(player.queued_bytes() == 0);
+
+        REQUIRE(player.stop());
+        REQUIRE(player.close());
+
+        if (previous_driver) {
+            setenv("SDL_AUDIODRIVER", saved_driver.c_str(), 1);
+        } else {
+            unsetenv("SDL_AUDIODRIVER");
+        }
+    }
+}
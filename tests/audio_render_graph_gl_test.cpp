@@ -10,6 +10,7 @@
 #include "audio_render_stage/audio_generator_render_stage.h"
 #include "audio_render_stage/audio_final_render_stage.h"
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "audio_parameter/audio_texture2d_parameter.h"
 #include "audio_render_stage/audio_multitrack_join_render_stage.h"
 #include "audio_render_stage/audio_effect_render_stage.h"
 
@@ -1939,3 +1940,525 @@ TEMPLATE_TEST_CASE("AudioRenderGraph sine generator with echo and filter effects
     delete graph;
 }
 
+
+TEST_CASE("AudioRenderGraph batched rendering requires every stage to support batching", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int BLOCKS_PER_RENDER = 4;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    SECTION("Point-wise chain is batched") {
+        auto * generator = new AudioGeneratorRenderStage(
+            BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+            "build/shaders/multinote_sine_generator_render_stage.glsl"
+        );
+        auto * gain = new AudioGainEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        REQUIRE(generator->connect_render_stage(gain));
+        REQUIRE(gain->connect_render_stage(final_stage));
+
+        auto * graph = new AudioRenderGraph(final_stage);
+        REQUIRE(graph->set_blocks_per_render(BLOCKS_PER_RENDER));
+        REQUIRE(graph->get_blocks_per_render() == BLOCKS_PER_RENDER);
+        REQUIRE(generator->get_blocks_per_render() == BLOCKS_PER_RENDER);
+
+        auto * output = dynamic_cast<AudioTexture2DParameter *>(final_stage->find_parameter("final_output_audio_texture"));
+        REQUIRE(output != nullptr);
+        REQUIRE(output->get_height() == NUM_CHANNELS * BLOCKS_PER_RENDER);
+
+        REQUIRE(graph->initialize());
+
+        // The batch size is fixed once initialized
+        REQUIRE_FALSE(graph->set_blocks_per_render(1));
+
+        auto global_time_param = new AudioIntBufferParameter("global_time", AudioParameter::ConnectionType::INPUT);
+        global_time_param->set_value(0);
+        REQUIRE(global_time_param->initialize());
+        context.prepare_draw();
+
+        graph->bind();
+        global_time_param->render();
+        graph->render(0);
+        REQUIRE(final_stage->get_output_buffer_data().size() == static_cast<size_t>(BUFFER_SIZE * NUM_CHANNELS * BLOCKS_PER_RENDER));
+        REQUIRE(final_stage->get_output_data_channel_seperated()[0].size() == static_cast<size_t>(BUFFER_SIZE * BLOCKS_PER_RENDER));
+
+        delete global_time_param;
+        delete graph;
+    }
+
+    SECTION("History dependent stage refuses batching") {
+        auto * generator = new AudioGeneratorRenderStage(
+            BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+            "build/shaders/multinote_sine_generator_render_stage.glsl"
+        );
+        auto * echo = new AudioEchoEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        REQUIRE(generator->connect_render_stage(echo));
+        REQUIRE(echo->connect_render_stage(final_stage));
+
+        auto * graph = new AudioRenderGraph(final_stage);
+        REQUIRE_FALSE(echo->supports_batching());
+        REQUIRE_FALSE(graph->set_blocks_per_render(BLOCKS_PER_RENDER));
+
+        // Nothing was changed by the failed attempt
+        REQUIRE(graph->get_blocks_per_render() == 1);
+        REQUIRE(generator->get_blocks_per_render() == 1);
+        REQUIRE(graph->set_blocks_per_render(1));
+
+        delete graph;
+    }
+}
+
+TEST_CASE("AudioRenderGraph per-stage timings", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_FRAMES = 16;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto * generator = new AudioGeneratorRenderStage(
+        BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+        "build/shaders/multinote_sine_generator_render_stage.glsl"
+    );
+    auto * echo = new AudioEchoEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(generator->connect_render_stage(echo));
+    REQUIRE(echo->connect_render_stage(final_stage));
+
+    auto * graph = new AudioRenderGraph(final_stage);
+    REQUIRE(graph->initialize());
+    context.prepare_draw();
+    generator->play_note({440.0f, 0.3f});
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        graph->bind();
+        graph->render(frame);
+    }
+
+    const auto timings = graph->get_stage_timings();
+#if AUDIO_STAGE_TIMING
+    using Phase = AudioStageTimer::Phase;
+    REQUIRE(timings.size() == 3);
+    for (const auto & [gid, stats] : timings) {
+        INFO("Stage " << gid << " draw mean " << stats[Phase::DRAW].mean << " us, gpu mean " << stats[Phase::GPU].mean << " us");
+        REQUIRE(stats.num_samples == NUM_FRAMES);
+        REQUIRE(stats[Phase::DRAW].min > 0.0f);
+        REQUIRE(stats[Phase::DRAW].min <= stats[Phase::DRAW].mean);
+        REQUIRE(stats[Phase::DRAW].mean <= stats[Phase::DRAW].p99);
+    }
+
+    // Only the final stage reads its output back every block
+    REQUIRE(timings.at(final_stage->gid)[Phase::READBACK].min > 0.0f);
+    REQUIRE(timings.at(generator->gid)[Phase::READBACK].p99 == 0.0f);
+#else
+    REQUIRE(timings.empty());
+#endif
+
+    delete graph;
+}
+
+TEST_CASE("AudioRenderGraph fuses linear point-wise runs", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_FRAMES = 4;
+
+    const std::string offset_shader = R"(
+const float OFFSET = 0.25;
+
+float add_offset(float x) {
+    return x + OFFSET;
+}
+
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    output_audio_texture = vec4(add_offset(stream_audio.r));
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    // Renders generator -> offset -> gain -> passthrough -> final and returns the last output
+    auto render_chain = [&](const bool stage_fusion_enabled, std::vector<std::vector<unsigned int>> & fused_runs) {
+        auto * generator = new AudioGeneratorRenderStage(
+            BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+            "build/shaders/multinote_sine_generator_render_stage.glsl"
+        );
+        auto * offset = new AudioRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, offset_shader, true);
+        auto * gain = new AudioGainEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * passthrough = new AudioEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        REQUIRE(generator->connect_render_stage(offset));
+        REQUIRE(offset->connect_render_stage(gain));
+        REQUIRE(gain->connect_render_stage(passthrough));
+        REQUIRE(passthrough->connect_render_stage(final_stage));
+
+        REQUIRE(offset->is_fusible());
+        REQUIRE(gain->is_fusible());
+        REQUIRE_FALSE(generator->is_fusible());
+        REQUIRE_FALSE(final_stage->is_fusible());
+
+        auto * graph = new AudioRenderGraph(final_stage);
+        graph->set_stage_fusion_enabled(stage_fusion_enabled);
+        REQUIRE(graph->initialize());
+        context.prepare_draw();
+        gain->set_channel_gains({0.5f, 0.25f});
+        generator->play_note({440.0f, 0.3f});
+
+        for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+            graph->bind();
+            graph->render(frame);
+        }
+
+        fused_runs = graph->get_fused_runs();
+        for (auto & run : fused_runs) {
+            REQUIRE(run == std::vector<unsigned int>{offset->gid, gain->gid, passthrough->gid});
+        }
+        const std::vector<float> output = final_stage->get_output_buffer_data();
+        delete graph;
+        return output;
+    };
+
+    std::vector<std::vector<unsigned int>> separate_runs;
+    std::vector<std::vector<unsigned int>> fused_runs;
+    const auto separate_output = render_chain(false, separate_runs);
+    const auto fused_output = render_chain(true, fused_runs);
+
+    REQUIRE(separate_runs.empty());
+    REQUIRE(fused_runs.size() == 1);
+    REQUIRE(fused_output.size() == separate_output.size());
+    for (size_t i = 0; i < fused_output.size(); ++i) {
+        INFO("Sample " << i);
+        REQUIRE(fused_output[i] == Catch::Approx(separate_output[i]).margin(1e-5));
+    }
+}
+
+TEST_CASE("AudioRenderGraph publishes edits as render plans adopted by bind", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+
+    auto scale_shader = [](const float factor) {
+        return std::string(R"(
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    output_audio_texture = stream_audio * )") + std::to_string(factor) + R"(;
+    debug_audio_texture = output_audio_texture;
+}
+)";
+    };
+    const std::string constant_shader = R"(
+void main() {
+    output_audio_texture = vec4(0.25) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto * generator = new AudioRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, constant_shader, true);
+    auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(generator->connect_render_stage(final_stage));
+
+    auto * graph = new AudioRenderGraph(final_stage);
+    REQUIRE(graph->initialize());
+    context.prepare_draw();
+
+    unsigned int frame = 0;
+    auto render_block = [&]() {
+        graph->bind();
+        graph->render(frame++);
+        return final_stage->get_output_buffer_data()[0];
+    };
+    REQUIRE(render_block() == Catch::Approx(0.25f));
+
+    SECTION("Edits are rendered from the next bind") {
+        auto doubler = std::make_shared<AudioRenderStage>(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, scale_shader(2.0f), true);
+        REQUIRE(graph->insert_render_stage_between(generator->gid, final_stage->gid, doubler));
+        REQUIRE(graph->get_render_order().size() == 3);
+
+        // Until a bind adopts the new plan, the previous one renders untouched
+        graph->render(frame++);
+        REQUIRE(final_stage->get_output_buffer_data()[0] == Catch::Approx(0.25f));
+        REQUIRE(render_block() == Catch::Approx(0.5f));
+
+        // The removed stage is kept alive by the active plan, then freed by the bind that retires it
+        REQUIRE(graph->remove_render_stage(doubler->gid) == doubler);
+        REQUIRE(doubler.use_count() > 1);
+        REQUIRE(render_block() == Catch::Approx(0.25f));
+        REQUIRE(doubler.use_count() == 1);
+
+        // A stage only held by a plan that a later edit superseded is freed by the render side too
+        REQUIRE(graph->insert_render_stage_between(generator->gid, final_stage->gid, doubler));
+        REQUIRE(graph->remove_render_stage(doubler->gid) == doubler);
+        REQUIRE(doubler.use_count() > 1);
+        REQUIRE(render_block() == Catch::Approx(0.25f));
+        REQUIRE(doubler.use_count() == 1);
+    }
+
+    SECTION("Edits in a scope are published together") {
+        auto tripler = std::make_shared<AudioRenderStage>(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, scale_shader(3.0f), true);
+        auto halver = std::make_shared<AudioRenderStage>(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, scale_shader(0.5f), true);
+        {
+            AudioRenderGraph::EditScope edit(*graph);
+            REQUIRE(graph->insert_render_stage_between(generator->gid, final_stage->gid, tripler));
+
+            // Only the first stage of the swap is in, so the render keeps the previous plan
+            REQUIRE(render_block() == Catch::Approx(0.25f));
+            REQUIRE(graph->insert_render_stage_between(tripler->gid, final_stage->gid, halver));
+        }
+        REQUIRE(render_block() == Catch::Approx(0.375f));
+        // The generator only samples its stream, so the whole chain before the final stage is one pass
+        REQUIRE(graph->get_fused_runs() == std::vector<std::vector<AudioRenderGraph::GID>>{{generator->gid, tripler->gid, halver->gid}});
+    }
+
+    delete graph;
+}
+
+TEST_CASE("AudioRenderGraph skips stages that only output silence", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto * generator = new AudioGeneratorRenderStage(
+        BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+        "build/shaders/multinote_sine_generator_render_stage.glsl"
+    );
+    auto * gain = new AudioGainEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(generator->connect_render_stage(gain));
+    REQUIRE(gain->connect_render_stage(final_stage));
+
+    auto * graph = new AudioRenderGraph(final_stage);
+    REQUIRE(graph->is_silence_culling_enabled());
+    REQUIRE(graph->initialize());
+    context.prepare_draw();
+
+    unsigned int frame = 0;
+    auto render_block = [&]() {
+        graph->bind();
+        graph->render(frame++);
+        float max_abs = 0.0f;
+        for (const float sample : final_stage->get_output_buffer_data()) {
+            max_abs = std::max(max_abs, std::abs(sample));
+        }
+        return max_abs;
+    };
+
+    // Without notes the generator and the gain after it are skipped, the final stage always renders
+    REQUIRE(render_block() == 0.0f);
+    REQUIRE(graph->get_silent_stages() == std::vector<AudioRenderGraph::GID>{generator->gid, gain->gid});
+
+    // The note starts in the next block, from the bottom of its attack
+    generator->play_note({440.0f, 0.3f});
+    REQUIRE(render_block() > 0.0f);
+    REQUIRE(graph->get_silent_stages().empty());
+
+    SECTION("Disabling culling renders every stage") {
+        generator->stop_note(440.0f);
+        graph->set_silence_culling_enabled(false);
+        REQUIRE_FALSE(graph->is_silence_culling_enabled());
+        for (int i = 0; i < 4; ++i) {
+            render_block();
+            REQUIRE(graph->get_silent_stages().empty());
+        }
+    }
+
+    delete graph;
+}
+
+TEST_CASE("AudioRenderGraph skips a fused run behind a silent generator", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto * generator = new AudioGeneratorRenderStage(
+        BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+        "build/shaders/multinote_sine_generator_render_stage.glsl"
+    );
+    auto * first_gain = new AudioGainEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    auto * second_gain = new AudioGainEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(generator->connect_render_stage(first_gain));
+    REQUIRE(first_gain->connect_render_stage(second_gain));
+    REQUIRE(second_gain->connect_render_stage(final_stage));
+
+    auto * graph = new AudioRenderGraph(final_stage);
+    REQUIRE(graph->initialize());
+    context.prepare_draw();
+
+    unsigned int frame = 0;
+    auto render_block = [&]() {
+        graph->bind();
+        graph->render(frame++);
+        float max_abs = 0.0f;
+        for (const float sample : final_stage->get_output_buffer_data()) {
+            max_abs = std::max(max_abs, std::abs(sample));
+        }
+        return max_abs;
+    };
+
+    // Without notes the gains are skipped with the generator, although they render as one pass
+    REQUIRE(render_block() == 0.0f);
+    const auto fused_runs = graph->get_fused_runs();
+    REQUIRE(std::any_of(fused_runs.begin(), fused_runs.end(), [&](const auto & run) {
+        return std::find(run.begin(), run.end(), first_gain->gid) != run.end() &&
+               std::find(run.begin(), run.end(), second_gain->gid) != run.end();
+    }));
+    REQUIRE(graph->get_silent_stages() == std::vector<AudioRenderGraph::GID>{generator->gid, first_gain->gid, second_gain->gid});
+
+    // The note starts in the next block and the run renders again
+    generator->play_note({440.0f, 0.3f});
+    REQUIRE(render_block() > 0.0f);
+    REQUIRE(graph->get_silent_stages().empty());
+
+    delete graph;
+}
+
+TEST_CASE("AudioRenderGraph stores the streams between stages as half floats", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_BLOCKS = 64; // Past the first echo
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto render_graph = [&](const bool half_float_streams) {
+        auto * generator = new AudioGeneratorRenderStage(
+            BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+            "build/shaders/multinote_sine_generator_render_stage.glsl"
+        );
+        auto * echo = new AudioEchoEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * join = new AudioMultitrackJoinRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, 1);
+        auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        REQUIRE(generator->connect_render_stage(echo));
+        REQUIRE(echo->connect_render_stage(join));
+        REQUIRE(join->connect_render_stage(final_stage));
+
+        auto * graph = new AudioRenderGraph(final_stage);
+        REQUIRE(graph->set_half_float_streams(half_float_streams));
+        REQUIRE(graph->initialize());
+        context.prepare_draw();
+
+        // The final mix keeps full precision
+        REQUIRE(echo->has_half_float_streams() == half_float_streams);
+        REQUIRE(join->has_half_float_streams() == half_float_streams);
+        REQUIRE_FALSE(final_stage->has_half_float_streams());
+        auto * join_stream = dynamic_cast<AudioTexture2DParameter *>(join->find_parameter("stream_audio_texture_0"));
+        auto * final_stream = dynamic_cast<AudioTexture2DParameter *>(final_stage->find_parameter("stream_audio_texture"));
+        REQUIRE(join_stream != nullptr);
+        REQUIRE(final_stream != nullptr);
+        REQUIRE(join_stream->is_half_float() == half_float_streams);
+        REQUIRE_FALSE(final_stream->is_half_float());
+
+        // The storage is fixed once the graph is initialized
+        REQUIRE_FALSE(graph->set_half_float_streams(!half_float_streams));
+
+        generator->play_note({440.0f, 0.3f});
+        std::vector<float> output;
+        for (int frame = 0; frame < NUM_BLOCKS; ++frame) {
+            graph->bind();
+            graph->render(frame);
+            const auto & block = final_stage->get_output_buffer_data();
+            output.insert(output.end(), block.begin(), block.end());
+        }
+        delete graph;
+        return output;
+    };
+
+    const auto reference = render_graph(false);
+    const auto half_float = render_graph(true);
+    REQUIRE(reference.size() == half_float.size());
+
+    // The echo records its half float output, which must read back like a full precision one
+    double signal_power = 0.0;
+    double noise_power = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        signal_power += reference[i] * reference[i];
+        noise_power += (half_float[i] - reference[i]) * (half_float[i] - reference[i]);
+    }
+    REQUIRE(signal_power > 0.0);
+    REQUIRE(noise_power <= signal_power * 1e-4); // At least 40 dB
+}
+
+TEST_CASE("AudioRenderGraph records half float streams into the GPU history", "[audio_render_graph][gl_test]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_BLOCKS = 64; // Past the first echo
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    auto render_graph = [&](const bool half_float_streams, const bool gpu_history) {
+        auto * generator = new AudioGeneratorRenderStage(
+            BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS,
+            "build/shaders/multinote_sine_generator_render_stage.glsl"
+        );
+        auto * echo = new AudioEchoEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * filter = new AudioFrequencyFilterEffectRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        auto * final_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+        REQUIRE(generator->connect_render_stage(echo));
+        REQUIRE(echo->connect_render_stage(filter));
+        REQUIRE(filter->connect_render_stage(final_stage));
+
+        // The echo records the stream of the filter and the filter its own stream
+        echo->set_gpu_history_enabled(gpu_history);
+        filter->set_gpu_history_enabled(gpu_history);
+
+        auto * graph = new AudioRenderGraph(final_stage);
+        REQUIRE(graph->set_half_float_streams(half_float_streams));
+        REQUIRE(graph->initialize());
+        context.prepare_draw();
+        REQUIRE(filter->has_half_float_streams() == half_float_streams);
+
+        generator->play_note({440.0f, 0.3f});
+        std::vector<float> output;
+        for (int frame = 0; frame < NUM_BLOCKS; ++frame) {
+            graph->bind();
+            graph->render(frame);
+            REQUIRE(glGetError() == GL_NO_ERROR);
+            const auto & block = final_stage->get_output_buffer_data();
+            output.insert(output.end(), block.begin(), block.end());
+        }
+
+        // The rings follow the precision of the streams they copy
+        if (gpu_history) {
+            for (auto * history : {echo->m_history2.get(), filter->m_history2.get()}) {
+                auto * history_texture = static_cast<AudioTexture2DParameter *>(history->m_audio_history_texture);
+                REQUIRE(history_texture->is_half_float() == half_float_streams);
+            }
+        }
+        delete graph;
+        return output;
+    };
+
+    const auto reference = render_graph(false, false);
+    const auto half_float = render_graph(true, true);
+    REQUIRE(reference.size() == half_float.size());
+
+    // Without matching precisions the copies into the rings fail and the echo goes missing
+    double signal_power = 0.0;
+    double noise_power = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        signal_power += reference[i] * reference[i];
+        noise_power += (half_float[i] - reference[i]) * (half_float[i] - reference[i]);
+    }
+    REQUIRE(signal_power > 0.0);
+    REQUIRE(noise_power <= signal_power * 1e-4); // At least 40 dB
+}
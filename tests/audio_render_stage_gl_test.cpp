@@ -8,6 +8,7 @@
 #include "audio_render_stage/audio_effect_render_stage.h"
 #include "audio_parameter/audio_texture2d_parameter.h"
 #include "audio_parameter/audio_uniform_parameter.h"
+#include "audio_parameter/audio_uniform_buffer_parameter.h"
 #include "audio_output/audio_player_output.h"
 #include "framework/test_main.h"
 #include "framework/csv_test_output.h"
@@ -707,4 +708,148 @@ void main(){
 
     generators[2]->unbind();
     passthrough.unbind();
-}
\ No newline at end of file
+}
+
+TEST_CASE("AudioRenderStage keeps parameters in render order", "[audio_render_stage][gl_test][parameters]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_CHANNELS = 2;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    AudioRenderStage render_stage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    // Add parameters of every kind out of order
+    auto * gain = new AudioFloatParameter("gain", AudioParameter::ConnectionType::INPUT);
+    auto * block_buffer = new AudioIntBufferParameter("block_buffer", AudioParameter::ConnectionType::INPUT);
+    auto * extra_texture = new AudioTexture2DParameter("extra_texture", AudioParameter::ConnectionType::INPUT,
+                                                       BUFFER_SIZE, NUM_CHANNELS, 5, 0, GL_NEAREST);
+    REQUIRE(render_stage.add_parameter(gain));
+    REQUIRE(render_stage.add_parameter(block_buffer));
+    REQUIRE(render_stage.add_parameter(extra_texture));
+
+    // Textures, then uniform buffers, then uniforms
+    auto order = [](const AudioParameter * param) {
+        if (dynamic_cast<const AudioTexture2DParameter *>(param)) return 0;
+        if (dynamic_cast<const AudioUniformBufferParameter *>(param)) return 1;
+        return 2;
+    };
+    for (size_t i = 1; i < render_stage.m_parameters.size(); ++i) {
+        REQUIRE(order(render_stage.m_parameters[i - 1].get()) <= order(render_stage.m_parameters[i].get()));
+    }
+
+    // Lookups return the stored parameter, and the pointer is a stable handle
+    REQUIRE(render_stage.find_parameter("gain") == gain);
+    REQUIRE(render_stage.find_parameter("extra_texture") == extra_texture);
+    REQUIRE(render_stage.find_parameter("stream_audio_texture") == render_stage.m_stream_audio_texture);
+    REQUIRE(render_stage.find_parameter("output_audio_texture") == render_stage.m_output_audio_texture);
+    REQUIRE(render_stage.find_parameter("missing") == nullptr);
+
+    // Adding a parameter with an existing name replaces it
+    const size_t num_parameters = render_stage.m_parameters.size();
+    const size_t num_inputs = render_stage.get_input_parameters().size();
+    auto * new_gain = new AudioFloatParameter("gain", AudioParameter::ConnectionType::INPUT);
+    REQUIRE(render_stage.add_parameter(new_gain));
+    REQUIRE(render_stage.m_parameters.size() == num_parameters);
+    REQUIRE(render_stage.get_input_parameters().size() == num_inputs);
+    REQUIRE(render_stage.find_parameter("gain") == new_gain);
+
+    REQUIRE(render_stage.remove_parameter("gain"));
+    REQUIRE(render_stage.find_parameter("gain") == nullptr);
+    REQUIRE(render_stage.m_parameters.size() == num_parameters - 1);
+}
+
+TEST_CASE("AudioRenderStage shares linked programs between identical stages", "[audio_render_stage][gl_test][shader_cache]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_CHANNELS = 2;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    static const std::string GAIN_SHADER = R"(
+uniform float stage_gain;
+
+void main() {
+    vec4 stream_audio = texture(stream_audio_texture, TexCoord);
+    output_audio_texture = vec4(stage_gain) + stream_audio;
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    AudioRenderStage stage_a(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, GAIN_SHADER, true);
+    AudioRenderStage stage_b(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, GAIN_SHADER, true);
+
+    auto * gain_a = new AudioFloatParameter("stage_gain", AudioParameter::ConnectionType::INPUT);
+    auto * gain_b = new AudioFloatParameter("stage_gain", AudioParameter::ConnectionType::INPUT);
+    REQUIRE(gain_a->set_value(0.25f));
+    REQUIRE(gain_b->set_value(0.75f));
+    REQUIRE(stage_a.add_parameter(gain_a));
+    REQUIRE(stage_b.add_parameter(gain_b));
+
+    // The second stage reuses the program linked for the first
+    const unsigned int compile_count = AudioShaderProgram::get_compile_count();
+    REQUIRE(stage_a.initialize());
+    REQUIRE(stage_b.initialize());
+    REQUIRE(AudioShaderProgram::get_compile_count() == compile_count + 1);
+    REQUIRE(stage_a.m_shader_program->get_program() == stage_b.m_shader_program->get_program());
+
+    context.prepare_draw();
+    REQUIRE(stage_a.bind());
+    REQUIRE(stage_b.bind());
+
+    // Each stage keeps its own uniform values, even though they live in the shared program
+    auto check_output = [&](AudioRenderStage & stage, const float expected) {
+        auto output_param = stage.find_parameter("output_audio_texture");
+        REQUIRE(output_param != nullptr);
+        const float * output_data = static_cast<const float *>(output_param->get_value());
+        REQUIRE(output_data != nullptr);
+        for (int i = 0; i < BUFFER_SIZE * NUM_CHANNELS; ++i) {
+            REQUIRE(output_data[i] == Catch::Approx(expected).margin(1e-5f));
+        }
+    };
+
+    for (unsigned int time = 0; time < 3; ++time) {
+        stage_a.render(time);
+        check_output(stage_a, 0.25f);
+        stage_b.render(time);
+        check_output(stage_b, 0.75f);
+    }
+}
+
+TEST_CASE("AudioRenderStage debug output follows the build", "[audio_render_stage][gl_test][debug_outputs]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int NUM_CHANNELS = 2;
+
+    SDLWindow window(BUFFER_SIZE, NUM_CHANNELS);
+    GLContext context;
+
+    AudioRenderStage generator(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, R"(
+void main() {
+    output_audio_texture = vec4(0.5) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)", true);
+    AudioFinalRenderStage final_stage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+
+    // The shaders see the same setting as the C++ code
+    const std::string define = "#define AUDIO_DEBUG_OUTPUTS " + std::to_string(AUDIO_DEBUG_OUTPUTS);
+    REQUIRE(generator.m_fragment_shader_source.find(define) != std::string::npos);
+    REQUIRE((generator.find_parameter("debug_audio_texture") != nullptr) == static_cast<bool>(AUDIO_DEBUG_OUTPUTS));
+
+    REQUIRE(generator.initialize());
+    REQUIRE(final_stage.initialize());
+    REQUIRE(generator.connect_render_stage(&final_stage));
+    context.prepare_draw();
+    REQUIRE(generator.bind());
+    REQUIRE(final_stage.bind());
+
+    // The final output keeps its layout location whether or not the debug attachment exists
+    generator.render(0);
+    final_stage.render(0);
+    for (const float sample : final_stage.get_output_buffer_data()) {
+        REQUIRE(sample == Catch::Approx(0.5f));
+    }
+}
@@ -9,6 +9,8 @@
 #include "audio_render_stage/audio_generator_render_stage.h"
 #include "audio_output/audio_player_output.h"
 #include "audio_parameter/audio_uniform_buffer_parameter.h"
+#include "audio_parameter/audio_uniform_parameter.h"
+#include "audio_core/audio_control.h"
 
 #include <iostream>
 #include <vector>
@@ -18,6 +20,7 @@
 #include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
 
 // Add after existing includes
 #include <complex>
@@ -161,4 +164,234 @@ TEST_CASE("AudioRenderer - Empty Audio Output Test",
     constexpr int BUFFER_SIZE = 256;
     constexpr int NUM_CHANNELS = 2;
     constexpr int SAMPLE_RATE = 44100;
-}
\ No newline at end of file
+}
+// Keeps every block delivered by the renderer, and always wants another one
+class BlockCollectorOutput : public AudioOutput {
+public:
+    BlockCollectorOutput(const unsigned frames_per_buffer, const unsigned sample_rate, const unsigned channels)
+        : AudioOutput(frames_per_buffer, sample_rate, channels) {}
+
+    bool is_ready() override { return true; }
+
+    void push(const float * data) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blocks.emplace_back(data, data + m_frames_per_buffer * m_channels);
+    }
+
+    bool open() override { return true; }
+    bool start() override { return true; }
+    bool stop() override { return true; }
+    bool close() override { return true; }
+
+    std::vector<std::vector<float>> get_blocks() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_blocks;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::vector<float>> m_blocks;
+};
+
+TEST_CASE("AudioRenderer - Render thread delivers blocks and control changes",
+                   "[audio_renderer][gl_test][render_thread]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+    static const std::string LEVEL_SHADER = R"(
+uniform float level;
+
+void main() {
+    output_audio_texture = vec4(level) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    // The stages are built here, the render thread initializes them in its own context
+    auto * level_stage = new AudioRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, LEVEL_SHADER, true);
+    auto * level_param = new AudioFloatParameter("level", AudioParameter::ConnectionType::INPUT);
+    REQUIRE(level_stage->add_parameter(level_param));
+    auto * final_render_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(level_stage->connect_render_stage(final_render_stage));
+
+    std::atomic<std::thread::id> setter_thread{};
+    AudioControl<float> level_control("level", 0.25f, [level_param, &setter_thread](const float& v) {
+        setter_thread = std::this_thread::get_id();
+        level_param->set_value(v);
+    });
+
+    AudioRenderer& audio_renderer = AudioRenderer::get_instance();
+    auto * output = new BlockCollectorOutput(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(audio_renderer.add_render_output(output));
+    REQUIRE(audio_renderer.add_render_graph(new AudioRenderGraph(final_render_stage)));
+    REQUIRE(audio_renderer.initialize_render_thread(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS));
+    REQUIRE(audio_renderer.is_render_thread_running());
+
+    // Waits until a delivered block is all at the level, returns the number of blocks by then
+    auto wait_for_level = [&](const float level) -> size_t {
+        const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+        while (std::chrono::steady_clock::now() < deadline) {
+            const auto blocks = output->get_blocks();
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                if (std::all_of(blocks[i].begin(), blocks[i].end(), [level](const float sample) {
+                        return sample == Catch::Approx(level).margin(1e-3f); })) {
+                    return i + 1;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return 0;
+    };
+
+    // The render thread renders on its own, without render() or present() being called here
+    const size_t blocks_before = wait_for_level(0.25f);
+    REQUIRE(blocks_before > 0);
+
+    // The setter runs on the render thread, between two blocks
+    REQUIRE(static_cast<AudioControlBase&>(level_control).set<float>(0.75f));
+    REQUIRE(level_control.get<float>() == 0.75f);
+    const size_t blocks_after = wait_for_level(0.75f);
+    REQUIRE(blocks_after > blocks_before);
+    REQUIRE(setter_thread.load() != std::this_thread::get_id());
+
+    audio_renderer.stop_render_thread();
+    REQUIRE_FALSE(audio_renderer.is_render_thread_running());
+    REQUIRE_FALSE(audio_renderer.is_initialized());
+
+    // No block is delivered once the thread is stopped
+    const size_t blocks_stopped = output->get_blocks().size();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(output->get_blocks().size() == blocks_stopped);
+}
+
+TEST_CASE("AudioRenderer - Readback latency delays the delivered blocks",
+                   "[audio_renderer][gl_test][readback]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr unsigned int LATENCY = 2;
+    constexpr int NUM_BLOCKS = 6;
+
+    // Every block holds its own number, counted from 1
+    static const std::string COUNT_SHADER = R"(
+void main() {
+    output_audio_texture = vec4(float(global_time_val + 1)) + texture(stream_audio_texture, TexCoord);
+    debug_audio_texture = output_audio_texture;
+}
+)";
+
+    // A renderer of its own, the event loop owns it and deletes it on removal
+    auto * renderer = new AudioRenderer();
+    REQUIRE(renderer->set_headless(true));
+    REQUIRE(renderer->set_readback_latency(LATENCY));
+
+    auto * count_stage = new AudioRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS, COUNT_SHADER, true);
+    auto * final_render_stage = new AudioFinalRenderStage(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(count_stage->connect_render_stage(final_render_stage));
+
+    auto * output = new BlockCollectorOutput(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(renderer->add_render_output(output));
+    REQUIRE(renderer->add_render_graph(new AudioRenderGraph(final_render_stage)));
+    REQUIRE(renderer->initialize(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS));
+    REQUIRE_FALSE(renderer->set_readback_latency(0));
+
+    // Like the render thread, render once up front, as the loop presents a block before it renders the next
+    renderer->render();
+    for (int block = 0; block < NUM_BLOCKS; ++block) {
+        renderer->present();
+        renderer->render();
+    }
+
+    // Silence until the readback is primed, then each block LATENCY renders late
+    const auto blocks = output->get_blocks();
+    REQUIRE(blocks.size() == NUM_BLOCKS);
+    for (int block = 0; block < NUM_BLOCKS; ++block) {
+        const float expected = block < static_cast<int>(LATENCY) ? 0.0f : static_cast<float>(block + 1 - LATENCY);
+        for (const float sample : blocks[block]) {
+            REQUIRE(sample == Catch::Approx(expected));
+        }
+    }
+
+    EventLoop::get_instance().remove_loop_item(renderer);
+}
+
+// Reports a set amount of queued audio, and never wants another block
+class QueuedAudioOutput : public AudioOutput {
+public:
+    QueuedAudioOutput(const unsigned frames_per_buffer, const unsigned sample_rate, const unsigned channels)
+        : AudioOutput(frames_per_buffer, sample_rate, channels) {}
+
+    bool is_ready() override { return false; }
+    void push(const float *) override {}
+    float get_queued_seconds() const override { return queued_seconds; }
+
+    bool open() override { return true; }
+    bool start() override { return true; }
+    bool stop() override { return true; }
+    bool close() override { return true; }
+
+    float queued_seconds = 0.0f;
+};
+
+TEST_CASE("AudioRenderer - Idle tasks only run when the queued audio covers them",
+                   "[audio_renderer][idle_tasks]") {
+    constexpr int BUFFER_SIZE = 256;
+    constexpr int NUM_CHANNELS = 2;
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr float BLOCK_SECONDS = float(BUFFER_SIZE) / float(SAMPLE_RATE);
+
+    // A renderer of its own, the event loop owns it and deletes it on removal
+    auto * renderer = new AudioRenderer();
+    renderer->m_buffer_size = BUFFER_SIZE;
+    renderer->m_sample_rate = SAMPLE_RATE;
+    renderer->m_num_channels = NUM_CHANNELS;
+
+    auto * output = new QueuedAudioOutput(BUFFER_SIZE, SAMPLE_RATE, NUM_CHANNELS);
+    REQUIRE(renderer->add_render_output(output));
+
+    int quick_runs = 0;
+    auto quick_task = [&quick_runs]() { quick_runs++; };
+    auto slow_task = []() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); };
+    REQUIRE(renderer->add_idle_task(quick_task, "quick"));
+
+    // Without queued audio the task would make the next block late
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 0);
+    REQUIRE(renderer->m_idle_tasks.front().deferrals == 1);
+
+    output->queued_seconds = 2.0f * BLOCK_SECONDS;
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 1);
+
+    // A slow task only holds back the tasks of its own kind
+    REQUIRE(renderer->add_idle_task(slow_task, "slow"));
+    renderer->run_idle_task();
+    REQUIRE(renderer->m_idle_task_seconds.at("slow") >= 0.02f);
+    REQUIRE(renderer->add_idle_task(quick_task, "quick"));
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 2);
+
+    REQUIRE(renderer->add_idle_task(slow_task, "slow"));
+    renderer->run_idle_task();
+    REQUIRE(renderer->m_idle_tasks.size() == 1);
+
+    // A kind that never ran is expected to be as slow as the slowest one
+    renderer->m_idle_tasks.clear();
+    REQUIRE(renderer->add_idle_task(quick_task, "new"));
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 2);
+
+    output->queued_seconds = 0.02f + 8.0f * BLOCK_SECONDS;
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 3);
+
+    // Once the slow kind runs faster its estimate decays, instead of holding the slowest run forever
+    REQUIRE(renderer->add_idle_task(quick_task, "slow"));
+    renderer->run_idle_task();
+    REQUIRE(quick_runs == 4);
+    REQUIRE(renderer->m_idle_task_seconds.at("slow") < 0.02f);
+
+    EventLoop::get_instance().remove_loop_item(renderer);
+}
@@ -0,0 +1,144 @@
+#include "catch2/catch_all.hpp"
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include "utilities/audio_ring_buffer.h"
+
+TEST_CASE("AudioRingBuffer_push_pop") {
+    AudioRingBuffer ring(10, 4);
+    REQUIRE(ring.read_available() == 0);
+    REQUIRE(ring.write_available() == 10);
+
+    // Push 10 blocks
+    for (int i = 0; i < 10; i++) {
+        std::vector<float> block(4, (float)i);
+        REQUIRE(ring.push(block.data()));
+    }
+    REQUIRE(ring.read_available() == 10);
+    REQUIRE(ring.write_available() == 0);
+
+    // Pop 10 blocks in order
+    std::vector<float> block(4);
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(ring.pop(block.data()));
+        for (float sample : block) {
+            REQUIRE(sample == (float)i);
+        }
+    }
+    REQUIRE(ring.read_available() == 0);
+    REQUIRE(ring.get_underrun_count() == 0);
+    REQUIRE(ring.get_overrun_count() == 0);
+}
+
+TEST_CASE("AudioRingBuffer_overrun_and_underrun") {
+    AudioRingBuffer ring(4, 1);
+
+    // Writing to a full ring drops the block and counts an overrun
+    for (int i = 0; i < 6; i++) {
+        const float sample = (float)i;
+        REQUIRE(ring.push(&sample) == (i < 4));
+    }
+    REQUIRE(ring.get_overrun_count() == 2);
+    REQUIRE(ring.read_available() == 4);
+
+    // The queued blocks are the oldest ones
+    float sample = -1.0f;
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(ring.pop(&sample));
+        REQUIRE(sample == (float)i);
+    }
+
+    // Reading from an empty ring counts an underrun
+    REQUIRE_FALSE(ring.pop(&sample));
+    REQUIRE(ring.acquire_read() == nullptr);
+    REQUIRE(ring.get_underrun_count() == 2);
+
+    ring.reset_counters();
+    REQUIRE(ring.get_underrun_count() == 0);
+    REQUIRE(ring.get_overrun_count() == 0);
+}
+
+TEST_CASE("AudioRingBuffer_acquire_in_place") {
+    AudioRingBuffer ring(3, 8);
+
+    // Blocks are written and read in place
+    for (int round = 0; round < 5; round++) {
+        float * write_block = ring.acquire_write();
+        REQUIRE(write_block != nullptr);
+        for (int i = 0; i < 8; i++) {
+            write_block[i] = (float)(round * 8 + i);
+        }
+
+        // Nothing is visible before the commit
+        REQUIRE(ring.read_available() == 0);
+        ring.commit();
+        REQUIRE(ring.read_available() == 1);
+
+        const float * read_block = ring.acquire_read();
+        REQUIRE(read_block == write_block);
+        for (int i = 0; i < 8; i++) {
+            REQUIRE(read_block[i] == (float)(round * 8 + i));
+        }
+        ring.release();
+    }
+    REQUIRE(ring.read_available() == 0);
+}
+
+TEST_CASE("AudioRingBuffer_clear") {
+    AudioRingBuffer ring(4, 2);
+    std::vector<float> block(2, 1.0f);
+    REQUIRE(ring.push(block.data()));
+    REQUIRE(ring.push(block.data()));
+
+    ring.clear();
+    REQUIRE(ring.read_available() == 0);
+    REQUIRE(ring.write_available() == 4);
+}
+
+TEST_CASE("AudioRingBuffer_invalid_size") {
+    REQUIRE_THROWS_AS(AudioRingBuffer(0, 16), std::invalid_argument);
+    REQUIRE_THROWS_AS(AudioRingBuffer(16, 0), std::invalid_argument);
+}
+
+TEST_CASE("AudioRingBuffer_push_pop_threaded") {
+    constexpr int NUM_BLOCKS = 20000;
+    constexpr unsigned int BLOCK_SIZE = 64;
+    AudioRingBuffer ring(8, BLOCK_SIZE);
+
+    // The producer retries when the ring is full, so every block arrives
+    std::thread producer([&ring]() {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            float * block = nullptr;
+            while ((block = ring.acquire_write()) == nullptr) {
+                std::this_thread::yield();
+            }
+            for (unsigned int j = 0; j < BLOCK_SIZE; j++) {
+                block[j] = (float)i;
+            }
+            ring.commit();
+        }
+    });
+
+    int mismatches = 0;
+    std::thread consumer([&ring, &mismatches]() {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            const float * block = nullptr;
+            while ((block = ring.acquire_read()) == nullptr) {
+                std::this_thread::yield();
+            }
+            for (unsigned int j = 0; j < BLOCK_SIZE; j++) {
+                if (block[j] != (float)i) {
+                    mismatches++;
+                }
+            }
+            ring.release();
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(ring.read_available() == 0);
+}
@@ -0,0 +1,58 @@
+#include "catch2/catch_all.hpp"
+#include <chrono>
+
+#include "utilities/audio_stage_timer.h"
+
+#if AUDIO_STAGE_TIMING
+
+using Phase = AudioStageTimer::Phase;
+
+TEST_CASE("AudioStageTimer_stats") {
+    AudioStageTimer timer;
+    REQUIRE(timer.get_stats().num_samples == 0);
+
+    // Blocks of 1..100 us of draw time and a constant 2 us of upload time
+    for (int i = 1; i <= 100; i++) {
+        timer.begin_block();
+        timer.add(Phase::UPLOAD, std::chrono::microseconds(2));
+        timer.add(Phase::DRAW, std::chrono::microseconds(i));
+        timer.end_block();
+    }
+    REQUIRE(timer.get_block_count() == 100);
+
+    const auto stats = timer.get_stats();
+    REQUIRE(stats.num_samples == 100);
+    REQUIRE(stats[Phase::UPLOAD].min == Catch::Approx(2.0f));
+    REQUIRE(stats[Phase::UPLOAD].mean == Catch::Approx(2.0f));
+    REQUIRE(stats[Phase::DRAW].min == Catch::Approx(1.0f));
+    REQUIRE(stats[Phase::DRAW].mean == Catch::Approx(50.5f));
+    REQUIRE(stats[Phase::DRAW].p99 == Catch::Approx(100.0f));
+    REQUIRE(stats[Phase::READBACK].mean == 0.0f);
+    REQUIRE(stats.cpu_total.mean == Catch::Approx(52.5f));
+}
+
+TEST_CASE("AudioStageTimer_scope_and_ring") {
+    AudioStageTimer timer;
+
+    // Time added in a block is summed over the scopes of a phase
+    timer.begin_block();
+    {
+        AudioStageTimer::Scope scope(timer, Phase::READBACK);
+    }
+    timer.add(Phase::READBACK, std::chrono::microseconds(5));
+    timer.end_block();
+    REQUIRE(timer.get_stats()[Phase::READBACK].min >= 5.0f);
+
+    // Only the most recent blocks are kept
+    for (std::size_t i = 0; i < AudioStageTimer::RING_SIZE; i++) {
+        timer.begin_block();
+        timer.add(Phase::RECORD, std::chrono::microseconds(7));
+        timer.end_block();
+    }
+    const auto stats = timer.get_stats();
+    REQUIRE(stats.num_samples == AudioStageTimer::RING_SIZE);
+    REQUIRE(stats[Phase::READBACK].p99 == 0.0f);
+    REQUIRE(stats[Phase::RECORD].min == Catch::Approx(7.0f));
+}
+
+#endif
@@ -417,3 +417,80 @@ TEST_CASE("AudioTape clear and record - fixed size tape position increments", "[
     REQUIRE(tape.m_data[1][2 * frames_per_buffer] == Catch::Approx(0.f));
 }
 
+
+TEST_CASE("AudioTape modified ranges - fixed size tape logs writes and dropped samples", "[audio_tape][modified_ranges]") {
+    const unsigned int frames_per_buffer = 4;
+    const unsigned int sample_rate = 44100;
+    const unsigned int num_channels = 2;
+    const unsigned int capacity = 8;
+
+    AudioTape tape(frames_per_buffer, sample_rate, num_channels, capacity);
+    std::vector<float> frame(frames_per_buffer * num_channels, 1.f);
+    std::vector<std::pair<unsigned int, unsigned int>> ranges;
+
+    const unsigned long start_revision = tape.get_revision();
+
+    tape.record(frame.data(), 0u);
+    tape.record(frame.data(), 4u);
+    REQUIRE(tape.get_modified_ranges_since(start_revision, ranges));
+    REQUIRE(ranges.size() == 2);
+    REQUIRE(ranges[0] == std::make_pair(0u, 4u));
+    REQUIRE(ranges[1] == std::make_pair(4u, 8u));
+
+    // Recording past the capacity drops the oldest samples out of the window
+    const unsigned long revision = tape.get_revision();
+    ranges.clear();
+    tape.record(frame.data(), 8u);
+    REQUIRE(tape.get_modified_ranges_since(revision, ranges));
+    REQUIRE(ranges.size() == 2);
+    REQUIRE(ranges[0] == std::make_pair(0u, 4u));
+    REQUIRE(ranges[1] == std::make_pair(8u, 12u));
+
+    // Nothing changed since the latest revision
+    ranges.clear();
+    REQUIRE(tape.get_modified_ranges_since(tape.get_revision(), ranges));
+    REQUIRE(ranges.empty());
+
+    // Clearing the tape can not be described by ranges
+    tape.clear();
+    REQUIRE_FALSE(tape.get_modified_ranges_since(revision, ranges));
+}
+
+TEST_CASE("AudioTape modified ranges - log too short requires a full refresh", "[audio_tape][modified_ranges]") {
+    const unsigned int frames_per_buffer = 4;
+    AudioTape tape(frames_per_buffer, 44100, 1);
+    std::vector<float> frame(frames_per_buffer, 1.f);
+    std::vector<std::pair<unsigned int, unsigned int>> ranges;
+
+    const unsigned long start_revision = tape.get_revision();
+    for (unsigned int i = 0; i <= AudioTape::MODIFIED_RANGE_LOG_SIZE; ++i) {
+        tape.record(frame.data());
+    }
+    REQUIRE_FALSE(tape.get_modified_ranges_since(start_revision, ranges));
+}
+
+TEST_CASE("AudioTape playback range - zeros outside recorded data", "[audio_tape][playback]") {
+    const unsigned int frames_per_buffer = 4;
+    const unsigned int capacity = 8;
+    AudioTape tape(frames_per_buffer, 44100, 1, capacity);
+
+    std::vector<float> frame1 = {1.f, 2.f, 3.f, 4.f};
+    std::vector<float> frame2 = {5.f, 6.f, 7.f, 8.f};
+    std::vector<float> frame3 = {9.f, 10.f, 11.f, 12.f};
+    tape.record(frame1.data(), 0u);
+    tape.record(frame2.data(), 4u);
+    tape.record(frame3.data(), 8u); // Window is now [4, 12)
+
+    std::vector<float> out(8, -1.f);
+    tape.playback_range_for_render_stage_history(0, 2, 8, out.data());
+    std::vector<float> expected = {0.f, 0.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(out[i] == Catch::Approx(expected[i]));
+    }
+
+    // Invalid channel returns zeros
+    tape.playback_range_for_render_stage_history(1, 4, 4, out.data());
+    for (size_t i = 0; i < 4; ++i) {
+        REQUIRE(out[i] == Catch::Approx(0.f));
+    }
+}
@@ -0,0 +1,75 @@
+#include "catch2/catch_all.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "utilities/audio_tracer.h"
+
+static std::string read_file(const std::string & path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("AudioTracer_disabled") {
+    REQUIRE_FALSE(AudioTracer::is_enabled());
+
+    // Nothing is recorded while stopped, and stopping twice is harmless
+    {
+        AUDIO_TRACE_SCOPE("untraced", "test");
+    }
+    AudioTracer::instant("untraced", "test");
+    AudioTracer::stop();
+    REQUIRE_FALSE(AudioTracer::is_enabled());
+}
+
+TEST_CASE("AudioTracer_writes_chrome_trace") {
+    const std::string path = "build/tests/audio_tracer_test.json";
+    std::filesystem::create_directories("build/tests");
+
+    REQUIRE(AudioTracer::start(path));
+    REQUIRE(AudioTracer::is_enabled());
+    REQUIRE_FALSE(AudioTracer::start(path));
+
+    AudioTracer::set_thread_name("test \"main\"");
+    AudioTracer::set_block(7);
+    {
+        AUDIO_TRACE_SCOPE("main_scope", "test");
+    }
+
+    std::thread worker([]() {
+        AudioTracer::set_thread_name("worker");
+        AudioTracer::set_block(8);
+        const std::string name = "worker_scope";
+        AUDIO_TRACE_SCOPE(name, "test");
+        AudioTracer::instant("worker_instant", "control");
+    });
+    worker.join();
+
+    AudioTracer::stop();
+    REQUIRE_FALSE(AudioTracer::is_enabled());
+    REQUIRE(AudioTracer::get_dropped_count() == 0);
+
+    const std::string trace = read_file(path);
+    REQUIRE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+    REQUIRE(trace.find("]}") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"main_scope\",\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(trace.find("\"args\":{\"block\":7}") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"worker_scope\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"worker_instant\",\"cat\":\"control\",\"ph\":\"i\"") != std::string::npos);
+    REQUIRE(trace.find("\"args\":{\"block\":8}") != std::string::npos);
+
+    // Thread names are escaped metadata events
+    REQUIRE(trace.find("\"args\":{\"name\":\"test \\\"main\\\"\"}") != std::string::npos);
+    REQUIRE(trace.find("\"args\":{\"name\":\"worker\"}") != std::string::npos);
+
+    // A new trace does not repeat the events of the previous one
+    REQUIRE(AudioTracer::start(path));
+    AudioTracer::stop();
+    REQUIRE(read_file(path).find("main_scope") == std::string::npos);
+
+    std::filesystem::remove(path);
+}
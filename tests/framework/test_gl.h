@@ -4,7 +4,10 @@
 #include <EGL/egl.h>
 #include <iostream>
 #include <vector>
+#include <cstdlib>
+#include <string>
 #include "utilities/shader_program.h"
+#include "utilities/egl_compatibility.h"
 #include "catch2/catch_all.hpp"
 
 
@@ -15,6 +18,7 @@ struct SDLWindow {
     SDL_GLContext glctx = nullptr;
     int width, height;
     bool visible;
+    bool headless = false;
     
     // EGL objects
     EGLDisplay eglDisplay = EGL_NO_DISPLAY;
@@ -22,9 +26,20 @@ struct SDLWindow {
     EGLContext eglContext = EGL_NO_CONTEXT;
     EGLConfig eglConfig = nullptr;
 
-    // Constructor for hidden window (default, for offscreen rendering)
+    // Constructor for offscreen rendering (default). Uses a headless pbuffer/surfaceless
+    // context, so no window system is needed, unless TEST_GL_HIDDEN_WINDOW asks for a hidden window.
     SDLWindow(int w, int h)
-        : width(w), height(h), visible(false) {
+        : width(w), height(h), visible(false), headless(!use_hidden_window()) {
+        if (headless) {
+            if (!EGLCompatibility::initialize_headless_context(eglContext)) {
+                std::cerr << "Failed to create headless context" << std::endl;
+            }
+            // Draws to the default framebuffer get the window sized viewport the tests expect,
+            // not the size of the 1x1 pbuffer (or 0x0 without a surface)
+            glViewport(0, 0, w, h);
+            return;
+        }
+
         window = SDL_CreateWindow(
             "Offscreen",
             SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
@@ -55,6 +70,10 @@ struct SDLWindow {
     }
 
     ~SDLWindow() {
+        if (headless) {
+            EGLCompatibility::cleanup_headless_context(eglContext);
+            return;
+        }
         cleanup_egl();
         if (window) {
             SDL_DestroyWindow(window);
@@ -74,6 +93,12 @@ struct SDLWindow {
     }
 
 private:
+    // Set TEST_GL_HIDDEN_WINDOW=1 to run the offscreen fixtures in a hidden SDL window as before
+    static bool use_hidden_window() {
+        const char* env = std::getenv("TEST_GL_HIDDEN_WINDOW");
+        return env && (std::string(env) == "1" || std::string(env) == "true");
+    }
+
     bool initialize_egl() {
         // Get EGL display
         eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
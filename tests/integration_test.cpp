@@ -105,11 +105,22 @@ TEST_CASE("Integration Tests - Effect Switching", "[integration][gl_test]") {
         REQUIRE(track->m_current_effect->name() == "none");
         REQUIRE(track->m_current_voice->name() == "sine");
 
-        // Verify all effect modules were created
+        // Only the default modules are created up front
+        REQUIRE(track->m_effect_modules.size() == 1);
+        REQUIRE(track->m_voice_modules.size() == 1);
         REQUIRE(track->m_effect_modules.find("none") != track->m_effect_modules.end());
-        REQUIRE(track->m_effect_modules.find("gain") != track->m_effect_modules.end());
+        REQUIRE(track->m_voice_modules.find("sine") != track->m_voice_modules.end());
+        REQUIRE(track->get_effect_names().size() == 4);
+        REQUIRE(track->get_generator_names().size() == 5);
+
+        // Other modules are created on first selection and reused afterwards
+        REQUIRE_NOTHROW(track->change_effect("echo"));
         REQUIRE(track->m_effect_modules.find("echo") != track->m_effect_modules.end());
-        REQUIRE(track->m_effect_modules.find("frequency_filter") != track->m_effect_modules.end());
+        auto echo_module = track->m_effect_modules["echo"];
+        REQUIRE_NOTHROW(track->change_effect("none"));
+        REQUIRE_NOTHROW(track->change_effect("echo"));
+        REQUIRE(track->m_effect_modules["echo"] == echo_module);
+        REQUIRE(track->m_effect_modules.find("gain") == track->m_effect_modules.end());
 
         delete track;
     }
@@ -0,0 +1,64 @@
+#include "catch2/catch_all.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utilities/shader_registry.h"
+
+TEST_CASE("ShaderRegistry_embedded_shaders") {
+    REQUIRE(ShaderRegistry::get_embedded_count() > 0);
+    REQUIRE(ShaderRegistry::is_embedded("build/shaders/global_settings.glsl"));
+
+    // Bundled shaders are served without reading the disk
+    const unsigned int disk_reads = ShaderRegistry::get_disk_read_count();
+    const std::string source = ShaderRegistry::get_source("build/shaders/global_settings.glsl");
+    REQUIRE(source.find("#version") != std::string::npos);
+    REQUIRE(ShaderRegistry::get_disk_read_count() == disk_reads);
+}
+
+TEST_CASE("ShaderRegistry_disk_shaders") {
+    const std::string path = "build/tests/shader_registry_test.glsl";
+    std::filesystem::create_directories("build/tests");
+    REQUIRE_FALSE(ShaderRegistry::is_embedded(path));
+
+    // Files outside the bundle are read every time, so rewrites are picked up
+    for (const std::string contents : {"float first;\n", "float second;\n"}) {
+        std::ofstream(path, std::ios::trunc) << contents;
+        const unsigned int disk_reads = ShaderRegistry::get_disk_read_count();
+        REQUIRE(ShaderRegistry::get_source(path) == contents);
+        REQUIRE(ShaderRegistry::get_disk_read_count() == disk_reads + 1);
+    }
+    std::filesystem::remove(path);
+
+    REQUIRE(ShaderRegistry::get_source("build/tests/missing_shader.glsl").empty());
+}
+
+TEST_CASE("ShaderRegistry_combine_keeps_first_version") {
+    std::string combined = "";
+    bool version_added = false;
+
+    ShaderRegistry::append_source(combined, version_added, "#version 300 es\nfloat a;\n");
+    REQUIRE(version_added);
+    ShaderRegistry::append_source(combined, version_added, "#version 300 es\nfloat b;\n");
+    ShaderRegistry::append_source(combined, version_added, "float c;\n");
+
+    // The build settings are defined right after the kept #version line
+    const std::string defines = "#define AUDIO_DEBUG_OUTPUTS " + std::to_string(AUDIO_DEBUG_OUTPUTS) + "\n";
+    REQUIRE(combined == "#version 300 es\n" + defines + "float a;\nfloat b;\nfloat c;\n");
+
+    const std::vector<std::string> imports = {
+        "build/shaders/global_settings.glsl",
+        "build/shaders/frag_shader_settings.glsl"
+    };
+    const unsigned int disk_reads = ShaderRegistry::get_disk_read_count();
+    bool first_version = false;
+    bool second_version = false;
+    const std::string first = ShaderRegistry::combine_imports(imports, first_version);
+    const std::string second = ShaderRegistry::combine_imports(imports, second_version);
+    REQUIRE(first_version);
+    REQUIRE(second_version);
+    REQUIRE(first == second);
+    REQUIRE(first.find("#version") == first.rfind("#version"));
+    REQUIRE(ShaderRegistry::get_disk_read_count() == disk_reads);
+}